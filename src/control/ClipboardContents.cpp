@@ -0,0 +1,251 @@
+#include "ClipboardContents.h"
+
+#include "view/DocumentView.h"
+
+#include <cairo-svg.h>
+#include <pixbuf-utils.h>
+
+static GdkAtom atomXournal = gdk_atom_intern_static_string("application/xournal");
+static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
+static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
+
+ClipboardContents::ClipboardContents(GString* xournal, string text, vector<Element*> elements,
+                                     double x, double y, double width, double height)
+ : xournal(xournal),
+   text(text),
+   elements(elements),
+   x(x),
+   y(y),
+   width(width),
+   height(height)
+{
+	XOJ_INIT_TYPE(ClipboardContents);
+
+	g_mutex_init(&this->renderLock);
+	g_cond_init(&this->renderCond);
+}
+
+ClipboardContents::~ClipboardContents()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	for (Element* e : this->elements)
+	{
+		delete e;
+	}
+	this->elements.clear();
+
+	if (this->image)
+	{
+		g_object_unref(this->image);
+		this->image = NULL;
+	}
+	if (this->svg)
+	{
+		g_string_free(this->svg, true);
+		this->svg = NULL;
+	}
+	g_string_free(this->xournal, true);
+	this->xournal = NULL;
+
+	g_cond_clear(&this->renderCond);
+	g_mutex_clear(&this->renderLock);
+
+	XOJ_RELEASE_TYPE(ClipboardContents);
+}
+
+void ClipboardContents::ref()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	g_atomic_int_inc(&this->refCount);
+}
+
+void ClipboardContents::unref()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	if (g_atomic_int_dec_and_test(&this->refCount))
+	{
+		delete this;
+	}
+}
+
+bool ClipboardContents::isSameSelection(GString* data)
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	return g_string_equal(this->xournal, data);
+}
+
+string ClipboardContents::getText()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	return this->text;
+}
+
+bool ClipboardContents::isCleared()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	return this->cleared;
+}
+
+void ClipboardContents::setCleared(bool cleared)
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	this->cleared = cleared;
+}
+
+vector<Element*>* ClipboardContents::getElements()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	return &this->elements;
+}
+
+void ClipboardContents::startRendering()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	if (this->renderStarted)
+	{
+		return;
+	}
+	this->renderStarted = true;
+
+	// The render thread keeps the contents alive
+	ref();
+	g_thread_unref(g_thread_new("ClipboardRender", (GThreadFunc) renderThread, this));
+}
+
+void ClipboardContents::waitForRender(ClipboardRenderTarget target)
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	startRendering();
+
+	g_mutex_lock(&this->renderLock);
+	while (!this->rendered[target])
+	{
+		g_cond_wait(&this->renderCond, &this->renderLock);
+	}
+	g_mutex_unlock(&this->renderLock);
+}
+
+void ClipboardContents::renderFinished(ClipboardRenderTarget target)
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	g_mutex_lock(&this->renderLock);
+	this->rendered[target] = true;
+	g_cond_broadcast(&this->renderCond);
+	g_mutex_unlock(&this->renderLock);
+}
+
+gpointer ClipboardContents::renderThread(ClipboardContents* contents)
+{
+	XOJ_CHECK_TYPE_OBJ(contents, ClipboardContents);
+
+	// PNG first, it is the target most applications paste
+	contents->renderPng();
+	contents->renderFinished(CLIPBOARD_RENDER_PNG);
+
+	contents->renderSvg();
+	contents->renderFinished(CLIPBOARD_RENDER_SVG);
+
+	contents->unref();
+
+	return NULL;
+}
+
+void ClipboardContents::renderPng()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	DocumentView view;
+
+	double dpiFactor = 1.0 / 72.0 * 300.0;
+
+	int width = this->width * dpiFactor;
+	int height = this->height * dpiFactor;
+	cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+	cairo_t* crPng = cairo_create(surfacePng);
+	cairo_scale(crPng, dpiFactor, dpiFactor);
+
+	cairo_translate(crPng, -this->x, -this->y);
+	view.drawSelection(crPng, this);
+
+	cairo_destroy(crPng);
+
+	this->image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
+
+	cairo_surface_destroy(surfacePng);
+}
+
+static cairo_status_t svgWriteFunction(GString* string, const unsigned char* data, unsigned int length)
+{
+	g_string_append_len(string, (const gchar*) data, length);
+	return CAIRO_STATUS_SUCCESS;
+}
+
+void ClipboardContents::renderSvg()
+{
+	XOJ_CHECK_TYPE(ClipboardContents);
+
+	DocumentView view;
+
+	GString* svgString = g_string_sized_new(1048576); // 1MB
+
+	cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+									(cairo_write_func_t) svgWriteFunction, svgString,
+									this->width, this->height
+									);
+	cairo_t* crSVG = cairo_create(surfaceSVG);
+
+	view.drawSelection(crSVG, this);
+
+	cairo_surface_destroy(surfaceSVG);
+	cairo_destroy(crSVG);
+
+	this->svg = svgString;
+}
+
+void ClipboardContents::getFunction(GtkClipboard* clipboard, GtkSelectionData* selection,
+                                    guint info, ClipboardContents* contents)
+{
+	XOJ_CHECK_TYPE_OBJ(contents, ClipboardContents);
+
+	GdkAtom target = gtk_selection_data_get_target(selection);
+
+	if (target == gdk_atom_intern_static_string("UTF8_STRING"))
+	{
+		gtk_selection_data_set_text(selection, contents->text.c_str(), -1);
+	}
+	else if (target == gdk_atom_intern_static_string("image/png") ||
+			 target == gdk_atom_intern_static_string("image/jpeg") ||
+			 target == gdk_atom_intern_static_string("image/gif"))
+	{
+		contents->waitForRender(CLIPBOARD_RENDER_PNG);
+		gtk_selection_data_set_pixbuf(selection, contents->image);
+	}
+	else if (atomSvg1 == target || atomSvg2 == target)
+	{
+		contents->waitForRender(CLIPBOARD_RENDER_SVG);
+		gtk_selection_data_set(selection, target, 8, (guchar*) contents->svg->str, contents->svg->len);
+	}
+	else if (atomXournal == target)
+	{
+		gtk_selection_data_set(selection, target, 8, (guchar*) contents->xournal->str, contents->xournal->len);
+	}
+}
+
+void ClipboardContents::clearFunction(GtkClipboard* clipboard, ClipboardContents* contents)
+{
+	XOJ_CHECK_TYPE_OBJ(contents, ClipboardContents);
+
+	contents->cleared = true;
+	contents->unref();
+}
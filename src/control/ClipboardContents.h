@@ -0,0 +1,109 @@
+/*
+ * Xournal++
+ *
+ * The contents of the clipboard after a copy. The image targets are
+ * rendered on a background thread, so copying does not block, and kept.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "view/ElementContainer.h"
+
+#include <XournalType.h>
+
+#include <gtk/gtk.h>
+
+#include <vector>
+using std::vector;
+
+enum ClipboardRenderTarget
+{
+	CLIPBOARD_RENDER_PNG = 0,
+	CLIPBOARD_RENDER_SVG,
+
+	CLIPBOARD_RENDER_COUNT
+};
+
+class ClipboardContents : public ElementContainer
+{
+public:
+	/**
+	 * @param xournal Serialized selection, owned by this object
+	 * @param elements Copies of the selected elements, owned by this object
+	 */
+	ClipboardContents(GString* xournal, string text, vector<Element*> elements,
+	                  double x, double y, double width, double height);
+
+private:
+	virtual ~ClipboardContents();
+
+public:
+	void ref();
+	void unref();
+
+	/**
+	 * @return true if the serialized selection is the same as data, so
+	 * the rendered images can be reused
+	 */
+	bool isSameSelection(GString* data);
+
+	string getText();
+
+	/**
+	 * @return true if the clipboard was cleared or taken by another application
+	 */
+	bool isCleared();
+	void setCleared(bool cleared);
+
+	virtual vector<Element*>* getElements();
+
+	/**
+	 * Start rendering the image targets on a background thread
+	 */
+	void startRendering();
+
+	static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection,
+	                        guint info, ClipboardContents* contents);
+	static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents);
+
+private:
+	/**
+	 * Block until the target is rendered, only happens if it is requested
+	 * right after the copy
+	 */
+	void waitForRender(ClipboardRenderTarget target);
+
+	static gpointer renderThread(ClipboardContents* contents);
+	void renderPng();
+	void renderSvg();
+	void renderFinished(ClipboardRenderTarget target);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	gint refCount = 1;
+
+	GString* xournal;
+	string text;
+	vector<Element*> elements;
+
+	double x;
+	double y;
+	double width;
+	double height;
+
+	bool cleared = false;
+
+	GMutex renderLock;
+	GCond renderCond;
+	bool renderStarted = false;
+	bool rendered[CLIPBOARD_RENDER_COUNT] = { false };
+
+	GdkPixbuf* image = NULL;
+	GString* svg = NULL;
+};
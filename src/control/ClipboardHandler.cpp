@@ -1,16 +1,14 @@
 #include "ClipboardHandler.h"
 
+#include "ClipboardContents.h"
 #include "Control.h"
-#include "view/DocumentView.h"
+#include "model/Text.h"
 
 #include <config.h>
 #include <serializing/ObjectOutputStream.h>
 #include <serializing/ObjectInputStream.h>
 #include <serializing/BinObjectEncoding.h>
 
-#include <cairo-svg.h>
-#include <pixbuf-utils.h>
-
 ClipboardListener::~ClipboardListener() {
 }
 
@@ -35,6 +33,12 @@ ClipboardHandler::~ClipboardHandler()
 
 	g_signal_handler_disconnect(this->clipboard, this->hanlderId);
 
+	if (this->contents)
+	{
+		this->contents->unref();
+		this->contents = NULL;
+	}
+
 	XOJ_RELEASE_TYPE(ClipboardHandler);
 }
 
@@ -88,70 +92,6 @@ gint ElementCompareFunc(Element* a, Element* b)
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents
-{
-public:
-	ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str)
-	{
-		this->text = text;
-		this->image = image;
-		this->svg = svg;
-		this->str = str;
-	}
-
-	~ClipboardContents()
-	{
-		g_object_unref(this->image);
-		g_string_free(this->str, true);
-	}
-
-public:
-
-	static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection,
-							guint info, ClipboardContents* contents)
-	{
-		GdkAtom target = gtk_selection_data_get_target(selection);
-
-		if (target == gdk_atom_intern_static_string("UTF8_STRING"))
-		{
-			gtk_selection_data_set_text(selection, contents->text.c_str(), -1);
-		}
-		else if (target == gdk_atom_intern_static_string("image/png") ||
-				 target == gdk_atom_intern_static_string("image/jpeg") ||
-				 target == gdk_atom_intern_static_string("image/gif"))
-		{
-			gtk_selection_data_set_pixbuf(selection, contents->image);
-		}
-		else if (atomSvg1 == target || atomSvg2 == target)
-		{
-			gtk_selection_data_set(selection, target, 8, (guchar*) contents->svg.c_str(),
-								   contents->svg.length());
-		}
-		else if (atomXournal == target)
-		{
-			gtk_selection_data_set(selection, target, 8, (guchar*) contents->str->str, contents->str->len);
-		}
-	}
-
-	static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents)
-	{
-		delete contents;
-	}
-
-private:
-	string text;
-	GdkPixbuf* image;
-	string svg;
-	GString* str;
-};
-
-static cairo_status_t svgWriteFunction(GString* string, const unsigned char* data, unsigned int length)
-{
-	g_string_append_len(string, (const gchar*) data, length);
-	return CAIRO_STATUS_SUCCESS;
-}
-
 bool ClipboardHandler::copy()
 {
 	XOJ_CHECK_TYPE(ClipboardHandler);
@@ -165,12 +105,32 @@ bool ClipboardHandler::copy()
 	// prepare xournal contents
 	/////////////////////////////////////////////////////////////////
 
+	// This is also the snapshot of the selection, it may be deleted
+	// directly after copying (cut)
 	ObjectOutputStream out(new BinObjectEncoding());
 
 	out.writeString(PROJECT_STRING);
 
 	this->selection->serialize(out);
 
+	GString* xournal = out.getStr();
+
+	if (this->contents && this->contents->isSameSelection(xournal))
+	{
+		g_string_free(xournal, true);
+
+		if (!this->contents->isCleared())
+		{
+			// Still on the clipboard, the rendered images are kept
+			return true;
+		}
+
+		this->contents->setCleared(false);
+		this->contents->ref();
+		setClipboardContents(this->contents);
+		return true;
+	}
+
 	/////////////////////////////////////////////////////////////////
 	// prepare text contents
 	/////////////////////////////////////////////////////////////////
@@ -198,55 +158,44 @@ bool ClipboardHandler::copy()
 	g_list_free(textElements);
 
 	/////////////////////////////////////////////////////////////////
-	// prepare image contents: PNG
+	// the images are rendered in the background, from copies of the elements
 	/////////////////////////////////////////////////////////////////
 
-	DocumentView view;
-
-	double dpiFactor = 1.0 / 72.0 * 300.0;
-
-	int width = selection->getWidth() * dpiFactor;
-	int height = selection->getHeight() * dpiFactor;
-	cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-	cairo_t* crPng = cairo_create(surfacePng);
-	cairo_scale(crPng, dpiFactor, dpiFactor);
-
-	cairo_translate(crPng, -selection->getXOnView(), -selection->getYOnView());
-	view.drawSelection(crPng, this->selection);
-
-	cairo_destroy(crPng);
-
-	GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-	cairo_surface_destroy(surfacePng);
-
-	/////////////////////////////////////////////////////////////////
-	// prepare image contents: SVG
-	/////////////////////////////////////////////////////////////////
+	vector<Element*> elements;
+	for (Element* e : *this->selection->getElements())
+	{
+		elements.push_back(e->clone());
+	}
 
-	GString* svgString = g_string_sized_new(1048576); // 1MB
+	if (this->contents)
+	{
+		this->contents->unref();
+	}
 
-	cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
-									(cairo_write_func_t) svgWriteFunction, svgString,
-									selection->getWidth(), selection->getHeight()
-									);
-	cairo_t* crSVG = cairo_create(surfaceSVG);
+	this->contents = new ClipboardContents(xournal, text, elements, selection->getXOnView(), selection->getYOnView(),
+	                                       selection->getWidth(), selection->getHeight());
+	this->contents->startRendering();
 
-	view.drawSelection(crSVG, this->selection);
+	// One reference for the handler, one for the clipboard
+	this->contents->ref();
+	setClipboardContents(this->contents);
 
-	cairo_surface_destroy(surfaceSVG);
-	cairo_destroy(crSVG);
+	return true;
+}
 
-	/////////////////////////////////////////////////////////////////
-	// copy to clipboard
-	/////////////////////////////////////////////////////////////////
+/**
+ * Put the contents on the clipboard, the clipboard takes over one reference
+ */
+void ClipboardHandler::setClipboardContents(ClipboardContents* contents)
+{
+	XOJ_CHECK_TYPE(ClipboardHandler);
 
 	GtkTargetList* list = gtk_target_list_new(NULL, 0);
 	GtkTargetEntry* targets;
 	int n_targets;
 
 	// if we have text elements...
-	if (!text.empty())
+	if (!contents->getText().empty())
 	{
 		gtk_target_list_add_text_targets(list, 0);
 	}
@@ -258,8 +207,6 @@ bool ClipboardHandler::copy()
 
 	targets = gtk_target_table_new_from_list(list, &n_targets);
 
-	ClipboardContents* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
-
 	gtk_clipboard_set_with_data(this->clipboard, targets, n_targets,
 								(GtkClipboardGetFunc) ClipboardContents::getFunction,
 								(GtkClipboardClearFunc) ClipboardContents::clearFunction, contents);
@@ -267,10 +214,6 @@ bool ClipboardHandler::copy()
 
 	gtk_target_table_free(targets, n_targets);
 	gtk_target_list_unref(list);
-
-	g_string_free(svgString, true);
-
-	return true;
 }
 
 void ClipboardHandler::setSelection(EditSelection* selection)
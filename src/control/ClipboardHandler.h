@@ -17,6 +17,7 @@
 
 #include <gtk/gtk.h>
 
+class ClipboardContents;
 class ObjectInputStream;
 
 class ClipboardListener
@@ -48,6 +49,8 @@ public:
 	void setCopyPasteEnabled(bool enabled);
 
 private:
+	void setClipboardContents(ClipboardContents* contents);
+
 	static void ownerChangedCallback(GtkClipboard* clip, GdkEvent* event, ClipboardHandler* handler);
 	void clipboardUpdated(GdkAtom atom);
 	static void receivedClipboardContents(GtkClipboard* clipboard, GtkSelectionData* selectionData,
@@ -70,6 +73,11 @@ private:
 
 	EditSelection* selection = NULL;
 
+	/**
+	 * The contents of the last copy, reused if the selection is copied again unchanged
+	 */
+	ClipboardContents* contents = NULL;
+
 	bool containsText = false;
 	bool containsXournal = false;
 	bool containsImage = false;
@@ -2,15 +2,18 @@
 
 #include "FullscreenHandler.h"
 #include "PrintHandler.h"
+#include "LatexCompiler.h"
 #include "LatexController.h"
 #include "layer/LayerController.h"
 #include "PageBackgroundChangeController.h"
+#include "SearchIndex.h"
 #include "UndoRedoController.h"
 
 #include "gui/XournalppCursor.h"
 
 #include "gui/dialog/AboutDialog.h"
 #include "gui/dialog/GotoDialog.h"
+#include "gui/dialog/LatencyDialog.h"
 #include "gui/dialog/FillTransparencyDialog.h"
 #include "gui/dialog/FormatDialog.h"
 #include "gui/dialog/PageTemplateDialog.h"
@@ -19,6 +22,8 @@
 #include "gui/dialog/toolbarCustomize/ToolbarDragDropHandler.h"
 #include "gui/dialog/ToolbarManageDialog.h"
 #include "gui/inputdevices/HandRecognition.h"
+#include "gui/inputdevices/InputRecorder.h"
+#include "gui/inputdevices/InputReplay.h"
 #include "gui/TextEditor.h"
 #include "gui/toolbarMenubar/model/ToolbarData.h"
 #include "gui/toolbarMenubar/model/ToolbarModel.h"
@@ -93,6 +98,8 @@ Control::Control(GladeSearchpath* gladeSearchPath)
 	this->settings = new Settings(name);
 	this->settings->load();
 
+	this->undoRedo->setMemoryBudget((size_t) MAX(settings->getUndoMemoryBudget(), 0) * 1024 * 1024);
+
 	TextView::setDpi(settings->getDisplayDpi());
 
 	this->pageTypes = new PageTypeHandler(gladeSearchPath);
@@ -127,6 +134,8 @@ Control::Control(GladeSearchpath* gladeSearchPath)
 	this->layerController = new LayerController(this);
 	this->layerController->registerListener(this);
 
+	this->searchIndex = new SearchIndex(this);
+
 	this->fullscreenHandler = new FullscreenHandler(settings);
 
 	this->pluginController = new PluginController(this);
@@ -163,6 +172,8 @@ Control::~Control()
 	this->toolHandler = NULL;
 	delete this->sidebar;
 	this->sidebar = NULL;
+	delete this->searchIndex;
+	this->searchIndex = NULL;
 	delete this->doc;
 	this->doc = NULL;
 	delete this->searchBar;
@@ -185,12 +196,18 @@ Control::~Control()
 	this->dragDropHandler = NULL;
 	delete this->audioController;
 	this->audioController = NULL;
+	delete this->latexCompiler;
+	this->latexCompiler = NULL;
 	delete this->pageBackgroundChangeController;
 	this->pageBackgroundChangeController = NULL;
 	delete this->layerController;
 	this->layerController = NULL;
 	delete this->fullscreenHandler;
 	this->fullscreenHandler = NULL;
+	delete this->inputRecorder;
+	this->inputRecorder = NULL;
+	delete this->inputReplay;
+	this->inputReplay = NULL;
 
 	XOJ_RELEASE_TYPE(Control);
 }
@@ -1017,6 +1034,9 @@ void Control::actionPerformed(ActionType type, ActionGroup group, GdkEvent* even
 	case ACTION_ABOUT:
 		showAbout();
 		break;
+	case ACTION_LATENCY_STATISTICS:
+		showLatencyStatistics();
+		break;
 
 	default:
 		g_warning("Unhandled action event: %s / %s (%i / %i)",
@@ -2946,6 +2966,14 @@ void Control::showAbout()
 	dlg.show(GTK_WINDOW(this->win->getWindow()));
 }
 
+void Control::showLatencyStatistics()
+{
+	XOJ_CHECK_TYPE(Control);
+
+	LatencyDialog dlg(this->gladeSearchPath);
+	dlg.show(GTK_WINDOW(this->win->getWindow()));
+}
+
 void Control::clipboardCutCopyEnabled(bool enabled)
 {
 	XOJ_CHECK_TYPE(Control);
@@ -3451,6 +3479,13 @@ SearchBar* Control::getSearchBar()
 	return this->searchBar;
 }
 
+SearchIndex* Control::getSearchIndex()
+{
+	XOJ_CHECK_TYPE(Control);
+
+	return this->searchIndex;
+}
+
 AudioController* Control::getAudioController()
 {
 	XOJ_CHECK_TYPE(Control);
@@ -3458,6 +3493,18 @@ AudioController* Control::getAudioController()
 	return this->audioController;
 }
 
+LatexCompiler* Control::getLatexCompiler()
+{
+	XOJ_CHECK_TYPE(Control);
+
+	if (this->latexCompiler == NULL)
+	{
+		this->latexCompiler = new LatexCompiler();
+	}
+
+	return this->latexCompiler;
+}
+
 PageTypeHandler* Control::getPageTypes()
 {
 	XOJ_CHECK_TYPE(Control);
@@ -3486,3 +3533,33 @@ LayerController* Control::getLayerController()
 	return this->layerController;
 }
 
+void Control::setInputRecorder(InputRecorder* recorder)
+{
+	XOJ_CHECK_TYPE(Control);
+
+	delete this->inputRecorder;
+	this->inputRecorder = recorder;
+}
+
+InputRecorder* Control::getInputRecorder()
+{
+	XOJ_CHECK_TYPE(Control);
+
+	return this->inputRecorder;
+}
+
+void Control::setInputReplay(InputReplay* replay)
+{
+	XOJ_CHECK_TYPE(Control);
+
+	delete this->inputReplay;
+	this->inputReplay = replay;
+}
+
+InputReplay* Control::getInputReplay()
+{
+	XOJ_CHECK_TYPE(Control);
+
+	return this->inputReplay;
+}
+
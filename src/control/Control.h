@@ -51,6 +51,10 @@ class PageTypeMenu;
 class BaseExportJob;
 class LayerController;
 class PluginController;
+class InputRecorder;
+class InputReplay;
+class LatexCompiler;
+class SearchIndex;
 
 class Control :
 	public ActionHandler,
@@ -94,6 +98,7 @@ public:
 
 	// Menu Help
 	void showAbout();
+	void showLatencyStatistics();
 
 	virtual void actionPerformed(ActionType type, ActionGroup group, GdkEvent* event, GtkMenuItem* menuitem,
 								 GtkToolButton* toolbutton, bool enabled);
@@ -220,11 +225,21 @@ public:
 	XournalppCursor* getCursor();
 	Sidebar* getSidebar();
 	SearchBar* getSearchBar();
+	SearchIndex* getSearchIndex();
 	AudioController* getAudioController();
 	PageTypeHandler* getPageTypes();
 	PageTypeMenu* getNewPageType();
 	PageBackgroundChangeController* getPageBackgroundChangeController();
 	LayerController* getLayerController();
+	LatexCompiler* getLatexCompiler();
+
+	/**
+	 * Input recording / replay for latency measurements, the Control takes ownership
+	 */
+	void setInputRecorder(InputRecorder* recorder);
+	InputRecorder* getInputRecorder();
+	void setInputReplay(InputReplay* replay);
+	InputReplay* getInputReplay();
 
 
 	bool copy();
@@ -309,6 +324,11 @@ private:
 	Sidebar* sidebar = NULL;
 	SearchBar* searchBar = NULL;
 
+	/**
+	 * Text index of the document, used by the search bar
+	 */
+	SearchIndex* searchIndex = NULL;
+
 	ToolHandler* toolHandler;
 
 	ActionType lastAction;
@@ -319,6 +339,11 @@ private:
 
 	AudioController* audioController;
 
+	/**
+	 * Compiles and caches LaTeX formulas, created on first use
+	 */
+	LatexCompiler* latexCompiler = NULL;
+
 	ToolbarDragDropHandler* dragDropHandler = NULL;
 
 	/**
@@ -378,4 +403,14 @@ private:
 	 * Fullscreen handler
 	 */
 	FullscreenHandler* fullscreenHandler;
+
+	/**
+	 * Records the page input events, if enabled
+	 */
+	InputRecorder* inputRecorder = NULL;
+
+	/**
+	 * Replays recorded input events, if enabled
+	 */
+	InputReplay* inputReplay = NULL;
 };
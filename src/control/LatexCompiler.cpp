@@ -0,0 +1,475 @@
+#include "LatexCompiler.h"
+
+#include <i18n.h>
+#include <Util.h>
+
+#include <glib/gstdio.h>
+
+#include <algorithm>
+
+#ifdef G_OS_WIN32
+#include <windows.h>
+#else
+#include <signal.h>
+#endif
+
+/**
+ * Count of compiled formulas kept in memory
+ */
+#define LATEX_MEMORY_CACHE_ENTRIES 256
+
+/**
+ * Size of all PDFs in the disk cache, in bytes
+ */
+#define LATEX_DISK_CACHE_SIZE (64 * 1024 * 1024)
+
+/**
+ * First half of the LaTeX template used to generate preview PDFs. User-supplied
+ * formulas will be inserted between the two halves.
+ *
+ * This template is necessarily complicated because we need to cause an error if
+ * the rendered formula is blank. Otherwise, a completely blank, sizeless PDF
+ * will be generated, which Poppler will be unable to load.
+ */
+const char* LATEX_TEMPLATE_1 =
+	R"(\documentclass[crop, border=5pt]{standalone})" "\n"
+	R"(\usepackage{amsmath})" "\n"
+	R"(\usepackage{amssymb})" "\n"
+	R"(\usepackage{ifthen})" "\n"
+	R"(\newlength{\pheight})" "\n"
+	R"(\def\preview{\(\displaystyle)" "\n";
+
+const char* LATEX_TEMPLATE_2 =
+	"\n\\)}\n"
+	R"(\begin{document})" "\n"
+	R"(\settoheight{\pheight}{\preview} %)" "\n"
+	R"(\ifthenelse{\pheight=0})" "\n"
+	R"({\GenericError{}{xournalpp: blank formula}{}{}})" "\n"
+	R"(\preview)" "\n"
+	R"(\end{document})" "\n";
+
+class LatexCompileJob
+{
+public:
+	int id = 0;
+	string key;
+	string source;
+	LatexCompileCallback callback;
+
+	/**
+	 * NULL if the compiler was deleted while pdflatex was running
+	 */
+	LatexCompiler* compiler = NULL;
+	GPid pid = 0;
+	bool cancelled = false;
+
+	/**
+	 * Why pdflatex could not be started
+	 */
+	string error;
+};
+
+LatexCompiler::LatexCompiler()
+ : cacheDir(Util::ensureFolderExists(Path(g_get_user_cache_dir()) / "xournalpp" / "latex")),
+   texTmp(Util::getTmpDirSubfolder("tex"))
+{
+	XOJ_INIT_TYPE(LatexCompiler);
+
+	this->maxRunning = std::max(1, (int) g_get_num_processors());
+}
+
+LatexCompiler::~LatexCompiler()
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	for (LatexCompileJob* job : this->queue)
+	{
+		delete job;
+	}
+	this->queue.clear();
+
+	// The child watch deletes the job when pdflatex is terminated
+	for (LatexCompileJob* job : this->running)
+	{
+		job->compiler = NULL;
+		cancel(job->id);
+	}
+	this->running.clear();
+
+	// The idle callback deletes the job
+	for (LatexCompileJob* job : this->failed)
+	{
+		job->compiler = NULL;
+	}
+	this->failed.clear();
+
+	XOJ_RELEASE_TYPE(LatexCompiler);
+}
+
+/**
+ * Find the tex executable, return false if not found
+ */
+bool LatexCompiler::findTexExecutable()
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	if (!this->binTex.isEmpty())
+	{
+		return true;
+	}
+
+	gchar* pdflatex = g_find_program_in_path("pdflatex");
+	if (!pdflatex)
+	{
+		return false;
+	}
+
+	this->binTex = pdflatex;
+	g_free(pdflatex);
+
+	return true;
+}
+
+string LatexCompiler::createTexSource(const string& tex)
+{
+	string source = LATEX_TEMPLATE_1;
+	source += tex;
+	source += LATEX_TEMPLATE_2;
+	return source;
+}
+
+/**
+ * The key contains the template, so changing the template does not reuse old results
+ */
+string LatexCompiler::getKey(const string& source)
+{
+	gchar* hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, source.c_str(), source.length());
+	string key = hash;
+	g_free(hash);
+	return key;
+}
+
+void LatexCompiler::addToMemoryCache(const string& key, const string& pdf)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	if (this->memoryCache.find(key) == this->memoryCache.end())
+	{
+		this->memoryCacheOrder.push_front(key);
+	}
+	this->memoryCache[key] = pdf;
+
+	while (this->memoryCacheOrder.size() > LATEX_MEMORY_CACHE_ENTRIES)
+	{
+		this->memoryCache.erase(this->memoryCacheOrder.back());
+		this->memoryCacheOrder.pop_back();
+	}
+}
+
+bool LatexCompiler::lookup(const string& tex, string& pdf)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	string key = getKey(createTexSource(tex));
+
+	auto it = this->memoryCache.find(key);
+	if (it != this->memoryCache.end())
+	{
+		pdf = it->second;
+
+		this->memoryCacheOrder.remove(key);
+		this->memoryCacheOrder.push_front(key);
+		return true;
+	}
+
+	Path file = this->cacheDir / (key + ".pdf");
+	gchar* contents = NULL;
+	gsize length = 0;
+	if (!g_file_get_contents(file.c_str(), &contents, &length, NULL))
+	{
+		return false;
+	}
+
+	// The modification time is the last use for trimDiskCache()
+	g_utime(file.c_str(), NULL);
+
+	pdf = string(contents, length);
+	g_free(contents);
+
+	addToMemoryCache(key, pdf);
+	return true;
+}
+
+int LatexCompiler::compile(const string& tex, LatexCompileCallback callback)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	LatexCompileJob* job = new LatexCompileJob();
+	job->id = this->nextJobId++;
+	job->source = createTexSource(tex);
+	job->key = getKey(job->source);
+	job->callback = callback;
+	job->compiler = this;
+
+	this->queue.push_back(job);
+	startQueuedJobs();
+
+	return job->id;
+}
+
+void LatexCompiler::cancel(int jobId)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	for (auto it = this->queue.begin(); it != this->queue.end(); it++)
+	{
+		if ((*it)->id == jobId)
+		{
+			delete *it;
+			this->queue.erase(it);
+			return;
+		}
+	}
+
+	for (LatexCompileJob* job : this->running)
+	{
+		if (job->id == jobId && !job->cancelled)
+		{
+			job->cancelled = true;
+#ifdef G_OS_WIN32
+			TerminateProcess(job->pid, 1);
+#else
+			kill(job->pid, SIGTERM);
+#endif
+			return;
+		}
+	}
+
+	for (LatexCompileJob* job : this->failed)
+	{
+		if (job->id == jobId)
+		{
+			job->cancelled = true;
+			return;
+		}
+	}
+}
+
+void LatexCompiler::startQueuedJobs()
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	while (!this->queue.empty() && (int) this->running.size() < this->maxRunning)
+	{
+		LatexCompileJob* job = this->queue.front();
+		this->queue.pop_front();
+
+		if (startJob(job, job->error))
+		{
+			this->running.push_back(job);
+		}
+		else
+		{
+			// The caller of compile() does not expect the callback before it returned
+			this->failed.push_back(job);
+			g_idle_add((GSourceFunc) failedJobCallback, job);
+		}
+	}
+}
+
+/**
+ * Every job has its own file name, so jobs do not overwrite the output of each other
+ */
+bool LatexCompiler::startJob(LatexCompileJob* job, string& error)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	string name = "tex" + std::to_string(job->id);
+	Path texFile = this->texTmp / (name + ".tex");
+
+	GError* err = NULL;
+	if (!g_file_set_contents(texFile.c_str(), job->source.c_str(), job->source.length(), &err))
+	{
+		error = FS(_F("Could not save .tex file: {1}") % err->message);
+		g_error_free(err);
+		return false;
+	}
+
+	string texFileName = texFile.getFilename();
+	char* argv[] = { (char*) this->binTex.c_str(), (char*) "-interaction=nonstopmode", (char*) texFileName.c_str(), NULL };
+
+	GSpawnFlags flags = GSpawnFlags(G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL | G_SPAWN_DO_NOT_REAP_CHILD);
+	if (!g_spawn_async(this->texTmp.c_str(), argv, NULL, flags, NULL, NULL, &job->pid, &err))
+	{
+		error = FS(_F("Could not start pdflatex: {1} (exit code: {2})") % err->message % err->code);
+		g_warning("%s", error.c_str());
+		g_error_free(err);
+		removeJobFiles(job);
+		return false;
+	}
+
+	g_child_watch_add(job->pid, (GChildWatchFunc) childWatchCallback, job);
+	return true;
+}
+
+void LatexCompiler::childWatchCallback(GPid pid, gint status, LatexCompileJob* job)
+{
+	g_spawn_close_pid(pid);
+
+	if (job->compiler == NULL)
+	{
+		// The compiler was deleted, only the job is left
+		delete job;
+		return;
+	}
+
+	job->compiler->finishJob(job, status);
+}
+
+bool LatexCompiler::failedJobCallback(LatexCompileJob* job)
+{
+	LatexCompiler* compiler = job->compiler;
+	if (compiler != NULL)
+	{
+		compiler->failed.erase(std::find(compiler->failed.begin(), compiler->failed.end(), job));
+
+		if (!job->cancelled)
+		{
+			job->callback(LATEX_COMPILE_ERROR, job->error);
+		}
+	}
+	delete job;
+
+	return false;
+}
+
+void LatexCompiler::finishJob(LatexCompileJob* job, gint status)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	this->running.erase(std::find(this->running.begin(), this->running.end(), job));
+
+	LatexCompileStatus result = LATEX_COMPILE_OK;
+	string data;
+
+	GError* err = NULL;
+	if (!g_spawn_check_exit_status(status, &err))
+	{
+		if (g_error_matches(err, G_SPAWN_EXIT_ERROR, 1))
+		{
+			result = LATEX_COMPILE_INVALID;
+		}
+		else
+		{
+			result = LATEX_COMPILE_ERROR;
+			data = FS(_F("pdflatex encountered an error: {1} (exit code: {2})") % err->message % err->code);
+		}
+		g_error_free(err);
+	}
+	else
+	{
+		Path pdfFile = this->texTmp / ("tex" + std::to_string(job->id) + ".pdf");
+		gchar* contents = NULL;
+		gsize length = 0;
+		if (g_file_get_contents(pdfFile.c_str(), &contents, &length, &err))
+		{
+			data = string(contents, length);
+			g_free(contents);
+
+			addToMemoryCache(job->key, data);
+
+			Path cacheFile = this->cacheDir / (job->key + ".pdf");
+			if (g_file_set_contents(cacheFile.c_str(), data.c_str(), data.length(), NULL))
+			{
+				trimDiskCache();
+			}
+		}
+		else
+		{
+			result = LATEX_COMPILE_ERROR;
+			data = FS(_F("Could not load LaTeX PDF file, File Error: {1}") % err->message);
+			g_error_free(err);
+		}
+	}
+
+	removeJobFiles(job);
+
+	if (!job->cancelled)
+	{
+		job->callback(result, data);
+	}
+	delete job;
+
+	startQueuedJobs();
+}
+
+void LatexCompiler::removeJobFiles(LatexCompileJob* job)
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	string name = "tex" + std::to_string(job->id);
+	for (const char* ext : { ".tex", ".pdf", ".aux", ".log" })
+	{
+		Path file = this->texTmp / (name + ext);
+		if (file.exists())
+		{
+			file.deleteFile();
+		}
+	}
+}
+
+void LatexCompiler::trimDiskCache()
+{
+	XOJ_CHECK_TYPE(LatexCompiler);
+
+	GDir* dir = g_dir_open(this->cacheDir.c_str(), 0, NULL);
+	if (dir == NULL)
+	{
+		return;
+	}
+
+	// Modification time and size of each PDF
+	std::vector<std::pair<std::pair<time_t, goffset>, string>> files;
+	goffset size = 0;
+
+	const gchar* name = NULL;
+	while ((name = g_dir_read_name(dir)) != NULL)
+	{
+		if (!g_str_has_suffix(name, ".pdf"))
+		{
+			continue;
+		}
+
+		Path file = this->cacheDir / name;
+		GStatBuf st;
+		if (g_stat(file.c_str(), &st) != 0)
+		{
+			continue;
+		}
+
+		files.push_back({ { st.st_mtime, st.st_size }, file.str() });
+		size += st.st_size;
+	}
+	g_dir_close(dir);
+
+	if (size <= LATEX_DISK_CACHE_SIZE)
+	{
+		return;
+	}
+
+	// The least recently used first
+	std::sort(files.begin(), files.end());
+
+	for (auto& file : files)
+	{
+		if (size <= LATEX_DISK_CACHE_SIZE)
+		{
+			break;
+		}
+
+		if (g_unlink(file.second.c_str()) == 0)
+		{
+			size -= file.first.second;
+		}
+	}
+}
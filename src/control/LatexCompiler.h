@@ -0,0 +1,137 @@
+/*
+ * Xournal++
+ *
+ * Compiles LaTeX formulas to PDF in the background, the results are cached
+ * in memory and on disk, keyed by a hash of the complete .tex source
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <Path.h>
+#include <XournalType.h>
+
+#include <glib.h>
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+using std::string;
+
+enum LatexCompileStatus
+{
+	/**
+	 * The result is the PDF
+	 */
+	LATEX_COMPILE_OK,
+
+	/**
+	 * The formula is invalid or empty, pdflatex failed
+	 */
+	LATEX_COMPILE_INVALID,
+
+	/**
+	 * pdflatex could not be run, the result is the error message
+	 */
+	LATEX_COMPILE_ERROR
+};
+
+typedef std::function<void(LatexCompileStatus status, const string& result)> LatexCompileCallback;
+
+class LatexCompileJob;
+
+class LatexCompiler
+{
+public:
+	LatexCompiler();
+	virtual ~LatexCompiler();
+
+public:
+	/**
+	 * Find the tex executable, return false if not found
+	 */
+	bool findTexExecutable();
+
+	/**
+	 * Get the cached PDF of a formula, from memory or from the disk cache
+	 *
+	 * @return false if the formula was not yet compiled
+	 */
+	bool lookup(const string& tex, string& pdf);
+
+	/**
+	 * Compile a formula in the background, the callback is called from the main loop,
+	 * also if pdflatex cannot be started, never from within compile().
+	 * Up to one pdflatex per processor is run at the same time, other formulas are queued.
+	 *
+	 * @return Job ID, for cancel()
+	 */
+	int compile(const string& tex, LatexCompileCallback callback);
+
+	/**
+	 * Cancel a queued or running compile, pdflatex is killed and the callback is not called
+	 */
+	void cancel(int jobId);
+
+private:
+	static string createTexSource(const string& tex);
+	static string getKey(const string& source);
+	static void childWatchCallback(GPid pid, gint status, LatexCompileJob* job);
+	static bool failedJobCallback(LatexCompileJob* job);
+
+	void startQueuedJobs();
+
+	/**
+	 * @param error The message if pdflatex could not be started
+	 */
+	bool startJob(LatexCompileJob* job, string& error);
+	void finishJob(LatexCompileJob* job, gint status);
+	void removeJobFiles(LatexCompileJob* job);
+	void addToMemoryCache(const string& key, const string& pdf);
+
+	/**
+	 * Delete the least recently used PDFs until the disk cache is within its size limit
+	 */
+	void trimDiskCache();
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	/**
+	 * Tex binary full path
+	 */
+	Path binTex;
+
+	/**
+	 * Persistent cache, one <hash>.pdf per formula
+	 */
+	Path cacheDir;
+
+	/**
+	 * Working directory of pdflatex
+	 */
+	Path texTmp;
+
+	std::deque<LatexCompileJob*> queue;
+	std::vector<LatexCompileJob*> running;
+
+	/**
+	 * Jobs which could not be started, their error is delivered from the main loop
+	 */
+	std::vector<LatexCompileJob*> failed;
+	int nextJobId = 1;
+	int maxRunning = 1;
+
+	/**
+	 * Recently used PDFs, the most recently used key first
+	 */
+	std::map<string, string> memoryCache;
+	std::list<string> memoryCacheOrder;
+};
@@ -14,113 +14,28 @@
 
 #include "pixbuf-utils.h"
 
-/**
- * First half of the LaTeX template used to generate preview PDFs. User-supplied
- * formulas will be inserted between the two halves.
- *
- * This template is necessarily complicated because we need to cause an error if
- * the rendered formula is blank. Otherwise, a completely blank, sizeless PDF
- * will be generated, which Poppler will be unable to load.
- */
-const char* LATEX_TEMPLATE_1 =
-	R"(\documentclass[crop, border=5pt]{standalone})" "\n"
-	R"(\usepackage{amsmath})" "\n"
-	R"(\usepackage{amssymb})" "\n"
-	R"(\usepackage{ifthen})" "\n"
-	R"(\newlength{\pheight})" "\n"
-	R"(\def\preview{\(\displaystyle)" "\n";
-
-const char* LATEX_TEMPLATE_2 =
-	"\n\\)}\n"
-	R"(\begin{document})" "\n"
-	R"(\settoheight{\pheight}{\preview} %)" "\n"
-	R"(\ifthenelse{\pheight=0})" "\n"
-	R"({\GenericError{}{xournalpp: blank formula}{}{}})" "\n"
-	R"(\preview)" "\n"
-	R"(\end{document})" "\n";
-
 LatexController::LatexController(Control* control)
 	: control(control),
-	  doc(control->getDocument()),
-	  texTmp(Util::getTmpDirSubfolder("tex"))
+	  compiler(control->getLatexCompiler()),
+	  doc(control->getDocument())
 {
 	XOJ_INIT_TYPE(LatexController);
-	Util::ensureFolderExists(this->texTmp);
 }
 
 LatexController::~LatexController()
 {
 	XOJ_CHECK_TYPE(LatexController);
 
-	this->control = NULL;
-
-	XOJ_RELEASE_TYPE(LatexController);
-}
-
-/**
- * Find the tex executable, return false if not found
- */
-bool LatexController::findTexExecutable()
-{
-	XOJ_CHECK_TYPE(LatexController);
-
-	gchar* pdflatex = g_find_program_in_path("pdflatex");
-	if (!pdflatex)
+	// The callback of the compile references this controller
+	if (this->compileJob)
 	{
-		return false;
+		this->compiler->cancel(this->compileJob);
+		this->compileJob = 0;
 	}
 
-	binTex = pdflatex;
-	g_free(pdflatex);
-
-	return true;
-}
-
-std::unique_ptr<GPid> LatexController::runCommandAsync()
-{
-	XOJ_CHECK_TYPE(LatexController);
-	g_assert(!this->isUpdating);
-
-	string texContents = LATEX_TEMPLATE_1;
-	texContents += this->currentTex;
-	texContents += LATEX_TEMPLATE_2;
-
-	Path texFile = texTmp / "tex.tex";
-
-	GError* err = NULL;
-	if (!g_file_set_contents(texFile.c_str(), texContents.c_str(), texContents.length(), &err))
-	{
-		XojMsgBox::showErrorToUser(control->getGtkWindow(), FS(_F("Could not save .tex file: {1}") % err->message));
-		g_error_free(err);
-		return nullptr;
-	}
-
-	char* texFileEscaped = g_strescape(texFile.c_str(), NULL);
-	char* cmd = g_strdup(binTex.c_str());
-
-	static char* texFlag = g_strdup("-interaction=nonstopmode");
-	char* argv[] = { cmd, texFlag, texFileEscaped, NULL };
-
-	std::unique_ptr<GPid> pdflatex_pid(new GPid);
-	GSpawnFlags flags = GSpawnFlags(G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL | G_SPAWN_DO_NOT_REAP_CHILD);
-	this->setUpdating(true);
-	this->lastPreviewedTex = this->currentTex;
-	bool success = g_spawn_async(texTmp.c_str(), argv, nullptr, flags, nullptr, nullptr, pdflatex_pid.get(), &err);
-	if (!success)
-	{
-		string message = FS(_F("Could not start pdflatex: {1} (exit code: {2})") % err->message % err->code);
-		g_warning(message.c_str());
-		XojMsgBox::showErrorToUser(control->getGtkWindow(), message);
-
-		g_error_free(err);
-		this->setUpdating(false);
-		pdflatex_pid.reset();
-	}
-
-	g_free(texFileEscaped);
-	g_free(cmd);
+	this->control = NULL;
 
-	return pdflatex_pid;
+	XOJ_RELEASE_TYPE(LatexController);
 }
 
 /**
@@ -208,17 +123,36 @@ void LatexController::showTexEditDialog()
 
 void LatexController::triggerImageUpdate()
 {
-	if (this->isUpdating)
+	XOJ_CHECK_TYPE(LatexController);
+
+	if (this->currentTex == this->lastPreviewedTex)
 	{
 		return;
 	}
 
-	std::unique_ptr<GPid> pid = this->runCommandAsync();
-	if (pid != nullptr)
+	if (this->compileJob)
 	{
-		g_assert(this->isUpdating);
-		g_child_watch_add(*pid, reinterpret_cast<GChildWatchFunc>(onPdfRenderComplete), this);
+		// The formula changed, the running compile is not needed anymore
+		this->compiler->cancel(this->compileJob);
+		this->compileJob = 0;
 	}
+
+	this->lastPreviewedTex = this->currentTex;
+
+	string pdf;
+	if (this->compiler->lookup(this->currentTex, pdf))
+	{
+		this->setUpdating(true);
+		onPdfRenderComplete(LATEX_COMPILE_OK, pdf);
+		return;
+	}
+
+	this->setUpdating(true);
+	this->compileJob = this->compiler->compile(this->currentTex, [this](LatexCompileStatus status, const string& result)
+	{
+		this->compileJob = 0;
+		this->onPdfRenderComplete(status, result);
+	});
 }
 
 /**
@@ -242,47 +176,35 @@ void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* s
 	self->triggerImageUpdate();
 }
 
-void LatexController::onPdfRenderComplete(GPid pid, gint returnCode, LatexController* self)
+void LatexController::onPdfRenderComplete(LatexCompileStatus status, const string& result)
 {
-	XOJ_CHECK_TYPE_OBJ(self, LatexController);
-	g_assert(self->isUpdating);
-	GError* err = nullptr;
-	g_spawn_check_exit_status(returnCode, &err);
-	g_spawn_close_pid(pid);
-	bool shouldUpdate = self->lastPreviewedTex != self->currentTex;
-	if (err != nullptr)
+	XOJ_CHECK_TYPE(LatexController);
+	g_assert(this->isUpdating);
+
+	if (status == LATEX_COMPILE_OK)
 	{
-		self->isValidTex = false;
-		if (!g_error_matches(err, G_SPAWN_EXIT_ERROR, 1))
+		this->isValidTex = true;
+		this->renderedPdf = result;
+		this->temporaryRender = this->loadRendered();
+		if (this->temporaryRender != nullptr)
 		{
-			// The error was not caused by invalid LaTeX.
-			string message = FS(_F("pdflatex encountered an error: {1} (exit code: {2})") % err->message % err->code);
-			g_warning(message.c_str());
-			XojMsgBox::showErrorToUser(self->control->getGtkWindow(), message);
+			this->setImageInDialog(this->temporaryRender->getPdf());
 		}
-		Path pdfPath = self->texTmp / "tex.pdf";
-		if (pdfPath.exists())
-		{
-			// Delete the pdf to prevent more errors
-			pdfPath.deleteFile();
-		}
-		g_error_free(err);
 	}
 	else
 	{
-		self->isValidTex = true;
-		self->temporaryRender = self->loadRendered();
-		if (self->temporaryRender != nullptr)
+		this->isValidTex = false;
+		this->renderedPdf.clear();
+
+		if (status == LATEX_COMPILE_ERROR)
 		{
-			self->setImageInDialog(self->temporaryRender->getPdf());
+			// The error was not caused by invalid LaTeX.
+			g_warning("%s", result.c_str());
+			XojMsgBox::showErrorToUser(this->control->getGtkWindow(), result);
 		}
-
-	}
-	self->setUpdating(false);
-	if (shouldUpdate)
-	{
-		self->triggerImageUpdate();
 	}
+
+	this->setUpdating(false);
 }
 
 void LatexController::setUpdating(bool newValue)
@@ -407,20 +329,9 @@ std::unique_ptr<TexImage> LatexController::loadRendered()
 		return nullptr;
 	}
 
-	Path pdfPath = texTmp / "tex.pdf";
 	GError* err = NULL;
 
-	gchar* fileContents = NULL;
-	gsize fileLength = 0;
-	if (!g_file_get_contents(pdfPath.c_str(), &fileContents, &fileLength, &err))
-	{
-		XojMsgBox::showErrorToUser(control->getGtkWindow(),
-				FS(_F("Could not load LaTeX PDF file, File Error: {1}") % err->message));
-		g_error_free(err);
-		return NULL;
-	}
-
-	PopplerDocument* pdf = poppler_document_new_from_data(fileContents, fileLength, NULL, &err);
+	PopplerDocument* pdf = poppler_document_new_from_data((char*) this->renderedPdf.c_str(), this->renderedPdf.length(), NULL, &err);
 	if (err != NULL)
 	{
 		string message = FS(_F("Could not load LaTeX PDF file: {1}") % err->message);
@@ -441,9 +352,7 @@ std::unique_ptr<TexImage> LatexController::loadRendered()
 
 	// Do not assign the PDF, theoretical it should work, but it gets a Poppler PDF error
 	// img->setPdf(pdf);
-	img->setBinaryData(string(fileContents, fileLength));
-
-	g_free(fileContents);
+	img->setBinaryData(this->renderedPdf);
 
 	return img;
 }
@@ -473,7 +382,7 @@ void LatexController::run()
 {
 	XOJ_CHECK_TYPE(LatexController);
 
-	if (!this->findTexExecutable())
+	if (!this->compiler->findTexExecutable())
 	{
 		string msg = _("Could not find pdflatex in Path.\nPlease install pdflatex first and make sure it's in the PATH.");
 		XojMsgBox::showErrorToUser(control->getGtkWindow(), msg);
@@ -17,6 +17,8 @@
 #include "model/PageRef.h"
 #include "model/Text.h"
 
+#include "LatexCompiler.h"
+
 #include <Path.h>
 #include <XournalType.h>
 #include "gui/dialog/LatexDialog.h"
@@ -26,6 +28,7 @@
 #include <memory>
 
 class Control;
+class LatexCompiler;
 class TexImage;
 class Text;
 class Document;
@@ -47,11 +50,6 @@ public:
 	void run();
 
 private:
-	/**
-	 * Find the tex executable, return false if not found
-	 */
-	bool findTexExecutable();
-
 	/**
 	 * Find a selected tex element, and load it
 	 */
@@ -63,17 +61,8 @@ private:
 	void deleteOldImage();
 
 	/**
-	 * Run the LaTeX command asynchronously. Note that this method can only be
-	 * called when the preview is not updating.
-	 *
-	 * @return The PID of the spawned process, or nullptr if the .tex file could
-	 * not be written or the command failed to start.
-	 */
-	std::unique_ptr<GPid> runCommandAsync();
-
-	/**
-	 * Asynchronously runs the LaTeX command and then updates the TeX image. If
-	 * the preview is already being updated, then this method will be a no-op.
+	 * Updates the TeX image from the compile cache, or compiles it asynchronously.
+	 * A compile of a previous version of the formula is cancelled.
 	 */
 	void triggerImageUpdate();
 
@@ -89,12 +78,9 @@ private:
 	static void handleTexChanged(GtkTextBuffer* buffer, LatexController* self);
 
 	/**
-	 * Updates the display once the PDF file is generated.
-	 *
-	 * If the Latex text has changed since the last update, triggerPreviewUpdate
-	 * will be called again.
+	 * Updates the display once the PDF is generated, or taken from the cache
 	 */
-	static void onPdfRenderComplete(GPid pid, gint returnCode, LatexController* self);
+	void onPdfRenderComplete(LatexCompileStatus status, const string& result);
 
 	void setUpdating(bool newValue);
 
@@ -113,7 +99,7 @@ private:
 	std::unique_ptr<TexImage> convertDocumentToImage(PopplerDocument* doc);
 
 	/**
-	 * Load PDF as TexImage
+	 * Load the rendered PDF as TexImage
 	 */
 	std::unique_ptr<TexImage> loadRendered();
 
@@ -127,10 +113,17 @@ private:
 
 	Control* control = NULL;
 
+	LatexCompiler* compiler = NULL;
+
+	/**
+	 * The running compile of the preview, 0 if none
+	 */
+	int compileJob = 0;
+
 	/**
-	 * Tex binary full path
+	 * The PDF of the last successful preview
 	 */
-	Path binTex;
+	string renderedPdf;
 
 	/**
 	 * The original TeX string when the dialog was opened, or the empty string
@@ -199,12 +192,6 @@ private:
 	 */
 	Layer* layer = NULL;
 
-	/**
-	 * The directory in which the LaTeX files will be generated. Note that this
-	 * should be within a system temporary directory.
-	 */
-	Path texTmp;
-
 	/**
 	 * Previously existing TexImage
 	 */
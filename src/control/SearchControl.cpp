@@ -1,15 +1,14 @@
 #include "SearchControl.h"
 
-#include "model/Text.h"
-#include "model/Layer.h"
-#include "view/TextView.h"
+#include "SearchIndex.h"
 
-SearchControl::SearchControl(PageRef page, XojPdfPageSPtr pdf)
+SearchControl::SearchControl(PageRef page, XojPdfPageSPtr pdf, SearchIndex* index)
 {
 	XOJ_INIT_TYPE(SearchControl);
 
 	this->page = page;
 	this->pdf = pdf;
+	this->index = index;
 }
 
 SearchControl::~SearchControl()
@@ -53,29 +52,11 @@ bool SearchControl::search(string text, int* occures, double* top)
 
 	if (text.empty()) return true;
 
-	if (this->pdf)
+	// Text elements are always found in the index, the PDF text only if the page is already indexed
+	if (!this->index->searchPage(this->page, text, this->results) && this->pdf)
 	{
-		this->results = this->pdf->findText(text);
-	}
-
-	for (Layer* l : *this->page->getLayers())
-	{
-		if (!this->page->isLayerVisible(l))
-		{
-			continue;
-		}
-		
-		for (Element* e : *l->getElements())
-		{
-			if (e->getType() == ELEMENT_TEXT)
-			{
-				Text* t = (Text*) e;
-
-				vector<XojPdfRectangle> textResult = TextView::findText(t, text);
-
-				this->results.insert(this->results.end(), textResult.begin(), textResult.end());
-			}
-		}
+		vector<XojPdfRectangle> pdfResults = this->pdf->findText(text);
+		this->results.insert(this->results.begin(), pdfResults.begin(), pdfResults.end());
 	}
 
 	if (occures)
@@ -15,10 +15,12 @@
 #include "util/GtkColorWrapper.h"
 #include "pdf/base/XojPdfPage.h"
 
+class SearchIndex;
+
 class SearchControl
 {
 public:
-	SearchControl(PageRef page, XojPdfPageSPtr pdf);
+	SearchControl(PageRef page, XojPdfPageSPtr pdf, SearchIndex* index);
 	virtual ~SearchControl();
 
 	bool search(string text, int* occures, double* top);
@@ -31,6 +33,7 @@ private:
 
 	PageRef page;
 	XojPdfPageSPtr pdf;
+	SearchIndex* index;
 
 	vector<XojPdfRectangle> results;
 };
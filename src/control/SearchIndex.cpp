@@ -0,0 +1,625 @@
+#include "SearchIndex.h"
+
+#include "Control.h"
+#include "jobs/SearchIndexJob.h"
+
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Text.h"
+#include "view/TextView.h"
+
+#include <Util.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+SearchIndexPage::SearchIndexPage(PageRef page)
+ : page(page)
+{
+	XOJ_INIT_TYPE(SearchIndexPage);
+
+	registerListener(page);
+}
+
+SearchIndexPage::~SearchIndexPage()
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	unregisterListener();
+
+	XOJ_RELEASE_TYPE(SearchIndexPage);
+}
+
+/**
+ * The texts are only indexed again if the page was changed since the last call
+ */
+vector<SearchIndexText>& SearchIndexPage::getTexts()
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	if (!this->dirty)
+	{
+		return this->texts;
+	}
+
+	this->texts.clear();
+	for (Layer* l : *this->page->getLayers())
+	{
+		for (Element* e : *l->getElements())
+		{
+			if (e->getType() != ELEMENT_TEXT)
+			{
+				continue;
+			}
+
+			SearchIndexText entry;
+			entry.text = (Text*) e;
+			entry.layer = l;
+			entry.chars = SearchIndex::toSearchChars(entry.text->getText(), &entry.offsets);
+			this->texts.push_back(entry);
+		}
+	}
+
+	this->dirty = false;
+	return this->texts;
+}
+
+void SearchIndexPage::rectChanged(Rectangle& rect)
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	this->dirty = true;
+}
+
+void SearchIndexPage::rangeChanged(Range& range)
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	this->dirty = true;
+}
+
+void SearchIndexPage::elementChanged(Element* elem)
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	this->dirty = true;
+}
+
+void SearchIndexPage::pageChanged()
+{
+	XOJ_CHECK_TYPE(SearchIndexPage);
+
+	this->dirty = true;
+}
+
+SearchIndex::SearchIndex(Control* control)
+ : control(control)
+{
+	XOJ_INIT_TYPE(SearchIndex);
+
+	g_mutex_init(&this->pdfLock);
+
+	registerListener(control);
+}
+
+SearchIndex::~SearchIndex()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	clear();
+	g_mutex_clear(&this->pdfLock);
+
+	XOJ_RELEASE_TYPE(SearchIndex);
+}
+
+void SearchIndex::clear()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	for (auto& it : this->pages)
+	{
+		delete it.second;
+	}
+	this->pages.clear();
+
+	g_mutex_lock(&this->pdfLock);
+
+	this->generation++;
+	this->started = false;
+
+	for (SearchIndexPdfPage* p : this->pdfPages)
+	{
+		delete p;
+	}
+	this->pdfPages.clear();
+	this->indexedPdfPages = 0;
+	this->trigrams.clear();
+
+	g_mutex_unlock(&this->pdfLock);
+}
+
+void SearchIndex::start()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	Document* doc = control->getDocument();
+	doc->lock();
+	size_t pdfPageCount = doc->getPdfPageCount();
+	doc->unlock();
+
+	vector<size_t> missing;
+
+	g_mutex_lock(&this->pdfLock);
+	if (this->started)
+	{
+		g_mutex_unlock(&this->pdfLock);
+		return;
+	}
+	this->started = true;
+
+	this->pdfPages.resize(pdfPageCount, NULL);
+	for (size_t i = 0; i < pdfPageCount; i++)
+	{
+		if (this->pdfPages[i] == NULL)
+		{
+			missing.push_back(i);
+		}
+	}
+	int generation = this->generation;
+	g_mutex_unlock(&this->pdfLock);
+
+	// Lowest priority, rendering is always done first
+	for (size_t pdfPage : missing)
+	{
+		SearchIndexJob* job = new SearchIndexJob(this, pdfPage, generation);
+		control->getScheduler()->addJob(job, JOB_PRIORITY_NONE);
+		job->unref();
+	}
+}
+
+void SearchIndex::cancel()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	g_mutex_lock(&this->pdfLock);
+	this->generation++;
+	this->started = false;
+	g_mutex_unlock(&this->pdfLock);
+}
+
+int SearchIndex::getProgress()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	g_mutex_lock(&this->pdfLock);
+	int progress = this->pdfPages.empty() ? 100 : (int) (this->indexedPdfPages * 100 / this->pdfPages.size());
+	g_mutex_unlock(&this->pdfLock);
+
+	return progress;
+}
+
+bool SearchIndex::isComplete()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	g_mutex_lock(&this->pdfLock);
+	bool complete = this->started && this->indexedPdfPages == this->pdfPages.size();
+	g_mutex_unlock(&this->pdfLock);
+
+	return complete;
+}
+
+void SearchIndex::indexPdfPage(size_t pdfPage, int generation)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	g_mutex_lock(&this->pdfLock);
+	bool current = generation == this->generation;
+	g_mutex_unlock(&this->pdfLock);
+	if (!current)
+	{
+		return;
+	}
+
+	Document* doc = control->getDocument();
+	doc->lock();
+	XojPdfPageSPtr pdf = doc->getPdfPage(pdfPage);
+	doc->unlock();
+
+	SearchIndexPdfPage* page = NULL;
+	if (pdf)
+	{
+		vector<XojPdfRectangle> characters;
+		string text = pdf->getText(characters);
+		page = createPdfPage(text, characters);
+	}
+	else
+	{
+		page = new SearchIndexPdfPage();
+	}
+
+	std::unordered_set<guint64> pageTrigrams;
+	for (size_t i = 0; i + 2 < page->chars.size(); i++)
+	{
+		pageTrigrams.insert(trigram(page->chars[i], page->chars[i + 1], page->chars[i + 2]));
+	}
+
+	g_mutex_lock(&this->pdfLock);
+
+	if (generation != this->generation || pdfPage >= this->pdfPages.size() || this->pdfPages[pdfPage] != NULL)
+	{
+		g_mutex_unlock(&this->pdfLock);
+		delete page;
+		return;
+	}
+
+	this->pdfPages[pdfPage] = page;
+	for (guint64 t : pageTrigrams)
+	{
+		this->trigrams[t].push_back(pdfPage);
+	}
+	this->indexedPdfPages++;
+	bool complete = this->indexedPdfPages == this->pdfPages.size();
+
+	g_mutex_unlock(&this->pdfLock);
+
+	if (complete)
+	{
+		Control* control = this->control;
+		Util::execInUiThread([=]() {
+			control->getSearchBar()->indexUpdated();
+		});
+	}
+}
+
+vector<gunichar> SearchIndex::toSearchChars(const string& text, vector<int>* offsets, vector<size_t>* indices)
+{
+	vector<gunichar> chars;
+	chars.reserve(text.length());
+
+	const char* str = text.c_str();
+	const char* end = str + text.length();
+	size_t index = 0;
+	for (const char* p = str; p < end; p = g_utf8_next_char(p), index++)
+	{
+		gunichar c = g_utf8_get_char(p);
+		if (g_unichar_isspace(c))
+		{
+			if (!chars.empty() && chars.back() == ' ')
+			{
+				// The run is already represented by its first character
+				continue;
+			}
+			c = ' ';
+		}
+
+		if (offsets)
+		{
+			offsets->push_back(p - str);
+		}
+		if (indices)
+		{
+			indices->push_back(index);
+		}
+		chars.push_back(g_unichar_tolower(c));
+	}
+
+	if (offsets)
+	{
+		// End of the last character
+		offsets->push_back(text.length());
+	}
+
+	return chars;
+}
+
+SearchIndexPdfPage* SearchIndex::createPdfPage(const string& text, const vector<XojPdfRectangle>& characters)
+{
+	SearchIndexPdfPage* page = new SearchIndexPdfPage();
+
+	vector<size_t> indices;
+	page->chars = toSearchChars(text, NULL, &indices);
+
+	// Should not happen, but the characters without position cannot be found
+	size_t count = 0;
+	while (count < indices.size() && indices[count] < characters.size())
+	{
+		count++;
+	}
+	page->chars.resize(count);
+
+	page->rects.reserve(count * 4);
+	for (size_t i = 0; i < count; i++)
+	{
+		const XojPdfRectangle& r = characters[indices[i]];
+		page->rects.push_back(r.x1);
+		page->rects.push_back(r.y1);
+		page->rects.push_back(r.x2);
+		page->rects.push_back(r.y2);
+	}
+
+	return page;
+}
+
+guint64 SearchIndex::trigram(gunichar a, gunichar b, gunichar c)
+{
+	return ((guint64) a << 42) | ((guint64) b << 21) | (guint64) c;
+}
+
+void SearchIndex::findAll(const vector<gunichar>& chars, const vector<gunichar>& search, vector<size_t>& positions)
+{
+	if (search.empty() || chars.size() < search.size())
+	{
+		return;
+	}
+
+	auto it = chars.begin();
+	while ((it = std::search(it, chars.end(), search.begin(), search.end())) != chars.end())
+	{
+		positions.push_back(it - chars.begin());
+		it += search.size();
+	}
+}
+
+/**
+ * A page can only contain the text if it contains all trigrams of the text,
+ * the pages of the trigram with the fewest pages are the candidates
+ *
+ * @return false if every page is a candidate
+ */
+bool SearchIndex::getPdfCandidates(const vector<gunichar>& search, std::unordered_set<size_t>& candidates)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	if (search.size() < 3)
+	{
+		return false;
+	}
+
+	const vector<size_t>* rarest = NULL;
+	for (size_t i = 0; i + 2 < search.size(); i++)
+	{
+		auto it = this->trigrams.find(trigram(search[i], search[i + 1], search[i + 2]));
+		if (it == this->trigrams.end())
+		{
+			// No page contains this text
+			return true;
+		}
+		if (rarest == NULL || it->second.size() < rarest->size())
+		{
+			rarest = &it->second;
+		}
+	}
+
+	candidates.insert(rarest->begin(), rarest->end());
+	return true;
+}
+
+void SearchIndex::findTexts(PageRef page, const vector<gunichar>& search, vector<XojPdfRectangle>& results)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	for (SearchIndexText& entry : getPage(page)->getTexts())
+	{
+		if (!page->isLayerVisible(entry.layer))
+		{
+			continue;
+		}
+
+		vector<size_t> positions;
+		findAll(entry.chars, search, positions);
+		if (positions.empty())
+		{
+			continue;
+		}
+
+		Text* t = entry.text;
+		PangoLayout* layout = TextView::getLayout(t);
+
+		for (size_t pos : positions)
+		{
+			XojPdfRectangle mark;
+			PangoRectangle rect = { 0 };
+			pango_layout_index_to_pos(layout, entry.offsets[pos], &rect);
+			mark.x1 = ((double) rect.x) / PANGO_SCALE + t->getX();
+			mark.y1 = ((double) rect.y) / PANGO_SCALE + t->getY();
+
+			pango_layout_index_to_pos(layout, entry.offsets[pos + search.size()], &rect);
+			mark.x2 = ((double) rect.x + rect.width) / PANGO_SCALE + t->getX();
+			mark.y2 = ((double) rect.y + rect.height) / PANGO_SCALE + t->getY();
+
+			results.push_back(mark);
+		}
+	}
+}
+
+void SearchIndex::findPdfText(SearchIndexPdfPage* page, const vector<gunichar>& search, vector<XojPdfRectangle>& results)
+{
+	vector<size_t> positions;
+	findAll(page->chars, search, positions);
+
+	for (size_t pos : positions)
+	{
+		bool hasRect = false;
+		XojPdfRectangle mark;
+
+		for (size_t i = pos; i < pos + search.size(); i++)
+		{
+			const float* r = &page->rects[i * 4];
+			if (r[2] <= r[0] || r[3] <= r[1])
+			{
+				// Line break or other character without size
+				continue;
+			}
+
+			if (hasRect && std::abs(r[1] - mark.y1) > (mark.y2 - mark.y1) / 2)
+			{
+				results.push_back(mark);
+				hasRect = false;
+			}
+
+			if (!hasRect)
+			{
+				mark = XojPdfRectangle(r[0], r[1], r[2], r[3]);
+				hasRect = true;
+			}
+			else
+			{
+				mark.x1 = std::min(mark.x1, (double) r[0]);
+				mark.y1 = std::min(mark.y1, (double) r[1]);
+				mark.x2 = std::max(mark.x2, (double) r[2]);
+				mark.y2 = std::max(mark.y2, (double) r[3]);
+			}
+		}
+
+		if (hasRect)
+		{
+			results.push_back(mark);
+		}
+	}
+}
+
+SearchIndexPage* SearchIndex::getPage(PageRef page)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	SearchIndexPage*& entry = this->pages[(XojPage*) page];
+	if (entry == NULL)
+	{
+		entry = new SearchIndexPage(page);
+	}
+	return entry;
+}
+
+bool SearchIndex::searchPage(PageRef page, const string& text, vector<XojPdfRectangle>& results)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	vector<gunichar> search = toSearchChars(text);
+
+	g_mutex_lock(&this->pdfLock);
+	std::unordered_set<size_t> candidates;
+	bool limited = getPdfCandidates(search, candidates);
+	bool indexed = searchPage(page, search, limited ? &candidates : NULL, results);
+	g_mutex_unlock(&this->pdfLock);
+
+	return indexed;
+}
+
+/**
+ * Has to be called with pdfLock
+ */
+bool SearchIndex::searchPage(PageRef page, const vector<gunichar>& search, std::unordered_set<size_t>* candidates,
+                             vector<XojPdfRectangle>& results)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	bool indexed = true;
+	if (page->getBackgroundType().isPdfPage())
+	{
+		size_t pdfPage = page->getPdfPageNr();
+		if (pdfPage >= this->pdfPages.size() || this->pdfPages[pdfPage] == NULL)
+		{
+			indexed = false;
+		}
+		else if (candidates == NULL || candidates->find(pdfPage) != candidates->end())
+		{
+			findPdfText(this->pdfPages[pdfPage], search, results);
+		}
+	}
+
+	findTexts(page, search, results);
+
+	return indexed;
+}
+
+vector<SearchIndexHit> SearchIndex::search(const string& text)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	vector<gunichar> search = toSearchChars(text);
+	vector<SearchIndexHit> hits;
+
+	Document* doc = control->getDocument();
+	doc->lock();
+	g_mutex_lock(&this->pdfLock);
+
+	std::unordered_set<size_t> candidates;
+	bool limited = getPdfCandidates(search, candidates);
+
+	for (size_t i = 0; i < doc->getPageCount(); i++)
+	{
+		vector<XojPdfRectangle> results;
+		searchPage(doc->getPage(i), search, limited ? &candidates : NULL, results);
+
+		for (XojPdfRectangle& rect : results)
+		{
+			hits.push_back({ i, rect });
+		}
+	}
+
+	g_mutex_unlock(&this->pdfLock);
+	doc->unlock();
+
+	return hits;
+}
+
+/**
+ * Remove the Text index of all pages which are not part of the document anymore
+ */
+void SearchIndex::removeDeletedPages()
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	Document* doc = control->getDocument();
+	std::unordered_set<XojPage*> documentPages;
+
+	doc->lock();
+	for (size_t i = 0; i < doc->getPageCount(); i++)
+	{
+		documentPages.insert((XojPage*) doc->getPage(i));
+	}
+	doc->unlock();
+
+	for (auto it = this->pages.begin(); it != this->pages.end();)
+	{
+		if (documentPages.find(it->first) == documentPages.end())
+		{
+			delete it->second;
+			it = this->pages.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+void SearchIndex::documentChanged(DocumentChangeType type)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	if (type != DOCUMENT_CHANGE_CLEARED && type != DOCUMENT_CHANGE_COMPLETE)
+	{
+		return;
+	}
+
+	g_mutex_lock(&this->pdfLock);
+	bool wasStarted = this->started;
+	g_mutex_unlock(&this->pdfLock);
+
+	clear();
+
+	// The search bar is still open, index the new document
+	if (wasStarted && type == DOCUMENT_CHANGE_COMPLETE)
+	{
+		start();
+	}
+}
+
+void SearchIndex::pageDeleted(size_t page)
+{
+	XOJ_CHECK_TYPE(SearchIndex);
+
+	removeDeletedPages();
+}
@@ -0,0 +1,203 @@
+/*
+ * Xournal++
+ *
+ * Search index of the whole document. The PDF text is indexed in the background,
+ * the Text elements of a page are indexed again when the page changes.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "model/DocumentListener.h"
+#include "model/PageListener.h"
+#include "model/PageRef.h"
+#include "pdf/base/XojPdfPage.h"
+
+#include <XournalType.h>
+
+#include <glib.h>
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+using std::vector;
+
+class Control;
+class Layer;
+class Text;
+
+class SearchIndexHit
+{
+public:
+	size_t page;
+	XojPdfRectangle rect;
+};
+
+/**
+ * Search characters of a text (see SearchIndex::toSearchChars()), and the byte offset of
+ * each character in the original text
+ */
+class SearchIndexText
+{
+public:
+	Text* text = NULL;
+	Layer* layer = NULL;
+	vector<gunichar> chars;
+	vector<int> offsets;
+};
+
+/**
+ * The indexed PDF text of a page, with the bounding box of each character
+ */
+class SearchIndexPdfPage
+{
+public:
+	vector<gunichar> chars;
+	vector<float> rects;
+};
+
+/**
+ * The indexed Text elements of a page, indexed again after the page changed
+ */
+class SearchIndexPage : public PageListener
+{
+public:
+	SearchIndexPage(PageRef page);
+	virtual ~SearchIndexPage();
+
+public:
+	vector<SearchIndexText>& getTexts();
+
+	// PageListener
+	virtual void rectChanged(Rectangle& rect);
+	virtual void rangeChanged(Range& range);
+	virtual void elementChanged(Element* elem);
+	virtual void pageChanged();
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	PageRef page;
+	bool dirty = true;
+	vector<SearchIndexText> texts;
+};
+
+class SearchIndex : public DocumentListener
+{
+public:
+	SearchIndex(Control* control);
+	virtual ~SearchIndex();
+
+public:
+	/**
+	 * Start to index the PDF text in the background, only the pages which are not yet indexed
+	 */
+	void start();
+
+	/**
+	 * Stop the background indexing, the indexed pages are kept
+	 */
+	void cancel();
+
+	/**
+	 * @return The indexed PDF pages in percent
+	 */
+	int getProgress();
+	bool isComplete();
+
+	/**
+	 * All hits of the document, ordered by page. Pages with PDF text which is not yet indexed
+	 * only contain the hits in Text elements.
+	 */
+	vector<SearchIndexHit> search(const string& text);
+
+	/**
+	 * The hits of one page
+	 *
+	 * @return false if the PDF text of the page is not yet indexed, results only contains
+	 *         the hits in Text elements then
+	 */
+	bool searchPage(PageRef page, const string& text, vector<XojPdfRectangle>& results);
+
+	/**
+	 * Called from SearchIndexJob, in the scheduler thread
+	 */
+	void indexPdfPage(size_t pdfPage, int generation);
+
+	/**
+	 * Lower case characters, one per UTF-8 character. Each run of whitespace (also line breaks)
+	 * is one space, like poppler_page_find_text() matches text which wraps a line.
+	 *
+	 * @param offsets If not NULL, the byte offset of each character, and the end of the text
+	 * @param indices If not NULL, the index of each character in the original text
+	 */
+	static vector<gunichar> toSearchChars(const string& text, vector<int>* offsets = NULL,
+	                                      vector<size_t>* indices = NULL);
+
+	/**
+	 * Index the text of a PDF page
+	 *
+	 * @param characters The bounding box of each character of text
+	 */
+	static SearchIndexPdfPage* createPdfPage(const string& text, const vector<XojPdfRectangle>& characters);
+
+	/**
+	 * The hits of a PDF page, one rectangle per line of a hit
+	 */
+	static void findPdfText(SearchIndexPdfPage* page, const vector<gunichar>& search, vector<XojPdfRectangle>& results);
+
+public:
+	// DocumentListener
+	virtual void documentChanged(DocumentChangeType type);
+	virtual void pageDeleted(size_t page);
+
+private:
+	void clear();
+	void removeDeletedPages();
+	SearchIndexPage* getPage(PageRef page);
+
+	bool searchPage(PageRef page, const vector<gunichar>& search, std::unordered_set<size_t>* candidates,
+	                vector<XojPdfRectangle>& results);
+	void findTexts(PageRef page, const vector<gunichar>& search, vector<XojPdfRectangle>& results);
+	bool getPdfCandidates(const vector<gunichar>& search, std::unordered_set<size_t>& candidates);
+
+	static void findAll(const vector<gunichar>& chars, const vector<gunichar>& search, vector<size_t>& positions);
+	static guint64 trigram(gunichar a, gunichar b, gunichar c);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	Control* control = NULL;
+
+	/**
+	 * Text element index, only used from the UI thread
+	 */
+	std::map<XojPage*, SearchIndexPage*> pages;
+
+	/**
+	 * Protects all PDF index data, it's written from the scheduler thread
+	 */
+	GMutex pdfLock;
+
+	/**
+	 * Indexed by the PDF page number, NULL if not yet indexed
+	 */
+	vector<SearchIndexPdfPage*> pdfPages;
+	size_t indexedPdfPages = 0;
+
+	/**
+	 * All PDF pages which contain a sequence of three characters
+	 */
+	std::unordered_map<guint64, vector<size_t>> trigrams;
+
+	/**
+	 * Incremented on cancel, jobs of an older generation do nothing
+	 */
+	int generation = 0;
+	bool started = false;
+};
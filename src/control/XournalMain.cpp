@@ -6,8 +6,11 @@
 #include "control/jobs/ProgressListener.h"
 #include "gui/GladeSearchpath.h"
 #include "gui/MainWindow.h"
+#include "gui/inputdevices/InputRecorder.h"
+#include "gui/inputdevices/InputReplay.h"
 #include "gui/toolbarMenubar/model/ToolbarColorNames.h"
 #include "gui/XournalView.h"
+#include "model/XojPage.h"
 #include "pdf/base/XojPdfExport.h"
 #include "pdf/base/XojPdfExportFactory.h"
 #include "undo/EmergencySaveRestore.h"
@@ -18,6 +21,7 @@
 #include <config-dev.h>
 #include <config-paths.h>
 #include <i18n.h>
+#include <LatencyTrace.h>
 #include <Stacktrace.h>
 #include <StringUtils.h>
 #include <XojMsgBox.h>
@@ -209,7 +213,13 @@ void XournalMain::checkForEmergencySave(Control* control) {
 	gtk_widget_destroy(dialog);
 }
 
-int XournalMain::exportImg(const char* input, const char* output)
+/**
+ * Export the document as image(s)
+ *
+ * @param thumbnailSize If > 0, only the first page is exported as PNG, the longer side
+ *                      of the image is at most thumbnailSize pixels
+ */
+int XournalMain::exportImg(const char* input, const char* output, int thumbnailSize)
 {
 	XOJ_CHECK_TYPE(XournalMain);
 
@@ -237,10 +247,28 @@ int XournalMain::exportImg(const char* input, const char* output)
 	}
 
 	PageRangeVector exportRange;
-	exportRange.push_back(new PageRangeEntry(0, doc->getPageCount() - 1));
+	int pngDpi = 0;
+	if (thumbnailSize > 0 && doc->getPageCount() > 0)
+	{
+		// Used by the thumbnailer if the file contains no preview
+		format = EXPORT_GRAPHICS_PNG;
+		exportRange.push_back(new PageRangeEntry(0, 0));
+
+		PageRef page = doc->getPage(0);
+		double pageSize = MAX(page->getWidth(), page->getHeight());
+		pngDpi = MAX(1, (int) (thumbnailSize * 72.0 / pageSize));
+	}
+	else
+	{
+		exportRange.push_back(new PageRangeEntry(0, doc->getPageCount() - 1));
+	}
 	DummyProgressListener progress;
 
 	ImageExport imgExport(doc, path, format, false, exportRange);
+	if (pngDpi > 0)
+	{
+		imgExport.setPngDpi(pngDpi);
+	}
 	imgExport.exportGraphics(&progress);
 
 	for (PageRangeEntry* e : exportRange)
@@ -308,16 +336,31 @@ int XournalMain::run(int argc, char* argv[])
 	gchar** optFilename = NULL;
 	gchar* pdfFilename = NULL;
 	gchar* imgFilename = NULL;
+	gchar* recordInputFilename = NULL;
+	gchar* replayInputFilename = NULL;
+	gchar* replayReportFilename = NULL;
+	gchar* traceFilename = NULL;
 	int openAtPageNumber = -1;
+	int thumbnailSize = 0;
 
 	string create_pdf = _("PDF output filename");
 	string create_img = _("Image output filename (.png / .svg)");
 	string page_jump = _("Jump to Page (first Page: 1)");
+	string thumbnail_size = _("With --create-img: export only the first page as PNG, at most N pixels wide and high");
 	string audio_folder = _("Absolute path for the audio files playback");
+	string record_input = _("Record the pen input events to this file");
+	string replay_input = _("Replay recorded pen input events without showing the window, report the latency, then quit");
+	string replay_report = _("JSON report file for --replay-input (default: stdout)");
+	string trace = _("Record latency spans and write them as Chrome trace to this file on exit");
 	GOptionEntry options[] = {
 		{ "create-pdf",      'p', 0, G_OPTION_ARG_FILENAME,       &pdfFilename,      create_pdf.c_str(), NULL },
 		{ "create-img",      'i', 0, G_OPTION_ARG_FILENAME,       &imgFilename,      create_img.c_str(), NULL },
 		{ "page",            'n', 0, G_OPTION_ARG_INT,            &openAtPageNumber, page_jump.c_str(), "N" },
+		{ "export-thumbnail-size", 0, 0, G_OPTION_ARG_INT,        &thumbnailSize,    thumbnail_size.c_str(), "N" },
+		{ "record-input",      0, 0, G_OPTION_ARG_FILENAME,       &recordInputFilename, record_input.c_str(), NULL },
+		{ "replay-input",      0, 0, G_OPTION_ARG_FILENAME,       &replayInputFilename, replay_input.c_str(), NULL },
+		{ "replay-report",     0, 0, G_OPTION_ARG_FILENAME,       &replayReportFilename, replay_report.c_str(), NULL },
+		{ "trace",             0, 0, G_OPTION_ARG_FILENAME,       &traceFilename,    trace.c_str(), NULL },
 		{G_OPTION_REMAINING,   0, 0, G_OPTION_ARG_FILENAME_ARRAY, &optFilename,      "<input>", NULL },
 		{NULL}
 	};
@@ -342,7 +385,7 @@ int XournalMain::run(int argc, char* argv[])
 	}
 	if (imgFilename && optFilename && *optFilename)
 	{
-		return exportImg(*optFilename, imgFilename);
+		return exportImg(*optFilename, imgFilename, thumbnailSize);
 	}
 
 	// Checks for input method compatibility
@@ -378,7 +421,11 @@ int XournalMain::run(int argc, char* argv[])
 	MainWindow* win = new MainWindow(gladePath, control);
 	control->initWindow(win);
 
-	win->show(NULL);
+	// The replay is headless, it paints the pages offscreen
+	if (!replayInputFilename)
+	{
+		win->show(NULL);
+	}
 
 	bool opened = false;
 	if (optFilename)
@@ -406,6 +453,11 @@ int XournalMain::run(int argc, char* argv[])
 		}
 	}
 
+	if (traceFilename)
+	{
+		LatencyTrace::setEnabled(true);
+	}
+
 	control->getScheduler()->start();
 
 	if (!opened)
@@ -413,8 +465,47 @@ int XournalMain::run(int argc, char* argv[])
 		control->newFile();
 	}
 
-	checkForErrorlog();
-	checkForEmergencySave(control);
+	if (recordInputFilename)
+	{
+		InputRecorder* recorder = new InputRecorder(control, recordInputFilename);
+		if (recorder->isOpen())
+		{
+			control->setInputRecorder(recorder);
+		}
+		else
+		{
+			g_warning("Could not open input recording file \"%s\"", recordInputFilename);
+			delete recorder;
+		}
+		g_free(recordInputFilename);
+	}
+
+	if (replayInputFilename)
+	{
+		InputReplay* replay = new InputReplay(control, replayInputFilename,
+		                                      replayReportFilename ? replayReportFilename : "");
+		if (replay->load())
+		{
+			control->setInputReplay(replay);
+
+			// Start after the pages are layouted
+			Util::execInUiThread([=]() {
+				replay->start();
+			});
+		}
+		else
+		{
+			g_warning("Could not read input recording \"%s\"", replayInputFilename);
+			delete replay;
+		}
+		g_free(replayInputFilename);
+		g_free(replayReportFilename);
+	}
+	else
+	{
+		checkForErrorlog();
+		checkForEmergencySave(control);
+	}
 
 	// There is a timing issue with the layout
 	// This fixes it, see #405
@@ -430,6 +521,15 @@ int XournalMain::run(int argc, char* argv[])
 
 	control->getScheduler()->stop();
 
+	if (traceFilename)
+	{
+		if (!LatencyTrace::writeChromeTrace(traceFilename))
+		{
+			g_warning("Could not write latency trace \"%s\"", traceFilename);
+		}
+		g_free(traceFilename);
+	}
+
 	delete win;
 	delete control;
 	delete gladePath;
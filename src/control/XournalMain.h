@@ -33,7 +33,7 @@ private:
 	void checkForEmergencySave(Control* control);
 
 	int exportPdf(const char* input, const char* output);
-	int exportImg(const char* input, const char* output);
+	int exportImg(const char* input, const char* output, int thumbnailSize = 0);
 
 	void initSettingsPath();
 	void initResourcePath(GladeSearchpath* gladePath);
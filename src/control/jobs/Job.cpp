@@ -99,3 +99,17 @@ void Job::callAfterRun()
 void Job::afterRun()
 {
 }
+
+void Job::setQueuedTime(gint64 time)
+{
+	XOJ_CHECK_TYPE(Job);
+
+	this->queuedTime = time;
+}
+
+gint64 Job::getQueuedTime()
+{
+	XOJ_CHECK_TYPE(Job);
+
+	return this->queuedTime;
+}
@@ -15,7 +15,7 @@
 
 enum JobType
 {
-	JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE
+	JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE, JOB_TYPE_SEARCH_INDEX
 };
 
 class Job
@@ -54,6 +54,12 @@ public:
 
 	virtual void* getSource();
 
+	/**
+	 * Time when the Job was added to the Scheduler queue, only set if latency tracing is enabled
+	 */
+	void setQueuedTime(gint64 time);
+	gint64 getQueuedTime();
+
 protected:
 	/**
 	 * override this method
@@ -84,4 +90,6 @@ private:
 
 	int refCount = 1;
 	GMutex refMutex;
+
+	gint64 queuedTime = 0;
 };
@@ -1,7 +1,11 @@
 #include "PreviewJob.h"
 
+#include "RenderContext.h"
+
 #include "control/Control.h"
+#include "gui/PageView.h"
 #include "gui/Shadow.h"
+#include "gui/XournalView.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"
 #include "gui/sidebar/previews/layer/SidebarPreviewLayerEntry.h"
@@ -13,6 +17,26 @@ PreviewJob::PreviewJob(SidebarPreviewBaseEntry* sidebar)
  : sidebarPreview(sidebar)
 {
 	XOJ_INIT_TYPE(PreviewJob);
+
+	if (sidebar->getRenderType() != RENDER_TYPE_PAGE_PREVIEW)
+	{
+		return;
+	}
+
+	// The view is looked up here, in the UI thread
+	Control* control = sidebar->sidebar->getControl();
+	MainWindow* win = control->getWindow();
+	if (win == NULL)
+	{
+		return;
+	}
+
+	Document* doc = control->getDocument();
+	doc->lock();
+	size_t pageNr = doc->indexOf(sidebar->page);
+	doc->unlock();
+
+	this->pageView = win->getXournal()->getViewFor(pageNr);
 }
 
 PreviewJob::~PreviewJob()
@@ -38,11 +62,21 @@ JobType PreviewJob::getType()
 	return JOB_TYPE_PREVIEW;
 }
 
+void PreviewJob::removePageView(XojPageView* view)
+{
+	XOJ_CHECK_TYPE(PreviewJob);
+
+	if (this->pageView == view)
+	{
+		this->pageView = NULL;
+	}
+}
+
 void PreviewJob::initGraphics()
 {
-	GtkAllocation alloc;
-	gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
-	crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+	int width = this->sidebarPreview->getWidgetWidth();
+	int height = this->sidebarPreview->getWidgetHeight();
+	crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
 	zoom = this->sidebarPreview->sidebar->getZoom();
 	cr2 = cairo_create(crBuffer);
 }
@@ -68,7 +102,11 @@ void PreviewJob::finishPaint()
 	ref();
 
 	Util::execInUiThread([=]() {
-		gtk_widget_queue_draw(this->sidebarPreview->widget);
+		// The preview may have been detached in the meantime
+		if (this->sidebarPreview->widget)
+		{
+			gtk_widget_queue_draw(this->sidebarPreview->widget);
+		}
 
 		// After the UI job is also done, it can be unreferenced
 		unref();
@@ -87,7 +125,7 @@ void PreviewJob::drawBackgroundPdf(Document* doc)
 
 void PreviewJob::drawPage(int layer)
 {
-	DocumentView view;
+	DocumentView& view = RenderContext::getThreadContext()->getView();
 	PageRef page = this->sidebarPreview->page;
 
 	if (layer == -100)
@@ -115,11 +153,37 @@ void PreviewJob::drawPage(int layer)
 	cairo_destroy(cr2);
 }
 
+/**
+ * Scale the buffer of the main view down, which is much cheaper than
+ * rendering the page and its PDF background again
+ */
+bool PreviewJob::drawFromPageView()
+{
+	if (this->pageView == NULL || !(this->pageView->getPage() == this->sidebarPreview->page))
+	{
+		return false;
+	}
+
+	int offset = Shadow::getShadowTopLeftSize() + 2;
+	int width = this->sidebarPreview->page->getWidth() * zoom;
+	int height = this->sidebarPreview->page->getHeight() * zoom;
+
+	return this->pageView->drawThumbnail(crBuffer, offset, offset, width, height);
+}
+
 void PreviewJob::run()
 {
 	XOJ_CHECK_TYPE(PreviewJob);
 
 	initGraphics();
+
+	if (drawFromPageView())
+	{
+		cairo_destroy(cr2);
+		finishPaint();
+		return;
+	}
+
 	drawBorder();
 
 	Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
@@ -19,6 +19,7 @@
 
 class SidebarPreviewBaseEntry;
 class Document;
+class XojPageView;
 
 /**
  * @brief A Job which renders a SidebarPreviewPage
@@ -38,12 +39,18 @@ public:
 
 	virtual JobType getType();
 
+	/**
+	 * The view is deleted, its buffer cannot be used anymore
+	 */
+	void removePageView(XojPageView* view);
+
 private:
 	void initGraphics();
 	void drawBorder();
 	void finishPaint();
 	void drawBackgroundPdf(Document* doc);
 	void drawPage(int layer);
+	bool drawFromPageView();
 
 private:
 	XOJ_TYPE_ATTRIB;
@@ -67,4 +74,9 @@ private:
 	 * Sidebar preview
 	 */
 	SidebarPreviewBaseEntry* sidebarPreview = NULL;
+
+	/**
+	 * The main view of the page, its rendered buffer is used if it is up to date
+	 */
+	XojPageView* pageView = NULL;
 };
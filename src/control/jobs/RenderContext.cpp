@@ -0,0 +1,130 @@
+#include "RenderContext.h"
+
+#include "view/DocumentView.h"
+
+#include <memory>
+
+/**
+ * Bigger scratch areas get their own surface, which is freed again in endScratch(),
+ * so one big rerender does not keep a page sized buffer in every thread
+ */
+#define RENDER_CONTEXT_MAX_SCRATCH_PIXELS (1024 * 1024)
+
+RenderContext::RenderContext()
+{
+	XOJ_INIT_TYPE(RenderContext);
+
+	this->view = new DocumentView();
+}
+
+RenderContext::~RenderContext()
+{
+	XOJ_CHECK_TYPE(RenderContext);
+
+	delete this->view;
+	this->view = NULL;
+
+	if (this->scratchCr)
+	{
+		cairo_destroy(this->scratchCr);
+		this->scratchCr = NULL;
+	}
+	if (this->scratch)
+	{
+		cairo_surface_destroy(this->scratch);
+		this->scratch = NULL;
+	}
+
+	XOJ_RELEASE_TYPE(RenderContext);
+}
+
+/**
+ * The context is deleted when the thread exits
+ */
+RenderContext* RenderContext::getThreadContext()
+{
+	static thread_local std::unique_ptr<RenderContext> context;
+	if (!context)
+	{
+		context.reset(new RenderContext());
+	}
+	return context.get();
+}
+
+DocumentView& RenderContext::getView()
+{
+	XOJ_CHECK_TYPE(RenderContext);
+
+	this->view->setMarkAudioStroke(false);
+	return *this->view;
+}
+
+cairo_t* RenderContext::beginScratch(int width, int height)
+{
+	XOJ_CHECK_TYPE(RenderContext);
+
+	if ((gint64) width * height > RENDER_CONTEXT_MAX_SCRATCH_PIXELS)
+	{
+		// A new surface is already cleared
+		this->activeScratch = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+		this->activeScratchCr = cairo_create(this->activeScratch);
+		cairo_save(this->activeScratchCr);
+		return this->activeScratchCr;
+	}
+
+	if (width > this->scratchWidth || height > this->scratchHeight)
+	{
+		if (this->scratchCr)
+		{
+			cairo_destroy(this->scratchCr);
+			cairo_surface_destroy(this->scratch);
+		}
+
+		// Grow a bit more, so small changes of the size do not create a new surface
+		this->scratchWidth = MAX(width, this->scratchWidth) + 64;
+		this->scratchHeight = MAX(height, this->scratchHeight) + 64;
+		this->scratch = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->scratchWidth, this->scratchHeight);
+		this->scratchCr = cairo_create(this->scratch);
+	}
+
+	this->activeScratch = this->scratch;
+	this->activeScratchCr = this->scratchCr;
+
+	cairo_t* cr = this->scratchCr;
+	cairo_save(cr);
+	cairo_new_path(cr);
+
+	cairo_rectangle(cr, 0, 0, width, height);
+	cairo_clip(cr);
+
+	cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+	return cr;
+}
+
+void RenderContext::endScratch()
+{
+	XOJ_CHECK_TYPE(RenderContext);
+
+	cairo_new_path(this->activeScratchCr);
+	cairo_restore(this->activeScratchCr);
+
+	if (this->activeScratch != this->scratch)
+	{
+		cairo_destroy(this->activeScratchCr);
+		cairo_surface_destroy(this->activeScratch);
+	}
+
+	this->activeScratch = NULL;
+	this->activeScratchCr = NULL;
+}
+
+cairo_surface_t* RenderContext::getScratchSurface()
+{
+	XOJ_CHECK_TYPE(RenderContext);
+
+	cairo_surface_flush(this->activeScratch);
+	return this->activeScratch;
+}
@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * Drawing state which is reused by all render and preview jobs of one thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <XournalType.h>
+
+#include <gtk/gtk.h>
+
+class DocumentView;
+
+class RenderContext
+{
+private:
+	RenderContext();
+	virtual ~RenderContext();
+
+public:
+	/**
+	 * The context of the calling thread, created on first use
+	 */
+	static RenderContext* getThreadContext();
+
+	/**
+	 * The DocumentView and its background painters, reset to the default settings
+	 */
+	DocumentView& getView();
+
+	/**
+	 * A cleared drawing context of at least width * height pixel, clipped to this size.
+	 * Small surfaces are reused for the next call, big ones are freed, so the result
+	 * has to be copied from getScratchSurface() before endScratch()
+	 */
+	cairo_t* beginScratch(int width, int height);
+	void endScratch();
+
+	/**
+	 * The surface of the current beginScratch() call
+	 */
+	cairo_surface_t* getScratchSurface();
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	DocumentView* view = NULL;
+
+	cairo_surface_t* scratch = NULL;
+	cairo_t* scratchCr = NULL;
+	int scratchWidth = 0;
+	int scratchHeight = 0;
+
+	/**
+	 * The surface between beginScratch() and endScratch(), either scratch or a one-off surface
+	 */
+	cairo_surface_t* activeScratch = NULL;
+	cairo_t* activeScratchCr = NULL;
+};
@@ -1,5 +1,7 @@
 #include "RenderJob.h"
 
+#include "RenderContext.h"
+
 #include "control/Control.h"
 #include "control/ToolHandler.h"
 #include "gui/PageView.h"
@@ -11,6 +13,7 @@
 #include <Rectangle.h>
 #include <Util.h>
 #include <config-features.h>
+#include <LatencyTrace.h>
 
 #include <list>
 
@@ -53,12 +56,12 @@ void RenderJob::rerenderRectangle(Rectangle* rect)
 	int width = rect->width * zoom;
 	int height = rect->height * zoom;
 
-	cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-	cairo_t* crRect = cairo_create(rectBuffer);
+	RenderContext* context = RenderContext::getThreadContext();
+	cairo_t* crRect = context->beginScratch(width, height);
 	cairo_translate(crRect, -x, -y);
 	cairo_scale(crRect, zoom, zoom);
 
-	DocumentView v;
+	DocumentView& v = context->getView();
 	Control* control = view->getXournal()->getControl();
 	v.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
 	v.limitArea(rect->x, rect->y, rect->width, rect->height);
@@ -76,28 +79,28 @@ void RenderJob::rerenderRectangle(Rectangle* rect)
 	v.drawPage(view->page, crRect, false);
 	doc->unlock();
 
-	cairo_destroy(crRect);
-
 	g_mutex_lock(&view->drawingMutex);
 
 	cairo_t * crPageBuffer = cairo_create(view->crBuffer);
 
 	cairo_set_operator(crPageBuffer, CAIRO_OPERATOR_SOURCE);
-	cairo_set_source_surface(crPageBuffer, rectBuffer, x, y);
+	cairo_set_source_surface(crPageBuffer, context->getScratchSurface(), x, y);
 	cairo_rectangle(crPageBuffer, x, y, width, height);
 	cairo_fill(crPageBuffer);
 
 	cairo_destroy(crPageBuffer);
 
-	cairo_surface_destroy(rectBuffer);
-
 	g_mutex_unlock(&view->drawingMutex);
+
+	context->endScratch();
 }
 
 void RenderJob::run()
 {
 	XOJ_CHECK_TYPE(RenderJob);
 
+	LatencySpan span("RenderJob::run");
+
 	double zoom = this->view->xournal->getZoom();
 
 	g_mutex_lock(&this->view->repaintRectMutex);
@@ -138,7 +141,7 @@ void RenderJob::run()
 		}
 
 		Control* control = view->getXournal()->getControl();
-		DocumentView view;
+		DocumentView& view = RenderContext::getThreadContext()->getView();
 		view.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
 		int width = this->view->page->getWidth();
 		int height = this->view->page->getHeight();
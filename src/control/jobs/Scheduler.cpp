@@ -1,5 +1,6 @@
 #include "Scheduler.h"
 #include <config-debug.h>
+#include <LatencyTrace.h>
 
 #include <inttypes.h>
 
@@ -96,6 +97,10 @@ void Scheduler::addJob(Job* job, JobPriority priority)
 	g_mutex_lock(&this->jobQueueMutex);
 
 	job->ref();
+	if (LatencyTrace::isEnabled())
+	{
+		job->setQueuedTime(g_get_monotonic_time());
+	}
 	g_queue_push_tail(this->jobQueue[priority], job);
 	g_cond_broadcast(&this->jobQueueCond);
 
@@ -300,15 +305,30 @@ gpointer Scheduler::jobThreadCallback(Scheduler* scheduler)
 
 		SDEBUG("do job: %" PRId64, (uint64_t) job);
 
+		// Mark the job as running before it can't be found in the queue anymore,
+		// else a source removed in between is not waited for
+		g_mutex_lock(&scheduler->jobRunningMutex);
+
+		scheduler->runningSource = job->getSource();
+		scheduler->runningType = job->getType();
+
 		g_mutex_unlock(&scheduler->jobQueueMutex);
 
-		g_mutex_lock(&scheduler->jobRunningMutex);
+		if (job->getQueuedTime() != 0 && LatencyTrace::isEnabled())
+		{
+			LatencyTrace::addSpan("Scheduler::queueWait", job->getQueuedTime(), g_get_monotonic_time());
+		}
 
 		job->execute();
 
 		job->unref();
 		g_mutex_unlock(&scheduler->jobRunningMutex);
 
+		// Not under jobRunningMutex, removeSource() locks the mutexes the other way round
+		g_mutex_lock(&scheduler->jobQueueMutex);
+		scheduler->runningSource = NULL;
+		g_mutex_unlock(&scheduler->jobQueueMutex);
+
 		// unlock the whole scheduler
 		g_mutex_unlock(&scheduler->schedulerMutex);
 
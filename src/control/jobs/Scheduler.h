@@ -122,6 +122,13 @@ protected:
 	 */
 	GMutex jobRunningMutex;
 
+	/**
+	 * Source and type of the running Job, only written with jobQueueMutex held.
+	 * Only used to compare, the source may already be deleted.
+	 */
+	void* runningSource = NULL;
+	JobType runningType = JOB_TYPE_RENDER;
+
 	GQueue queueUrgent;
 	GQueue queueHigh;
 	GQueue queueLow;
@@ -0,0 +1,41 @@
+#include "SearchIndexJob.h"
+
+#include "control/SearchIndex.h"
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index, size_t pdfPage, int generation)
+ : index(index),
+   pdfPage(pdfPage),
+   generation(generation)
+{
+	XOJ_INIT_TYPE(SearchIndexJob);
+}
+
+SearchIndexJob::~SearchIndexJob()
+{
+	XOJ_CHECK_TYPE(SearchIndexJob);
+
+	this->index = NULL;
+
+	XOJ_RELEASE_TYPE(SearchIndexJob);
+}
+
+void* SearchIndexJob::getSource()
+{
+	XOJ_CHECK_TYPE(SearchIndexJob);
+
+	return this->index;
+}
+
+JobType SearchIndexJob::getType()
+{
+	XOJ_CHECK_TYPE(SearchIndexJob);
+
+	return JOB_TYPE_SEARCH_INDEX;
+}
+
+void SearchIndexJob::run()
+{
+	XOJ_CHECK_TYPE(SearchIndexJob);
+
+	this->index->indexPdfPage(this->pdfPage, this->generation);
+}
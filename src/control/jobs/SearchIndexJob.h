@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * A job which indexes the text of one PDF page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Job.h"
+
+#include <XournalType.h>
+
+class SearchIndex;
+
+class SearchIndexJob : public Job
+{
+public:
+	SearchIndexJob(SearchIndex* index, size_t pdfPage, int generation);
+
+protected:
+	virtual ~SearchIndexJob();
+
+public:
+	virtual void* getSource();
+
+	virtual void run();
+
+	virtual JobType getType();
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	SearchIndex* index = NULL;
+	size_t pdfPage = 0;
+
+	/**
+	 * The job does nothing if the index was cancelled since the job was created
+	 */
+	int generation = 0;
+};
@@ -3,6 +3,25 @@
 #include "PreviewJob.h"
 #include "RenderJob.h"
 
+#include "gui/XournalView.h"
+
+#include <stdlib.h>
+
+/**
+ * Pages rendered ahead per page per second of navigation speed
+ */
+#define PREFETCH_LOOKAHEAD_SECONDS 1.5
+
+/**
+ * Maximum count of pages rendered ahead, a bigger step is a jump and not sequential reading
+ */
+#define PREFETCH_MAX_PAGES 4
+
+/**
+ * If the page was not changed for this time, the reading is started again with speed 0
+ */
+#define PREFETCH_IDLE_SECONDS 10
+
 XournalScheduler::XournalScheduler()
  : Scheduler()
 {
@@ -27,7 +46,27 @@ void XournalScheduler::removePage(XojPageView* view)
 {
 	XOJ_CHECK_TYPE(XournalScheduler);
 
-	removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+	g_mutex_lock(&this->jobQueueMutex);
+
+	removeSourceUnlocked(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+	removeSourceUnlocked(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW);
+
+	// Queued previews may use the buffer of the view, they are cleared before waiting,
+	// so no job can be started with this view after the lock is released
+	int length = g_queue_get_length(this->jobQueue[JOB_PRIORITY_HIGH]);
+	for (int i = 0; i < length; i++)
+	{
+		Job* job = (Job*) g_queue_peek_nth(this->jobQueue[JOB_PRIORITY_HIGH], i);
+		if (job->getType() == JOB_TYPE_PREVIEW)
+		{
+			((PreviewJob*) job)->removePageView(view);
+		}
+	}
+
+	// wait until the running job is done, it may be a render or preview job of this view
+	finishTask();
+
+	g_mutex_unlock(&this->jobQueueMutex);
 }
 
 void XournalScheduler::removeAllJobs()
@@ -71,6 +110,22 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
 
 	g_mutex_lock(&this->jobQueueMutex);
 
+	removeSourceUnlocked(source, type, priority);
+
+	// Only wait if the running job belongs to the source, waiting for
+	// an unrelated job would stall the caller (e.g. scrolling the sidebar)
+	if (this->runningSource == source && this->runningType == type)
+	{
+		finishTask();
+	}
+
+	g_mutex_unlock(&this->jobQueueMutex);
+}
+
+void XournalScheduler::removeSourceUnlocked(void* source, JobType type, JobPriority priority)
+{
+	XOJ_CHECK_TYPE(XournalScheduler);
+
 	int length = g_queue_get_length(this->jobQueue[priority]);
 	for (int i = 0; i < length; i++)
 	{
@@ -87,12 +142,6 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
 			}
 		}
 	}
-
-	// wait until the last job is done
-	// we can be sure we don't access "source"
-	finishTask();
-
-	g_mutex_unlock(&this->jobQueueMutex);
 }
 
 bool XournalScheduler::existsSource(void* source, JobType type, JobPriority priority)
@@ -145,7 +194,129 @@ void XournalScheduler::addRerenderPage(XojPageView* view)
 		return;
 	}
 
+	// The page is needed now, a queued prefetch would only render it again
+	g_mutex_lock(&this->jobQueueMutex);
+
+	int length = g_queue_get_length(this->jobQueue[JOB_PRIORITY_LOW]);
+	for (int i = 0; i < length; i++)
+	{
+		Job* job = (Job*) g_queue_peek_nth(this->jobQueue[JOB_PRIORITY_LOW], i);
+		if (job->getType() == JOB_TYPE_RENDER && job->getSource() == view)
+		{
+			job->deleteJob();
+			g_queue_remove(this->jobQueue[JOB_PRIORITY_LOW], job);
+			job->unref();
+			break;
+		}
+	}
+
+	g_mutex_unlock(&this->jobQueueMutex);
+
 	RenderJob* job = new RenderJob(view);
 	addJob(job, JOB_PRIORITY_URGENT);
 	job->unref();
 }
+
+void XournalScheduler::addPrefetchPage(XojPageView* view)
+{
+	XOJ_CHECK_TYPE(XournalScheduler);
+
+	if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT) || existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW))
+	{
+		return;
+	}
+
+	RenderJob* job = new RenderJob(view);
+	addJob(job, JOB_PRIORITY_LOW);
+	job->unref();
+}
+
+void XournalScheduler::removePrefetchJobs()
+{
+	XOJ_CHECK_TYPE(XournalScheduler);
+
+	g_mutex_lock(&this->jobQueueMutex);
+
+	GQueue* queue = this->jobQueue[JOB_PRIORITY_LOW];
+	for (GList* l = queue->head; l != NULL;)
+	{
+		Job* job = (Job*) l->data;
+		GList* next = l->next;
+
+		if (job->getType() == JOB_TYPE_RENDER)
+		{
+			job->deleteJob();
+			g_queue_delete_link(queue, l);
+			job->unref();
+		}
+
+		l = next;
+	}
+
+	g_mutex_unlock(&this->jobQueueMutex);
+}
+
+void XournalScheduler::prefetchPages(XournalView* xournal, size_t page)
+{
+	XOJ_CHECK_TYPE(XournalScheduler);
+
+	if (page == size_t_npos || page == this->prefetchPage)
+	{
+		return;
+	}
+
+	gint64 now = g_get_monotonic_time();
+
+	if (this->prefetchPage != size_t_npos)
+	{
+		long step = (long) page - (long) this->prefetchPage;
+		int direction = step > 0 ? 1 : -1;
+		double seconds = (now - this->prefetchTime) / (double) G_USEC_PER_SEC;
+
+		if (direction != this->prefetchDirection || labs(step) > PREFETCH_MAX_PAGES)
+		{
+			// The pages in the old direction, or around the old position, are not needed anymore
+			removePrefetchJobs();
+			this->prefetchSpeed = 0;
+		}
+		else if (seconds < PREFETCH_IDLE_SECONDS)
+		{
+			double speed = labs(step) / MAX(seconds, 0.05);
+			this->prefetchSpeed = (this->prefetchSpeed + speed) / 2;
+		}
+		else
+		{
+			this->prefetchSpeed = 0;
+		}
+
+		this->prefetchDirection = direction;
+	}
+
+	this->prefetchPage = page;
+	this->prefetchTime = now;
+
+	int count = MIN(1 + (int) (this->prefetchSpeed * PREFETCH_LOOKAHEAD_SECONDS), PREFETCH_MAX_PAGES);
+
+	// Do not render more than the hidden page buffers kept by XournalView, else the
+	// prefetched pages are freed again before they are shown. The next page is always rendered.
+	int dpiScaleFactor = xournal->getDpiScaleFactor();
+	long pixels = XOURNAL_VIEW_BUFFER_PIXELS;
+
+	for (int i = 1; i <= count; i++)
+	{
+		long p = (long) page + i * this->prefetchDirection;
+		XojPageView* view = p < 0 ? NULL : xournal->getViewFor(p);
+		if (view == NULL)
+		{
+			break;
+		}
+
+		pixels -= (long) view->getDisplayWidth() * view->getDisplayHeight() * dpiScaleFactor * dpiScaleFactor;
+		if (pixels < 0 && i > 1)
+		{
+			break;
+		}
+
+		view->prefetchPage();
+	}
+}
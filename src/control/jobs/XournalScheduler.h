@@ -17,8 +17,11 @@
 #include "gui/sidebar/previews/page/SidebarPreviewPageEntry.h"
 #include "gui/PageView.h"
 
+#include <Util.h>
 #include <XournalType.h>
 
+class XournalView;
+
 class XournalScheduler : public Scheduler
 {
 public:
@@ -27,7 +30,8 @@ public:
 
 public:
 	/**
-	 * Remove source, e.g. if a page is removed they don't need to repaint
+	 * Remove source, e.g. if a page is removed they don't need to repaint.
+	 * Blocks only if a job of this source is currently running.
 	 */
 	void removeSidebar(SidebarPreviewBaseEntry* preview);
 	void removePage(XojPageView* view);
@@ -40,6 +44,23 @@ public:
 	void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
 	void addRerenderPage(XojPageView* view);
 
+	/**
+	 * Render a page which is not yet visible, with low priority
+	 */
+	void addPrefetchPage(XojPageView* view);
+
+	/**
+	 * Called if the current page changed, predicts the direction and the speed of the
+	 * navigation and renders the next pages in this direction before they are shown.
+	 * The queued pages are dropped if the direction changes.
+	 */
+	void prefetchPages(XournalView* xournal, size_t page);
+
+	/**
+	 * Remove all queued prefetch jobs, a running job is not waited for
+	 */
+	void removePrefetchJobs();
+
 	/**
 	 * Blocks until all currently running Job%s have been executed
 	 */
@@ -47,12 +68,34 @@ public:
 
 private:
 	/**
-	 * Remove source, e.g. if a page is removed they don't need to repaint
+	 * Remove source, e.g. if a page is removed they don't need to repaint.
+	 * Blocks only if a job of this source is currently running.
 	 */
 	void removeSource(void* source, JobType type, JobPriority priority);
 
+	/**
+	 * Remove a queued job of the source, the caller holds jobQueueMutex
+	 */
+	void removeSourceUnlocked(void* source, JobType type, JobPriority priority);
+
 	bool existsSource(void* source, JobType type, JobPriority priority);
 
 private:
 	XOJ_TYPE_ATTRIB;
+
+	/**
+	 * The page of the last prefetchPages() call, and when it was called (monotonic, µs)
+	 */
+	size_t prefetchPage = size_t_npos;
+	gint64 prefetchTime = 0;
+
+	/**
+	 * 1 forward, -1 backward
+	 */
+	int prefetchDirection = 1;
+
+	/**
+	 * Estimated pages per second
+	 */
+	double prefetchSpeed = 0;
 };
@@ -88,6 +88,8 @@ void Settings::loadDefault()
 	this->autosaveTimeout = 3;
 	this->autosaveEnabled = true;
 
+	this->undoMemoryBudget = 256;
+
 	this->addHorizontalSpace = false;
 	this->addHorizontalSpaceAmount = 150;
 	this->addVerticalSpace = false;
@@ -462,6 +464,10 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur)
 	{
 		this->autosaveTimeout = g_ascii_strtoll((const char*) value, NULL, 10);
 	}
+	else if (xmlStrcmp(name, (const xmlChar*) "undoMemoryBudget") == 0)
+	{
+		this->undoMemoryBudget = g_ascii_strtoll((const char*) value, NULL, 10);
+	}
 	else if (xmlStrcmp(name, (const xmlChar*) "fullscreenHideElements") == 0)
 	{
 		this->fullscreenHideElements = (const char*) value;
@@ -932,6 +938,9 @@ void Settings::save()
 	WRITE_BOOL_PROP(autosaveEnabled);
 	WRITE_INT_PROP(autosaveTimeout);
 
+	WRITE_INT_PROP(undoMemoryBudget);
+	WRITE_COMMENT("Memory in MB for erased and deleted strokes in the undo history, older ones are moved to a temporary file");
+
 	WRITE_BOOL_PROP(addHorizontalSpace);
 	WRITE_INT_PROP(addHorizontalSpaceAmount);	
 	WRITE_BOOL_PROP(addVerticalSpace);
@@ -1189,6 +1198,27 @@ void Settings::setAutosaveTimeout(int autosave)
 	save();
 }
 
+int Settings::getUndoMemoryBudget()
+{
+	XOJ_CHECK_TYPE(Settings);
+
+	return this->undoMemoryBudget;
+}
+
+void Settings::setUndoMemoryBudget(int budget)
+{
+	XOJ_CHECK_TYPE(Settings);
+
+	if (this->undoMemoryBudget == budget)
+	{
+		return;
+	}
+
+	this->undoMemoryBudget = budget;
+
+	save();
+}
+
 bool Settings::isAutosaveEnabled()
 {
 	XOJ_CHECK_TYPE(Settings);
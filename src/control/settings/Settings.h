@@ -270,6 +270,9 @@ public:
 	bool isAutosaveEnabled();
 	void setAutosaveEnabled(bool autosave);
 
+	int getUndoMemoryBudget();
+	void setUndoMemoryBudget(int budget);
+
 	bool getAddVerticalSpace();
 	void setAddVerticalSpace(bool space);
 	int  getAddVerticalSpaceAmount();
@@ -643,6 +646,12 @@ private:
 	 */
 	bool autosaveEnabled;
 
+	/**
+	 * Memory in MB for strokes which are only referenced by the undo history,
+	 * older strokes are written to a temporary file
+	 */
+	int undoMemoryBudget;
+
 	/**
 	 * Allow scroll outside the page display area (horizontal)
 	 */
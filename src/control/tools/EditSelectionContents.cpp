@@ -26,6 +26,12 @@
 #include <serializing/ObjectInputStream.h>
 
 #include <cmath>
+#include <thread>
+
+/**
+ * Selections with more points are transformed on multiple threads
+ */
+#define SELECTION_PARALLEL_TRANSFORM_POINTS 100000
 
 EditSelectionContents::EditSelectionContents(double x, double y, double width, double height,
 											 PageRef sourcePage, Layer* sourceLayer, XojPageView* sourceView)
@@ -410,8 +416,44 @@ void EditSelectionContents::finalizeSelection(double x, double y, double width,
 
 	bool move = mx != 0 || my != 0;
 
+	// All strokes get the same affine transformation, applied in one pass
+	cairo_matrix_t matrix;
+	cairo_matrix_init_translate(&matrix, mx, my);
+	double widthFactor = 1;
+
+	if (scale)
+	{
+		cairo_matrix_t m;
+		cairo_matrix_init_translate(&m, x, y);
+		cairo_matrix_scale(&m, fx, fy);
+		cairo_matrix_translate(&m, -x, -y);
+		cairo_matrix_multiply(&matrix, &matrix, &m);
+
+		widthFactor = sqrt(fx * fy);
+	}
+	if (rotate)
+	{
+		// The same center as Stroke::rotate
+		double cx = x + this->lastWidth / 2 - STROKE_ROTATE_OFFSET;
+		double cy = y + this->lastHeight / 2 - STROKE_ROTATE_OFFSET;
+
+		cairo_matrix_t m;
+		cairo_matrix_init_translate(&m, cx, cy);
+		cairo_matrix_rotate(&m, this->rotation);
+		cairo_matrix_translate(&m, -cx, -cy);
+		cairo_matrix_multiply(&matrix, &matrix, &m);
+	}
+
+	vector<Stroke*> strokes;
+
 	for (Element* e : this->selected)
 	{
+		if (e->getType() == ELEMENT_STROKE)
+		{
+			strokes.push_back((Stroke*) e);
+			continue;
+		}
+
 		if (move)
 		{
 			e->move(mx, my);
@@ -424,9 +466,69 @@ void EditSelectionContents::finalizeSelection(double x, double y, double width,
 		{
 			e->rotate(x, y, this->lastWidth / 2, this->lastHeight / 2, this->rotation);
 		}
+	}
+
+	if (move || scale || rotate)
+	{
+		transformStrokes(strokes, matrix, widthFactor);
+	}
+
+	for (Element* e : this->selected)
+	{
 		layer->addElement(e);
 	}
+}
 
+/**
+ * Transform all strokes, large selections are split over all processors
+ */
+void EditSelectionContents::transformStrokes(vector<Stroke*>& strokes, const cairo_matrix_t& matrix, double widthFactor)
+{
+	size_t points = 0;
+	for (Stroke* s : strokes)
+	{
+		points += s->getPointCount();
+	}
+
+	size_t threads = MIN((size_t) g_get_num_processors(), points / SELECTION_PARALLEL_TRANSFORM_POINTS + 1);
+	if (threads <= 1)
+	{
+		for (Stroke* s : strokes)
+		{
+			s->transform(matrix, widthFactor);
+		}
+		return;
+	}
+
+	// Split into ranges with about the same count of points
+	vector<std::thread> workers;
+	size_t pointsPerThread = points / threads + 1;
+	size_t first = 0;
+	while (first < strokes.size())
+	{
+		size_t last = first;
+		size_t rangePoints = 0;
+		while (last < strokes.size() && rangePoints < pointsPerThread)
+		{
+			rangePoints += strokes[last]->getPointCount();
+			last++;
+		}
+
+		workers.emplace_back([&strokes, &matrix, widthFactor, first, last]()
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				strokes[i]->transform(matrix, widthFactor);
+			}
+		});
+
+		first = last;
+	}
+
+	for (std::thread& t : workers)
+	{
+		t.join();
+	}
 }
 
 double EditSelectionContents::getOriginalX()
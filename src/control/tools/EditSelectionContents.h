@@ -29,6 +29,7 @@ class Element;
 class UndoAction;
 class EditSelectionContents;
 class DeleteUndoAction;
+class Stroke;
 
 class EditSelectionContents : public ElementContainer, public Serializeable
 {
@@ -107,6 +108,11 @@ private:
 	 */
 	static bool repaintSelection(EditSelectionContents* selection);
 
+	/**
+	 * Apply the transformation of the selection to all strokes in one pass
+	 */
+	static void transformStrokes(vector<Stroke*>& strokes, const cairo_matrix_t& matrix, double widthFactor);
+
 public:
 	
 	/**
@@ -6,6 +6,7 @@
 #include "gui/XournalView.h"
 #include "model/Document.h"
 #include "model/eraser/EraseableStroke.h"
+#include "model/eraser/EraserCapsule.h"
 #include "model/Layer.h"
 #include "model/Stroke.h"
 #include "undo/EraseUndoAction.h"
@@ -53,11 +54,25 @@ void EraseHandler::erase(double x, double y)
 	XOJ_CHECK_TYPE(EraseHandler);
 
 	this->halfEraserSize = this->handler->getThickness();
+
+	// Erase everything between the last and the current position, fast
+	// movements would leave gaps otherwise
+	if (!this->hasLastPosition)
+	{
+		this->lastX = x;
+		this->lastY = y;
+		this->hasLastPosition = true;
+	}
+
+	EraserCapsule capsule(this->lastX, this->lastY, x, y, halfEraserSize);
+	this->lastX = x;
+	this->lastY = y;
+
 	GdkRectangle eraserRect = {
-		gint(x - halfEraserSize),
-		gint(y - halfEraserSize),
-		gint(halfEraserSize * 2),
-		gint(halfEraserSize * 2)
+		gint(capsule.getX()),
+		gint(capsule.getY()),
+		gint(capsule.getX2() - capsule.getX()) + 1,
+		gint(capsule.getY2() - capsule.getY()) + 1
 	};
 
 	Range* range = new Range(x, y);
@@ -69,7 +84,7 @@ void EraseHandler::erase(double x, double y)
 	{
 		if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect))
 		{
-			eraseStroke(l, (Stroke*) e, x, y, range);
+			eraseStroke(l, (Stroke*) e, capsule, range);
 		}
 	}
 
@@ -77,11 +92,11 @@ void EraseHandler::erase(double x, double y)
 	delete range;
 }
 
-void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range)
+void EraseHandler::eraseStroke(Layer* l, Stroke* s, const EraserCapsule& capsule, Range* range)
 {
 	XOJ_CHECK_TYPE(EraseHandler);
 
-	if (!s->intersects(x, y, halfEraserSize))
+	if (!s->intersects(capsule))
 	{
 		return;
 	}
@@ -139,7 +154,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
 			eraseable = s->getEraseable();
 		}
 
-		eraseable->erase(x, y, halfEraserSize, range);
+		eraseable->erase(capsule, range);
 	}
 }
 
@@ -147,6 +162,8 @@ void EraseHandler::finalize()
 {
 	XOJ_CHECK_TYPE(EraseHandler);
 
+	this->hasLastPosition = false;
+
 	if (this->eraseUndoAction)
 	{
 		this->eraseUndoAction->finalize();
@@ -18,6 +18,7 @@
 class DeleteUndoAction;
 class Document;
 class EraseUndoAction;
+class EraserCapsule;
 class Layer;
 class Range;
 class Redrawable;
@@ -36,7 +37,7 @@ public:
 	void finalize();
 
 private:
-	void eraseStroke(Layer* l, Stroke* s, double x, double y, Range* range);
+	void eraseStroke(Layer* l, Stroke* s, const EraserCapsule& capsule, Range* range);
 
 private:
 	XOJ_TYPE_ATTRIB;
@@ -52,4 +53,11 @@ private:
 	EraseUndoAction* eraseUndoAction;
 
 	double halfEraserSize;
+
+	/**
+	 * The last eraser position, the area swept since then is erased
+	 */
+	bool hasLastPosition = false;
+	double lastX = 0;
+	double lastY = 0;
 };
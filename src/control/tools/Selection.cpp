@@ -3,6 +3,8 @@
 #include "model/Layer.h"
 #include "util/GtkColorWrapper.h"
 
+#include <cmath>
+
 Selection::Selection(Redrawable* view)
 {
 	XOJ_INIT_TYPE(Selection);
@@ -140,37 +142,20 @@ void RectSelection::paint(cairo_t* cr, GdkRectangle* rect, double zoom)
 
 //////////////////////////////////////////////////////////
 
-class RegionPoint
-{
-public:
-	RegionPoint(double x, double y)
-	{
-		this->x = x;
-		this->y = y;
-	}
-
-	double x;
-	double y;
-};
+/**
+ * Cells of the lasso grid on the longer side of the bounding box
+ */
+#define REGION_SELECT_GRID_SIZE 128
 
 RegionSelect::RegionSelect(double x, double y, Redrawable* view) : Selection(view)
 {
 	XOJ_INIT_TYPE(RegionSelect);
 
-	this->points = NULL;
 	currentPos(x, y);
 }
 
 RegionSelect::~RegionSelect()
 {
-	XOJ_CHECK_TYPE(RegionSelect);
-
-	for (GList* l = this->points; l != NULL; l = l->next)
-	{
-		delete (RegionPoint*) l->data;
-	}
-	g_list_free(this->points);
-
 	XOJ_RELEASE_TYPE(RegionSelect);
 }
 
@@ -179,7 +164,7 @@ void RegionSelect::paint(cairo_t* cr, GdkRectangle* rect, double zoom)
 	XOJ_CHECK_TYPE(RegionSelect);
 
 	// at least three points needed
-	if (this->points && this->points->next && this->points->next->next)
+	if (this->points.size() >= 3)
 	{
 		GtkColorWrapper selectionColor = view->getSelectionColor();
 
@@ -187,16 +172,16 @@ void RegionSelect::paint(cairo_t* cr, GdkRectangle* rect, double zoom)
 		cairo_set_line_width(cr, 1 / zoom);
 		selectionColor.apply(cr);
 
-		RegionPoint* r0 = (RegionPoint*) this->points->data;
-		cairo_move_to(cr, r0->x, r0->y);
+		RegionPoint& r0 = this->points.front();
+		cairo_move_to(cr, r0.x, r0.y);
 
-		for (GList* l = this->points->next; l != NULL; l = l->next)
+		for (size_t i = 1; i < this->points.size(); i++)
 		{
-			RegionPoint* r = (RegionPoint*) l->data;
-			cairo_line_to(cr, r->x, r->y);
+			RegionPoint& r = this->points[i];
+			cairo_line_to(cr, r.x, r.y);
 		}
 
-		cairo_line_to(cr, r0->x, r0->y);
+		cairo_line_to(cr, r0.x, r0.y);
 
 		cairo_stroke_preserve(cr);
 		selectionColor.applyWithAlpha(cr, 0.3);
@@ -208,36 +193,34 @@ void RegionSelect::currentPos(double x, double y)
 {
 	XOJ_CHECK_TYPE(RegionSelect);
 
-	this->points = g_list_append(this->points, new RegionPoint(x, y));
+	this->points.push_back(RegionPoint(x, y));
 
 	// at least three points needed
-	if (this->points && this->points->next && this->points->next->next)
+	if (this->points.size() >= 3)
 	{
+		RegionPoint& r0 = this->points.front();
+		double ax = r0.x;
+		double bx = r0.x;
+		double ay = r0.y;
+		double by = r0.y;
 
-		RegionPoint* r0 = (RegionPoint*) this->points->data;
-		double ax = r0->x;
-		double bx = r0->x;
-		double ay = r0->y;
-		double by = r0->y;
-
-		for (GList* l = this->points; l != NULL; l = l->next)
+		for (RegionPoint& r : this->points)
 		{
-			RegionPoint* r = (RegionPoint*) l->data;
-			if (ax > r->x)
+			if (ax > r.x)
 			{
-				ax = r->x;
+				ax = r.x;
 			}
-			if (bx < r->x)
+			if (bx < r.x)
 			{
-				bx = r->x;
+				bx = r.x;
 			}
-			if (ay > r->y)
+			if (ay > r.y)
 			{
-				ay = r->y;
+				ay = r.y;
 			}
-			if (by < r->y)
+			if (by < r.y)
 			{
-				by = r->y;
+				by = r.y;
 			}
 		}
 
@@ -245,6 +228,22 @@ void RegionSelect::currentPos(double x, double y)
 	}
 }
 
+int RegionSelect::getGridRow(double y)
+{
+	XOJ_CHECK_TYPE(RegionSelect);
+
+	int row = (int) ((y - this->y1Box) / this->cellSize);
+	return MAX(0, MIN(row, this->gridHeight - 1));
+}
+
+int RegionSelect::getGridColumn(double x)
+{
+	XOJ_CHECK_TYPE(RegionSelect);
+
+	int column = (int) ((x - this->x1Box) / this->cellSize);
+	return MAX(0, MIN(column, this->gridWidth - 1));
+}
+
 bool RegionSelect::contains(double x, double y)
 {
 	XOJ_CHECK_TYPE(RegionSelect);
@@ -257,25 +256,41 @@ bool RegionSelect::contains(double x, double y)
 	{
 		return false;
 	}
-	if (this->points == NULL || this->points->next == NULL)
+	if (this->cells.empty())
 	{
 		return false;
 	}
 
-	int hits = 0;
+	int row = getGridRow(y);
+	guint8 cell = this->cells[row * this->gridWidth + getGridColumn(x)];
+	if (cell == REGION_CELL_BOUNDARY)
+	{
+		return containsExact(x, y, this->rowEdges[row]);
+	}
+
+	return cell == REGION_CELL_INSIDE;
+}
 
-	RegionPoint* last = (RegionPoint*) g_list_last(this->points)->data;
+/**
+ * Crossing number test, only with the given edges, all edges which
+ * cross the horizontal line through y have to be in the list
+ */
+bool RegionSelect::containsExact(double x, double y, const vector<int>& edges)
+{
+	XOJ_CHECK_TYPE(RegionSelect);
 
-	double lastx = last->x;
-	double lasty = last->y;
-	double curx, cury;
+	int hits = 0;
+	int count = (int) this->points.size();
 
-	// Walk the edges of the polygon
-	for (GList* l = this->points; l != NULL; lastx = curx, lasty = cury, l = l->next)
+	for (int i : edges)
 	{
-		RegionPoint* last = (RegionPoint*) l->data;
-		curx = last->x;
-		cury = last->y;
+		RegionPoint& last = this->points[(i + count - 1) % count];
+		RegionPoint& cur = this->points[i];
+
+		double lastx = last.x;
+		double lasty = last.y;
+		double curx = cur.x;
+		double cury = cur.y;
 
 		if (cury == lasty)
 		{
@@ -339,43 +354,127 @@ bool RegionSelect::contains(double x, double y)
 	return (hits & 1) != 0;
 }
 
-bool RegionSelect::finalize(PageRef page)
+/**
+ * Rasterize the lasso: cells crossed by an edge are boundary cells, all other
+ * cells are completely inside or outside. Consecutive non boundary cells of a
+ * row have the same state, so only one exact test per run is needed.
+ */
+void RegionSelect::buildGrid()
 {
 	XOJ_CHECK_TYPE(RegionSelect);
 
-	this->page = page;
+	double width = this->x2Box - this->x1Box;
+	double height = this->y2Box - this->y1Box;
 
-	this->x1Box = 0;
-	this->x2Box = 0;
-	this->y1Box = 0;
-	this->y2Box = 0;
+	this->cellSize = MAX(width, height) / REGION_SELECT_GRID_SIZE;
+	if (this->cellSize <= 0)
+	{
+		this->cellSize = 1;
+	}
+
+	this->gridWidth = MAX(1, (int) std::ceil(width / this->cellSize));
+	this->gridHeight = MAX(1, (int) std::ceil(height / this->cellSize));
+	this->cells.assign(this->gridWidth * this->gridHeight, REGION_CELL_OUTSIDE);
+	this->rowEdges.assign(this->gridHeight, vector<int>());
+
+	// Small margin, so rounding never misses a cell an edge touches
+	double eps = this->cellSize * 1e-6;
+	int count = (int) this->points.size();
 
-	for (GList* l = this->points; l != NULL; l = l->next)
+	for (int i = 0; i < count; i++)
 	{
-		RegionPoint* p = (RegionPoint*) l->data;
+		RegionPoint& a = this->points[(i + count - 1) % count];
+		RegionPoint& b = this->points[i];
 
-		if (p->x < this->x1Box)
-		{
-			this->x1Box = p->x;
-		}
-		else if (p->x > this->x2Box)
-		{
-			this->x2Box = p->x;
-		}
+		int row1 = getGridRow(MIN(a.y, b.y) - eps);
+		int row2 = getGridRow(MAX(a.y, b.y) + eps);
 
-		if (p->y < this->y1Box)
+		for (int row = row1; row <= row2; row++)
 		{
-			this->y1Box = p->y;
+			this->rowEdges[row].push_back(i);
+
+			// The part of the edge within this row
+			double xa = a.x;
+			double xb = b.x;
+			if (a.y != b.y)
+			{
+				double top = this->y1Box + row * this->cellSize;
+				double ta = (top - a.y) / (b.y - a.y);
+				double tb = (top + this->cellSize - a.y) / (b.y - a.y);
+				ta = MAX(0.0, MIN(1.0, ta));
+				tb = MAX(0.0, MIN(1.0, tb));
+				xa = a.x + (b.x - a.x) * ta;
+				xb = a.x + (b.x - a.x) * tb;
+			}
+
+			int column1 = getGridColumn(MIN(xa, xb) - eps);
+			int column2 = getGridColumn(MAX(xa, xb) + eps);
+			for (int column = column1; column <= column2; column++)
+			{
+				this->cells[row * this->gridWidth + column] = REGION_CELL_BOUNDARY;
+			}
 		}
-		else if (p->y > this->y2Box)
+	}
+
+	for (int row = 0; row < this->gridHeight; row++)
+	{
+		guint8* rowCells = &this->cells[row * this->gridWidth];
+		double y = this->y1Box + (row + 0.5) * this->cellSize;
+
+		for (int column = 0; column < this->gridWidth; column++)
 		{
-			this->y2Box = p->y;
+			if (rowCells[column] == REGION_CELL_BOUNDARY)
+			{
+				continue;
+			}
+
+			if (column > 0 && rowCells[column - 1] != REGION_CELL_BOUNDARY)
+			{
+				rowCells[column] = rowCells[column - 1];
+				continue;
+			}
+
+			double x = this->x1Box + (column + 0.5) * this->cellSize;
+			rowCells[column] = containsExact(x, y, this->rowEdges[row]) ? REGION_CELL_INSIDE : REGION_CELL_OUTSIDE;
 		}
 	}
+}
+
+bool RegionSelect::finalize(PageRef page)
+{
+	XOJ_CHECK_TYPE(RegionSelect);
+
+	this->page = page;
+
+	RegionPoint& r0 = this->points.front();
+	this->x1Box = r0.x;
+	this->x2Box = r0.x;
+	this->y1Box = r0.y;
+	this->y2Box = r0.y;
+
+	for (RegionPoint& p : this->points)
+	{
+		this->x1Box = MIN(this->x1Box, p.x);
+		this->x2Box = MAX(this->x2Box, p.x);
+		this->y1Box = MIN(this->y1Box, p.y);
+		this->y2Box = MAX(this->y2Box, p.y);
+	}
+
+	if (this->points.size() >= 2)
+	{
+		buildGrid();
+	}
 
 	Layer* l = page->getSelectedLayer();
 	for (Element* e : *l->getElements())
 	{
+		// Elements which don't touch the bounding box cannot be within the lasso
+		if (e->getX() > this->x2Box || e->getX() + e->getElementWidth() < this->x1Box ||
+		    e->getY() > this->y2Box || e->getY() + e->getElementHeight() < this->y1Box)
+		{
+			continue;
+		}
+
 		if (e->isInSelection(this))
 		{
 			this->selectedElements.push_back(e);
@@ -18,6 +18,9 @@
 #include <Util.h>
 #include <XournalType.h>
 
+#include <vector>
+using std::vector;
+
 class Selection : public ShapeContainer
 {
 public:
@@ -74,6 +77,33 @@ private:
 	double y2;
 };
 
+class RegionPoint
+{
+public:
+	RegionPoint(double x, double y)
+	{
+		this->x = x;
+		this->y = y;
+	}
+
+	double x;
+	double y;
+};
+
+/**
+ * State of a cell of the rasterized lasso
+ */
+enum RegionCell
+{
+	REGION_CELL_OUTSIDE = 0,
+	REGION_CELL_INSIDE,
+
+	/**
+	 * An edge of the lasso passes this cell, the exact test is needed
+	 */
+	REGION_CELL_BOUNDARY
+};
+
 class RegionSelect : public Selection
 {
 public:
@@ -86,8 +116,29 @@ public:
 	virtual void currentPos(double x, double y);
 	virtual bool contains(double x, double y);
 
+private:
+	void buildGrid();
+	int getGridRow(double y);
+	int getGridColumn(double x);
+	bool containsExact(double x, double y, const vector<int>& edges);
+
 private:
 	XOJ_TYPE_ATTRIB;
 
-	GList* points;
+	vector<RegionPoint> points;
+
+	/**
+	 * The lasso rasterized to a coarse grid over the bounding box,
+	 * built in finalize
+	 */
+	vector<guint8> cells;
+	int gridWidth = 0;
+	int gridHeight = 0;
+	double cellSize = 1;
+
+	/**
+	 * The edges which cross each grid row, edge i goes from
+	 * point i - 1 to point i (the first from the last point)
+	 */
+	vector<vector<int>> rowEdges;
 };
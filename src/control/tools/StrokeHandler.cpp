@@ -10,6 +10,7 @@
 #include "control/settings/Settings.h"
 
 #include <config-features.h>
+#include <LatencyTrace.h>
 
 #include <gdk/gdk.h>
 #include <cmath>
@@ -22,8 +23,6 @@ guint32 StrokeHandler::lastStrokeTime;		//persist for next stroke
 
 StrokeHandler::StrokeHandler(XournalView* xournal, XojPageView* redrawable, PageRef page)
  : InputHandler(xournal, redrawable, page),
-   surfMask(NULL),
-   crMask(NULL),
    reco(NULL)
 {
 	XOJ_INIT_TYPE(StrokeHandler);
@@ -33,7 +32,14 @@ StrokeHandler::~StrokeHandler()
 {
 	XOJ_CHECK_TYPE(StrokeHandler);
 
-	destroySurface();
+	if (this->frameClock)
+	{
+		g_signal_handler_disconnect(this->frameClock, this->frameUpdateHandler);
+		this->frameClock = NULL;
+	}
+
+	restoreEventCompression();
+
 	delete reco;
 	reco = NULL;
 
@@ -49,16 +55,7 @@ void StrokeHandler::draw(cairo_t* cr)
 		return;
 	}
 
-	view.applyColor(cr, stroke);
-
-	if (stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER) {
-	  cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
-	}
-	else {
-	  cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
-	}
-
-	cairo_mask_surface(cr, surfMask, 0, 0);
+	liveView.paint(cr);
 }
 
 
@@ -72,6 +69,8 @@ bool StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos)
 {
 	XOJ_CHECK_TYPE(StrokeHandler);
 
+	LatencySpan span("StrokeHandler::onMotionNotifyEvent");
+
 	if (!stroke)
 	{
 		return false;
@@ -99,57 +98,61 @@ bool StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos)
 
 	stroke->addPoint(currentPoint);
 
-	if ((stroke->getFill() != -1 || stroke->getLineStyle().hasDashes())
-			&& !(stroke->getFill() != -1 && stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER))
+	// The mask is updated once per frame, with all points received until then
+	if (this->frameClock)
 	{
-		// Clear surface
-
-		// for debugging purposes
-		// cairo_set_source_rgba(crMask, 1, 0, 0, 1);
-		cairo_set_source_rgba(crMask, 0, 0, 0, 0);
-		cairo_rectangle(crMask, 0, 0, cairo_image_surface_get_width(surfMask), cairo_image_surface_get_height(surfMask));
-		cairo_fill(crMask);
-
-		view.drawStroke(crMask, stroke, 0, 1, true, true);
+		gdk_frame_clock_request_phase(this->frameClock, GDK_FRAME_CLOCK_PHASE_UPDATE);
 	}
 	else
 	{
-		if (pointCount > 0)
-		{
-			Point prevPoint(stroke->getPoint(pointCount - 1));
-
-			Stroke lastSegment;
+		drawNewPoints();
+	}
 
-			lastSegment.addPoint(prevPoint);
-			lastSegment.addPoint(currentPoint);
-			lastSegment.setWidth(stroke->getWidth());
+	return true;
+}
 
-			cairo_set_operator(crMask, CAIRO_OPERATOR_OVER);
-			cairo_set_source_rgba(crMask, 1, 1, 1, 1);
+/**
+ * Draw the points added since the last frame and repaint only their area
+ */
+void StrokeHandler::drawNewPoints()
+{
+	XOJ_CHECK_TYPE(StrokeHandler);
 
-			view.drawStroke(crMask, &lastSegment, 0, 1, false);
-		}
+	if (!stroke)
+	{
+		return;
 	}
 
-	const double w = stroke->getWidth();
+	Point last = stroke->getPoint(stroke->getPointCount() - 1);
+	Range damage(last.x, last.y);
+
+	if (liveView.drawNewSegments(damage))
+	{
+		this->redrawable->repaintRange(damage);
+	}
+}
 
-	this->redrawable->repaintRect(stroke->getX() - w,
-	                              stroke->getY() - w,
-	                              stroke->getElementWidth() + 2*w,
-	                              stroke->getElementHeight() + 2*w);
+void StrokeHandler::frameUpdateCallback(GdkFrameClock* clock, StrokeHandler* handler)
+{
+	XOJ_CHECK_TYPE_OBJ(handler, StrokeHandler);
 
-	return true;
+	handler->drawNewPoints();
 }
 
 void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos)
 {
 	XOJ_CHECK_TYPE(StrokeHandler);
 
+	restoreEventCompression();
+
 	if (!stroke)
 	{
 		return;
 	}
 
+	// Points which were not drawn yet in a frame
+	drawNewPoints();
+
 	Control* control = xournal->getControl();
 	Settings* settings = control->getSettings();
 	int pointCount = stroke->getPointCount();
@@ -167,6 +170,7 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos)
 				//stroke not being added to layer... delete here.
 				this->redrawable->rerenderRect(stroke->getX(), stroke->getY(), stroke->getElementWidth(), stroke->getElementHeight() ); // clear onMotionNotifyEvent drawing //!
 
+				liveView.destroy();
 				delete stroke;
 				stroke = NULL;
 				if( pointCount <4) //limit to filtered 'dots' only.  //!
@@ -223,19 +227,13 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos)
 			// Full repaint is done anyway
 			// So repaint don't need to be done here
 
+			liveView.destroy();
 			stroke = NULL;
 			return;
 		}
 	}
 
-	if (stroke->getFill() != -1 && stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER)
-	{
-		// The stroke is not filled on drawing time
-		// If the stroke has fill values, it needs to be re-rendered
-		// else the fill will not be visible.
-
-		view.drawStroke(crMask, stroke, 0, 1, true, true);
-	}
+	liveView.finish();
 
 	layer->addElement(stroke);
 	page->fireElementChanged(stroke);
@@ -290,8 +288,6 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos)
 {
 	XOJ_CHECK_TYPE(StrokeHandler);
 
-	destroySurface();
-
 	double zoom = xournal->getZoom();
 	PageRef page = redrawable->getPage();
 
@@ -300,19 +296,6 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos)
 	double width = page->getWidth() * zoom * dpiScaleFactor;
 	double height = page->getHeight() * zoom * dpiScaleFactor;
 
-	surfMask = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
-
-	crMask = cairo_create(surfMask);
-
-	// for debugging purposes
-	// cairo_set_source_rgba(crMask, 0, 0, 0, 1);
-	cairo_set_source_rgba(crMask, 0, 0, 0, 0);
-	cairo_rectangle(crMask, 0, 0, width, height);
-
-	cairo_fill(crMask);
-
-	cairo_scale(crMask, zoom * dpiScaleFactor, zoom * dpiScaleFactor);
-
 	if (!stroke)
 	{
 		double x = pos.x / zoom;
@@ -320,20 +303,42 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos)
 
 		createStroke(Point(x, y));
 	}
+
+	liveView.start(stroke, width, height, zoom * dpiScaleFactor);
+
+	GtkWidget* widget = xournal->getWidget();
+	if (this->frameClock == NULL && gtk_widget_get_frame_clock(widget))
+	{
+		this->frameClock = gtk_widget_get_frame_clock(widget);
+		this->frameUpdateHandler = g_signal_connect(this->frameClock, "update", G_CALLBACK(frameUpdateCallback), this);
+	}
+
+	// Receive all motion events, not only the last of each frame
+	GdkWindow* window = gtk_widget_get_window(widget);
+	if (window && !this->eventCompressionChanged)
+	{
+		this->eventCompression = gdk_window_get_event_compression(window);
+		this->eventCompressionChanged = true;
+		gdk_window_set_event_compression(window, false);
+	}
 	
 	this->startStrokeTime = pos.timestamp;
 }
 
-void StrokeHandler::destroySurface()
+void StrokeHandler::restoreEventCompression()
 {
 	XOJ_CHECK_TYPE(StrokeHandler);
 
-	if (surfMask || crMask)
+	if (!this->eventCompressionChanged)
+	{
+		return;
+	}
+	this->eventCompressionChanged = false;
+
+	GdkWindow* window = gtk_widget_get_window(xournal->getWidget());
+	if (window)
 	{
-		cairo_destroy(crMask);
-		cairo_surface_destroy(surfMask);
-		surfMask = NULL;
-		crMask = NULL;
+		gdk_window_set_event_compression(window, this->eventCompression);
 	}
 }
 
@@ -13,7 +13,7 @@
 
 #include "InputHandler.h"
 
-#include "view/DocumentView.h"
+#include "view/LiveStrokeView.h"
 
 class ShapeRecognizer;
 
@@ -23,8 +23,8 @@ class ShapeRecognizer;
  * The stroke is drawn using a cairo_surface_t* as a mask:
  * As the pointer moves on the canvas single segments are
  * drawn opaquely on the initially transparent masking
- * surface. The surface is used to mask the stroke
- * when drawing it to the XojPageView
+ * surface by LiveStrokeView. The surface is used to mask
+ * the stroke when drawing it to the XojPageView
  */
 class StrokeHandler : public InputHandler
 {
@@ -46,22 +46,39 @@ public:
 
 protected:
 	void strokeRecognizerDetected(ShapeRecognizerResult* result, Layer* layer);
-	void destroySurface();
+
+	/**
+	 * Draw the points added since the last frame and repaint only their area
+	 */
+	void drawNewPoints();
+
+	/**
+	 * Give the event compression state back, which was changed on button press
+	 */
+	void restoreEventCompression();
+
+private:
+	static void frameUpdateCallback(GdkFrameClock* clock, StrokeHandler* handler);
 
 private:
 	XOJ_TYPE_ATTRIB;
 
 	/**
-	 * The masking surface
+	 * Draws the stroke to the masking surface
 	 */
-	cairo_surface_t* surfMask;
+	LiveStrokeView liveView;
 
 	/**
-	 * And the corresponding cairo_t*
+	 * Motion events only add the points, they are drawn on the next frame
 	 */
-	cairo_t* crMask;
+	GdkFrameClock* frameClock = NULL;
+	gulong frameUpdateHandler = 0;
 
-	DocumentView view;
+	/**
+	 * Event compression is disabled while drawing, this is the state before
+	 */
+	bool eventCompressionChanged = false;
+	bool eventCompression = false;
 
 	ShapeRecognizer* reco;
 
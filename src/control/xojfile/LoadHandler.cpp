@@ -82,6 +82,10 @@ void LoadHandler::initAttributes()
 	this->teximage = NULL;
 	this->text = NULL;
 
+	this->binaryBuffer.clear();
+	this->base64State = 0;
+	this->base64Save = 0;
+
 	if (this->audioFiles)
 	{
 		g_hash_table_unref(this->audioFiles);
@@ -867,22 +871,20 @@ void LoadHandler::parseAttachment()
 	{
 		case PARSER_POS_IN_IMAGE:
 		{
-			gpointer data = nullptr;
-			gsize dataLength;
-			readZipAttachment(path, data, dataLength);
-
-			string imgData = string((char*)data, dataLength);
-			this->image->setImage(imgData);
+			string imgData;
+			if (readZipAttachment(path, imgData))
+			{
+				this->image->setImage(std::move(imgData));
+			}
 			break;
 		}
 		case PARSER_POS_IN_TEXIMAGE:
 		{
-			gpointer data = nullptr;
-			gsize dataLength;
-			readZipAttachment(path, data, dataLength);
-
-			string imgData = string((char*)data, dataLength);
-			this->teximage->setBinaryData(imgData);
+			string imgData;
+			if (readZipAttachment(path, imgData))
+			{
+				this->teximage->setBinaryData(std::move(imgData));
+			}
 			break;
 		}
 		default:
@@ -1092,11 +1094,24 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
 	}
 	else if (handler->pos == PARSER_POS_IN_IMAGE && strcmp(elementName, "image") == 0)
 	{
+		// Inline data, only whitespace if the image is stored as attachment
+		string data = handler->finishBase64();
+		if (!data.empty())
+		{
+			handler->image->setImage(std::move(data));
+		}
+
 		handler->pos = PARSER_POS_IN_LAYER;
 		handler->image = NULL;
 	}
 	else if (handler->pos == PARSER_POS_IN_TEXIMAGE && strcmp(elementName, "teximage") == 0)
 	{
+		string data = handler->finishBase64();
+		if (!data.empty())
+		{
+			handler->teximage->setBinaryData(std::move(data));
+		}
+
 		handler->pos = PARSER_POS_IN_LAYER;
 		handler->teximage = NULL;
 	}
@@ -1176,56 +1191,35 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text,
 		handler->text->setText(txt);
 		g_free(txt);
 	}
-	else if (handler->pos == PARSER_POS_IN_IMAGE)
-	{
-		handler->readImage(text, textLen);
-	}
-	else if (handler->pos == PARSER_POS_IN_TEXIMAGE)
+	else if (handler->pos == PARSER_POS_IN_IMAGE || handler->pos == PARSER_POS_IN_TEXIMAGE)
 	{
-		handler->readTexImage(text, textLen);
+		handler->readBase64Chunk(text, textLen);
 	}
 }
 
-string LoadHandler::parseBase64(const gchar* base64, gsize lenght)
+void LoadHandler::readBase64Chunk(const gchar* base64string, gsize base64stringLen)
 {
 	XOJ_CHECK_TYPE(LoadHandler);
 
-	// We have to copy the string in order to null terminate it, sigh.
-	gchar* base64data = (gchar*) g_memdup(base64, lenght + 1);
-	base64data[lenght] = '\0';
+	// Decode directly into the target buffer, the parser may deliver the text in several chunks
+	string::size_type offset = this->binaryBuffer.size();
+	this->binaryBuffer.resize(offset + (base64stringLen / 4) * 3 + 3);
 
-	gsize binaryBufferLen = 0;
-	guchar* binaryBuffer = g_base64_decode(base64data, &binaryBufferLen);
-	g_free(base64data);
-
-	string str = string((char*)binaryBuffer, binaryBufferLen);
-	g_free(binaryBuffer);
-
-	return str;
+	gsize written = g_base64_decode_step(base64string, base64stringLen, (guchar*) &this->binaryBuffer[offset],
+	                                     &this->base64State, &this->base64Save);
+	this->binaryBuffer.resize(offset + written);
 }
 
-void LoadHandler::readImage(const gchar* base64string, gsize base64stringLen)
+string LoadHandler::finishBase64()
 {
 	XOJ_CHECK_TYPE(LoadHandler);
 
-	if (base64stringLen == 1 && !strcmp(base64string, "\n"))
-	{
-		return;
-	}
+	this->base64State = 0;
+	this->base64Save = 0;
 
-	this->image->setImage(parseBase64((char*)base64string, base64stringLen));
-}
-
-void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen)
-{
-	XOJ_CHECK_TYPE(LoadHandler);
-
-	if (base64stringLen == 1 && !strcmp(base64string, "\n"))
-	{
-		return;
-	}
-
-	this->teximage->setBinaryData(parseBase64((char*)base64string, base64stringLen));
+	string data;
+	data.swap(this->binaryBuffer);
+	return data;
 }
 
 /**
@@ -1273,14 +1267,16 @@ Document* LoadHandler::loadDocument(string filename)
 	return &this->doc;
 }
 
-bool LoadHandler::readZipAttachment(string filename, gpointer& data, gsize& length)
+zip_file_t* LoadHandler::openZipAttachment(string filename, zip_uint64_t& length)
 {
+	XOJ_CHECK_TYPE(LoadHandler);
+
 	zip_stat_t attachmentFileStat;
 	int statStatus = zip_stat(this->zipFp, filename.c_str(), 0, &attachmentFileStat);
 	if (statStatus != 0)
 	{
 		error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename % zip_error_strerror(zip_get_error(this->zipFp))));
-		return false;
+		return NULL;
 	}
 
 	if (attachmentFileStat.valid & ZIP_STAT_SIZE)
@@ -1289,7 +1285,7 @@ bool LoadHandler::readZipAttachment(string filename, gpointer& data, gsize& leng
 	} else
 	{
 		error("%s", FC(_F("Could not open attachment: {1}. Error message: No valid file size provided") % filename));
-		return false;
+		return NULL;
 	}
 
 	zip_file_t* attachmentFile = zip_fopen(this->zipFp, filename.c_str(), 0);
@@ -1297,18 +1293,27 @@ bool LoadHandler::readZipAttachment(string filename, gpointer& data, gsize& leng
 	if (!attachmentFile)
 	{
 		error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename % zip_error_strerror(zip_get_error(this->zipFp))));
-		return false;
+		return NULL;
 	}
 
-	data = g_malloc(attachmentFileStat.size);
+	return attachmentFile;
+}
+
+/**
+ * Reads the whole attachment into the preallocated buffer and closes the file
+ */
+bool LoadHandler::readZipAttachmentData(string filename, zip_file_t* attachmentFile, char* data, zip_uint64_t length)
+{
+	XOJ_CHECK_TYPE(LoadHandler);
+
 	zip_uint64_t readBytes = 0;
 	while (readBytes < length)
 	{
-		zip_int64_t read = zip_fread(attachmentFile, data, attachmentFileStat.size);
-		if (read == -1)
+		zip_int64_t read = zip_fread(attachmentFile, data + readBytes, length - readBytes);
+		if (read <= 0)
 		{
-			g_free(data);
-			error("%s", FC(_F("Could not open attachment: {1}. Error message: No valid file size provided") % filename));
+			error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename % zip_error_strerror(zip_file_get_error(attachmentFile))));
+			zip_fclose(attachmentFile);
 			return false;
 		}
 
@@ -1320,6 +1325,53 @@ bool LoadHandler::readZipAttachment(string filename, gpointer& data, gsize& leng
 	return true;
 }
 
+bool LoadHandler::readZipAttachment(string filename, gpointer& data, gsize& length)
+{
+	XOJ_CHECK_TYPE(LoadHandler);
+
+	zip_uint64_t size = 0;
+	zip_file_t* attachmentFile = openZipAttachment(filename, size);
+	if (!attachmentFile)
+	{
+		return false;
+	}
+
+	data = g_malloc(size);
+	length = size;
+
+	if (!readZipAttachmentData(filename, attachmentFile, (char*) data, size))
+	{
+		g_free(data);
+		data = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+bool LoadHandler::readZipAttachment(string filename, string& data)
+{
+	XOJ_CHECK_TYPE(LoadHandler);
+
+	zip_uint64_t size = 0;
+	zip_file_t* attachmentFile = openZipAttachment(filename, size);
+	if (!attachmentFile)
+	{
+		return false;
+	}
+
+	// Read directly into the string, no intermediate buffer
+	data.resize(size);
+
+	if (!readZipAttachmentData(filename, attachmentFile, &data[0], size))
+	{
+		data.clear();
+		return false;
+	}
+
+	return true;
+}
+
 string LoadHandler::getTempFileForPath(string filename)
 {
 	gpointer tmpFilename = g_hash_table_lookup(this->audioFiles, filename.c_str());
@@ -92,12 +92,14 @@ private:
 	void parseBgPdf();
 	void parseAttachment();
 
-	void readImage(const gchar* base64string, gsize base64stringLen);
-	void readTexImage(const gchar* base64string, gsize base64stringLen);
+	void readBase64Chunk(const gchar* base64string, gsize base64stringLen);
+	string finishBase64();
 
 private:
-	string parseBase64(const gchar* base64, gsize lenght);
+	zip_file_t* openZipAttachment(string filename, zip_uint64_t& length);
+	bool readZipAttachmentData(string filename, zip_file_t* attachmentFile, char* data, zip_uint64_t length);
 	bool readZipAttachment(string filename, gpointer& data, gsize& length);
+	bool readZipAttachment(string filename, string& data);
 	string getTempFileForPath(string filename);
 
 private:
@@ -128,6 +130,14 @@ private:
 
 	vector<double> pressureBuffer;
 
+	/**
+	 * Binary data of the current <image> / <teximage>, decoded
+	 * incrementally while the base64 text is delivered by the parser
+	 */
+	string binaryBuffer;
+	gint base64State = 0;
+	guint base64Save = 0;
+
 	PageRef page;
 	Layer* layer;
 	Stroke* stroke;
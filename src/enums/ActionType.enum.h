@@ -189,6 +189,7 @@ enum ActionType
 	// Menu Help
 	ACTION_ABOUT = 800,
 	ACTION_HELP,
+	ACTION_LATENCY_STATISTICS,
 
 	// Footer, not really an action, but need an identifier too
 	ACTION_FOOTER_PAGESPIN = 900,
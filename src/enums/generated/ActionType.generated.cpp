@@ -667,6 +667,11 @@ ActionType ActionType_fromString(string value)
 		return ACTION_HELP;
 	}
 
+	if (value == "ACTION_LATENCY_STATISTICS")
+	{
+		return ACTION_LATENCY_STATISTICS;
+	}
+
 	if (value == "ACTION_FOOTER_PAGESPIN")
 	{
 		return ACTION_FOOTER_PAGESPIN;
@@ -1345,6 +1350,11 @@ string ActionType_toString(ActionType value)
 		return "ACTION_HELP";
 	}
 
+	if (value == ACTION_LATENCY_STATISTICS)
+	{
+		return "ACTION_LATENCY_STATISTICS";
+	}
+
 	if (value == ACTION_FOOTER_PAGESPIN)
 	{
 		return "ACTION_FOOTER_PAGESPIN";
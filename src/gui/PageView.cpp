@@ -21,6 +21,7 @@
 #include "control/tools/Selection.h"
 #include "control/tools/StrokeHandler.h"
 #include "control/tools/VerticalToolHandler.h"
+#include "inputdevices/InputRecorder.h"
 #include "model/Image.h"
 #include "model/Layer.h"
 #include "model/PageRef.h"
@@ -38,9 +39,11 @@
 #include <config-debug.h>
 #include <config-features.h>
 #include <i18n.h>
+#include <LatencyTrace.h>
 #include <pixbuf-utils.h>
 #include <Range.h>
 #include <Rectangle.h>
+#include <Util.h>
 
 #include <gdk/gdk.h>
 
@@ -135,6 +138,33 @@ void XojPageView::deleteViewBuffer()
 	g_mutex_unlock(&this->drawingMutex);
 }
 
+bool XojPageView::drawThumbnail(cairo_surface_t* target, int x, int y, int width, int height)
+{
+	XOJ_CHECK_TYPE(XojPageView);
+
+	g_mutex_lock(&this->repaintRectMutex);
+	bool pending = this->rerenderComplete || !this->rerenderRects.empty();
+	g_mutex_unlock(&this->repaintRectMutex);
+
+	if (pending)
+	{
+		return false;
+	}
+
+	g_mutex_lock(&this->drawingMutex);
+
+	bool drawn = false;
+	if (this->crBuffer)
+	{
+		Util::cairo_downsample_box(this->crBuffer, target, x, y, width, height);
+		drawn = true;
+	}
+
+	g_mutex_unlock(&this->drawingMutex);
+
+	return drawn;
+}
+
 bool XojPageView::containsPoint(int x, int y, bool local)
 {
 	XOJ_CHECK_TYPE(XojPageView);
@@ -172,7 +202,7 @@ bool XojPageView::searchTextOnPage(string& text, int* occures, double* top)
 			pdf = doc->getPdfPage(pNr);
 			doc->unlock();
 		}
-		this->search = new SearchControl(page, pdf);
+		this->search = new SearchControl(page, pdf, xournal->getControl()->getSearchIndex());
 	}
 
 	bool found = this->search->search(text, occures, top);
@@ -329,6 +359,11 @@ bool XojPageView::onButtonPressEvent(const PositionInputData& pos)
 {
 	XOJ_CHECK_TYPE(XojPageView);
 
+	InputRecorder* recorder = xournal->getControl()->getInputRecorder();
+	if (recorder)
+	{
+		recorder->record(INPUT_RECORD_PRESS, this, pos);
+	}
 
 	if (!this->selected)
 	{
@@ -457,6 +492,12 @@ bool XojPageView::onMotionNotifyEvent(const PositionInputData& pos)
 {
 	XOJ_CHECK_TYPE(XojPageView);
 
+	InputRecorder* recorder = xournal->getControl()->getInputRecorder();
+	if (recorder)
+	{
+		recorder->record(INPUT_RECORD_MOTION, this, pos);
+	}
+
 	double zoom = xournal->getZoom();
 	double x = pos.x / zoom;
 	double y = pos.y / zoom;
@@ -499,6 +540,11 @@ bool XojPageView::onButtonReleaseEvent(const PositionInputData& pos)
 
 	Control* control = xournal->getControl();
 
+	if (control->getInputRecorder())
+	{
+		control->getInputRecorder()->record(INPUT_RECORD_RELEASE, this, pos);
+	}
+
 	if (this->inputHandler)
 	{
 		this->inputHandler->onButtonReleaseEvent(pos);
@@ -617,6 +663,25 @@ void XojPageView::rerenderPage()
 	this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
+void XojPageView::prefetchPage()
+{
+	XOJ_CHECK_TYPE(XojPageView);
+
+	if (this->crBuffer != NULL || this->lastVisibleTime == 0)
+	{
+		// Already rendered, or visible and rendered anyway
+		return;
+	}
+
+	// The buffer is kept like the buffer of a page which was just hidden
+	GTimeVal val;
+	g_get_current_time(&val);
+	this->lastVisibleTime = val.tv_sec;
+
+	this->rerenderComplete = true;
+	this->xournal->getControl()->getScheduler()->addPrefetchPage(this);
+}
+
 void XojPageView::repaintPage()
 {
 	XOJ_CHECK_TYPE(XojPageView);
@@ -628,6 +693,8 @@ void XojPageView::repaintArea(double x1, double y1, double x2, double y2)
 {
 	XOJ_CHECK_TYPE(XojPageView);
 
+	LatencySpan span("XojPageView::repaintArea");
+
 	double zoom = xournal->getZoom();
 	xournal->getRepaintHandler()->repaintPageArea(this, x1 * zoom - 10, y1 * zoom - 10, x2 * zoom + 20, y2 * zoom + 20);
 }
@@ -775,6 +842,8 @@ void XojPageView::paintPageSync(cairo_t* cr, GdkRectangle* rect)
 {
 	XOJ_CHECK_TYPE(XojPageView);
 
+	LatencySpan span("XojPageView::paintPageSync");
+
 	if (this->crBuffer == NULL)
 	{
 		drawLoadingPage(cr);
@@ -875,6 +944,7 @@ bool XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect)
 	paintPageSync(cr, rect);
 
 	g_mutex_unlock(&this->drawingMutex);
+
 	return true;
 }
 
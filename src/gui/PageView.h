@@ -43,6 +43,11 @@ public:
 	void updatePageSize(double width, double height);
 
 	virtual void rerenderPage();
+
+	/**
+	 * Render the page before it's visible, if there is no buffer yet
+	 */
+	void prefetchPage();
 	virtual void rerenderRect(double x, double y, double width, double height);
 
 	virtual void repaintPage();
@@ -71,6 +76,14 @@ public:
 
 	void deleteViewBuffer();
 
+	/**
+	 * Scale the rendered page down into target, for the sidebar previews.
+	 * Called from the scheduler thread.
+	 *
+	 * @return false if there is no buffer or it is waiting to be rendered again
+	 */
+	bool drawThumbnail(cairo_surface_t* target, int x, int y, int width, int height);
+
 	/**
 	 * Returns whether this PageView contains the
 	 * given point on the display
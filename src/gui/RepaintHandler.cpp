@@ -3,6 +3,8 @@
 #include "PageView.h"
 #include "XournalView.h"
 
+#include "control/Control.h"
+#include "gui/inputdevices/InputReplay.h"
 #include "gui/scroll/ScrollHandling.h"
 #include "widgets/XournalWidget.h"
 
@@ -25,6 +27,13 @@ void RepaintHandler::repaintPage(XojPageView* view)
 {
 	XOJ_CHECK_TYPE(RepaintHandler);
 
+	InputReplay* replay = this->xournal->getControl()->getInputReplay();
+	if (replay)
+	{
+		replay->addDamage(view, 0, 0, view->getDisplayWidth(), view->getDisplayHeight());
+		return;
+	}
+
 	if (xournal->getScrollHandling()->fullRepaint())
 	{
 		gtk_widget_queue_draw(this->xournal->getWidget());
@@ -44,6 +53,12 @@ void RepaintHandler::repaintPageArea(XojPageView* view, int x1, int y1, int x2,
 {
 	XOJ_CHECK_TYPE(RepaintHandler);
 
+	InputReplay* replay = this->xournal->getControl()->getInputReplay();
+	if (replay)
+	{
+		replay->addDamage(view, x1, y1, x2, y2);
+		return;
+	}
 
 	if (xournal->getScrollHandling()->fullRepaint())
 	{
@@ -61,5 +76,12 @@ void RepaintHandler::repaintPageBorder(XojPageView* view)
 {
 	XOJ_CHECK_TYPE(RepaintHandler);
 
+	InputReplay* replay = this->xournal->getControl()->getInputReplay();
+	if (replay)
+	{
+		replay->addDamage(view, 0, 0, view->getDisplayWidth(), view->getDisplayHeight());
+		return;
+	}
+
 	gtk_widget_queue_draw(this->xournal->getWidget());
 }
@@ -1,10 +1,13 @@
 #include "SearchBar.h"
 
 #include "control/Control.h"
+#include "control/SearchIndex.h"
 
 #include <config.h>
 #include <i18n.h>
 
+#include <set>
+
 SearchBar::SearchBar(Control* control)
  : control(control)
 {
@@ -72,6 +75,11 @@ void SearchBar::search(const char* text)
 				g_free(msg);
 			}
 		}
+		else if (!control->getSearchIndex()->isComplete())
+		{
+			gtk_label_set_text(GTK_LABEL(lbSearchState),
+				FC(_F("Text not found on this page, indexing {1}%") % control->getSearchIndex()->getProgress()));
+		}
 		else
 		{
 			gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
@@ -108,116 +116,116 @@ void SearchBar::buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar
 	searchBar->showSearchBar(false);
 }
 
-void SearchBar::searchNext()
+/**
+ * The next page in direction (1 or -1) which contains the text. If the index is complete the
+ * hits are taken from the index, else all pages are searched one by one.
+ *
+ * @return -1 if no other page contains the text
+ */
+int SearchBar::findPage(const char* text, int page, int direction)
 {
 	XOJ_CHECK_TYPE(SearchBar);
 
-	int page = control->getCurrentPageNo();
 	int count = control->getDocument()->getPageCount();
-	if (count < 2)
-	{
-		// Nothing to do
-		return;
-	}
+	SearchIndex* index = control->getSearchIndex();
 
-	MainWindow* win = control->getWindow();
-	int x = page + 1;
-	GtkWidget* searchTextField = win->get("searchTextField");
-	const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-	GtkWidget* lbSearchState = win->get("lbSearchState");
-	if (*text == 0)
+	if (index->isComplete())
 	{
-		return;
+		std::set<size_t> pages;
+		for (SearchIndexHit& hit : index->search(text))
+		{
+			pages.insert(hit.page);
+		}
+
+		for (int i = 1; i < count; i++)
+		{
+			int x = (page + direction * i + count) % count;
+			if (pages.find(x) != pages.end())
+			{
+				return x;
+			}
+		}
+
+		return -1;
 	}
 
-	if (x >= count)
+	for (int i = 1; i < count; i++)
 	{
-		x = 0;
+		int x = (page + direction * i + count) % count;
+		if (control->searchTextOnPage(text, x, NULL, NULL))
+		{
+			return x;
+		}
 	}
 
-	double top = 0;
-	int occures = 0;
+	return -1;
+}
 
-	while (x != page)
-	{
+void SearchBar::showResultOnPage(const char* text, int page)
+{
+	XOJ_CHECK_TYPE(SearchBar);
 
-		bool found = control->searchTextOnPage(text, x, &occures, &top);
-		if (found)
-		{
-			control->getScrollHandler()->scrollToPage(x, top);
-			gtk_label_set_text(GTK_LABEL(lbSearchState),
-				(occures == 1
-					? FC(_F("Text found once on page {1}") % (x + 1))
-					: FC(_F("Text found {1} times on page {2}") % occures % (x + 1))
-				)
-			);
-			return;
-		}
+	GtkWidget* lbSearchState = control->getWindow()->get("lbSearchState");
 
-		x++;
-		if (x >= count)
-		{
-			x = 0;
-		}
+	if (page == -1)
+	{
+		gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+		return;
 	}
 
-	gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+	double top = 0;
+	int occures = 0;
+	control->searchTextOnPage(text, page, &occures, &top);
+
+	control->getScrollHandler()->scrollToPage(page, top);
+	gtk_label_set_text(GTK_LABEL(lbSearchState),
+		(occures == 1
+			? FC(_F("Text found once on page {1}") % (page + 1))
+			: FC(_F("Text found {1} times on page {2}") % occures % (page + 1))
+		)
+	);
 }
 
-void SearchBar::searchPrevious()
+void SearchBar::searchNext()
 {
 	XOJ_CHECK_TYPE(SearchBar);
 
 	int page = control->getCurrentPageNo();
-	int count = control->getDocument()->getPageCount();
-	if (count < 2)
+	if (control->getDocument()->getPageCount() < 2)
 	{
 		// Nothing to do
 		return;
 	}
 
-	MainWindow* win = control->getWindow();
-	int x = page - 1;
-	GtkWidget* searchTextField = win->get("searchTextField");
+	GtkWidget* searchTextField = control->getWindow()->get("searchTextField");
 	const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-	GtkWidget* lbSearchState = win->get("lbSearchState");
 	if (*text == 0)
 	{
 		return;
 	}
 
-	if (x < 0)
-	{
-		x = count - 1;
-	}
+	showResultOnPage(text, findPage(text, page, 1));
+}
 
-	double top = 0;
-	int occures = 0;
+void SearchBar::searchPrevious()
+{
+	XOJ_CHECK_TYPE(SearchBar);
 
-	while (x != page)
+	int page = control->getCurrentPageNo();
+	if (control->getDocument()->getPageCount() < 2)
 	{
+		// Nothing to do
+		return;
+	}
 
-		bool found = control->searchTextOnPage(text, x, &occures, &top);
-		if (found)
-		{
-			control->getScrollHandler()->scrollToPage(x, top);
-			gtk_label_set_text(GTK_LABEL(lbSearchState),
-				(occures == 1
-					? FC(_F("Text found once on page {1}") % (x + 1))
-					: FC(_F("Text found {1} times on page {2}") % occures % (x + 1))
-				)
-			);
-			return;
-		}
-
-		x--;
-		if (x < 0)
-		{
-			x = count - 1;
-		}
+	GtkWidget* searchTextField = control->getWindow()->get("searchTextField");
+	const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
+	if (*text == 0)
+	{
+		return;
 	}
 
-	gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+	showResultOnPage(text, findPage(text, page, -1));
 }
 
 void SearchBar::buttonNextSearchClicked(GtkButton* button, SearchBar* searchBar)
@@ -246,9 +254,13 @@ void SearchBar::showSearchBar(bool show)
 		GtkWidget* searchTextField = win->get("searchTextField");
 		gtk_widget_grab_focus(searchTextField);
 		gtk_widget_show_all(searchBar);
+
+		control->getSearchIndex()->start();
 	}
 	else
 	{
+		control->getSearchIndex()->cancel();
+
 		gtk_widget_hide(searchBar);
 		for (int i = control->getDocument()->getPageCount() - 1; i >= 0; i--)
 		{
@@ -256,3 +268,17 @@ void SearchBar::showSearchBar(bool show)
 		}
 	}
 }
+
+void SearchBar::indexUpdated()
+{
+	XOJ_CHECK_TYPE(SearchBar);
+
+	MainWindow* win = control->getWindow();
+	if (!gtk_widget_get_visible(win->get("searchBar")))
+	{
+		return;
+	}
+
+	GtkWidget* searchTextField = win->get("searchTextField");
+	search(gtk_entry_get_text(GTK_ENTRY(searchTextField)));
+}
@@ -25,6 +25,11 @@ public:
 
 	void showSearchBar(bool show);
 
+	/**
+	 * Called when the search index is complete, the current search is done again
+	 */
+	void indexUpdated();
+
 private:
 	static void buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar);
 	static void searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar);
@@ -37,6 +42,8 @@ private:
 
 	void search(const char* text);
 	bool searchTextonCurrentPage(const char* text, int* occures, double* top);
+	int findPage(const char* text, int page, int direction);
+	void showResultOnPage(const char* text, int page);
 
 private:
 	XOJ_TYPE_ATTRIB;
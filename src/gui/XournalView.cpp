@@ -93,9 +93,12 @@ XournalView::~XournalView()
 	XOJ_RELEASE_TYPE(XournalView);
 }
 
+/**
+ * The most recently hidden pages first
+ */
 gint pageViewCmpSize(XojPageView* a, XojPageView* b)
 {
-	return a->getLastVisibleTime() - b->getLastVisibleTime();
+	return b->getLastVisibleTime() - a->getLastVisibleTime();
 }
 
 void XournalView::staticLayoutPages(GtkWidget *widget, GtkAllocation *allocation, void *data)
@@ -120,8 +123,8 @@ gboolean XournalView::clearMemoryTimer(XournalView* widget)
 		}
 	}
 
-	int pixel = 2884560;
-	int firstPages = 4;
+	int pixel = XOURNAL_VIEW_BUFFER_PIXELS;
+	int firstPages = XOURNAL_VIEW_BUFFER_PAGES;
 
 	int i = 0;
 
@@ -490,6 +493,8 @@ void XournalView::pageSelected(size_t page)
 	control->updatePageNumbers(currentPage, pdfPage);
 
 	control->updateBackgroundSizeButton();
+
+	control->getScheduler()->prefetchPages(this, page);
 }
 
 Control* XournalView::getControl()
@@ -21,6 +21,13 @@
 
 #include <gtk/gtk.h>
 
+/**
+ * The buffers of the visible and the most recently hidden pages are kept, and
+ * of more hidden pages up to this count of pixels
+ */
+#define XOURNAL_VIEW_BUFFER_PAGES 4
+#define XOURNAL_VIEW_BUFFER_PIXELS 2884560
+
 class Control;
 class XournalppCursor;
 class Document;
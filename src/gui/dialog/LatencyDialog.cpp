@@ -0,0 +1,115 @@
+#include "LatencyDialog.h"
+
+#include <i18n.h>
+#include <LatencyTrace.h>
+#include <XojMsgBox.h>
+
+#include <time.h>
+
+#define RESPONSE_CLOSE 1
+#define RESPONSE_REFRESH 2
+#define RESPONSE_RESET 3
+#define RESPONSE_EXPORT 4
+
+LatencyDialog::LatencyDialog(GladeSearchpath* gladeSearchPath)
+ : GladeGui(gladeSearchPath, "latency.glade", "latencyDialog")
+{
+	XOJ_INIT_TYPE(LatencyDialog);
+
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(get("cbEnableTracing")), LatencyTrace::isEnabled());
+	g_signal_connect(get("cbEnableTracing"), "toggled", G_CALLBACK(enableToggled), this);
+}
+
+LatencyDialog::~LatencyDialog()
+{
+	XOJ_RELEASE_TYPE(LatencyDialog);
+}
+
+void LatencyDialog::enableToggled(GtkToggleButton* button, LatencyDialog* self)
+{
+	XOJ_CHECK_TYPE_OBJ(self, LatencyDialog);
+
+	LatencyTrace::setEnabled(gtk_toggle_button_get_active(button));
+}
+
+void LatencyDialog::updateSummary()
+{
+	XOJ_CHECK_TYPE(LatencyDialog);
+
+	string summary = LatencyTrace::getSummary();
+	if (summary.empty())
+	{
+		summary = _("No spans recorded. Enable tracing, draw something and refresh.");
+	}
+
+	GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(get("txtSummary")));
+	gtk_text_buffer_set_text(buffer, summary.c_str(), -1);
+}
+
+void LatencyDialog::exportTrace()
+{
+	XOJ_CHECK_TYPE(LatencyDialog);
+
+	GtkWidget* dialog = gtk_file_chooser_dialog_new(_("Export trace"), GTK_WINDOW(this->getWindow()),
+													GTK_FILE_CHOOSER_ACTION_SAVE, _("_Cancel"), GTK_RESPONSE_CANCEL,
+													_("_Save"), GTK_RESPONSE_OK, NULL);
+
+	gtk_file_chooser_set_local_only(GTK_FILE_CHOOSER(dialog), true);
+
+	GtkFileFilter* filterJson = gtk_file_filter_new();
+	gtk_file_filter_set_name(filterJson, _("Chrome trace"));
+	gtk_file_filter_add_pattern(filterJson, "*.json");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filterJson);
+
+	time_t curtime = time(NULL);
+	char stime[128];
+	strftime(stime, sizeof(stime), "%F-Trace-%H-%M.json", localtime(&curtime));
+	gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(dialog), stime);
+	gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(dialog), true);
+
+	gtk_window_set_transient_for(GTK_WINDOW(dialog), GTK_WINDOW(this->getWindow()));
+	if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_OK)
+	{
+		gtk_widget_destroy(dialog);
+		return;
+	}
+
+	char* name = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+	string filename = name;
+	g_free(name);
+	gtk_widget_destroy(dialog);
+
+	if (!LatencyTrace::writeChromeTrace(filename))
+	{
+		string msg = FS(_F("Could not write trace file \"{1}\"") % filename);
+		XojMsgBox::showErrorToUser(GTK_WINDOW(this->getWindow()), msg);
+	}
+}
+
+void LatencyDialog::show(GtkWindow* parent)
+{
+	XOJ_CHECK_TYPE(LatencyDialog);
+
+	gtk_window_set_transient_for(GTK_WINDOW(this->window), parent);
+
+	while (true)
+	{
+		updateSummary();
+
+		int returnCode = gtk_dialog_run(GTK_DIALOG(this->window));
+		if (returnCode == RESPONSE_RESET)
+		{
+			LatencyTrace::reset();
+		}
+		else if (returnCode == RESPONSE_EXPORT)
+		{
+			exportTrace();
+		}
+		else if (returnCode != RESPONSE_REFRESH)
+		{
+			break;
+		}
+	}
+
+	gtk_widget_hide(this->window);
+}
@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * Shows the latency histograms of the traced spans
+ * and exports the trace
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "gui/GladeGui.h"
+
+class LatencyDialog : public GladeGui
+{
+public:
+	LatencyDialog(GladeSearchpath* gladeSearchPath);
+	virtual ~LatencyDialog();
+
+public:
+	virtual void show(GtkWindow* parent);
+
+private:
+	void updateSummary();
+	void exportTrace();
+
+	static void enableToggled(GtkToggleButton* button, LatencyDialog* self);
+
+private:
+	XOJ_TYPE_ATTRIB;
+};
@@ -4,6 +4,8 @@
 
 #include "InputContext.h"
 
+#include <LatencyTrace.h>
+
 InputContext::InputContext(XournalView* view, ScrollHandling* scrollHandling)
 {
 	XOJ_INIT_TYPE(InputContext);
@@ -81,6 +83,8 @@ bool InputContext::handle(GdkEvent* event)
 {
 	XOJ_CHECK_TYPE(InputContext);
 
+	LatencySpan span("InputContext::handle");
+
 	GdkDevice* device = gdk_event_get_source_device(event);
 
 #ifdef DEBUG_INPUT_GDK_PRINT_EVENTS
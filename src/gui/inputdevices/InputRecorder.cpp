@@ -0,0 +1,72 @@
+#include "InputRecorder.h"
+
+#include "control/Control.h"
+#include "gui/PageView.h"
+#include "gui/XournalView.h"
+
+InputRecorder::InputRecorder(Control* control, Path file)
+ : control(control)
+{
+	XOJ_INIT_TYPE(InputRecorder);
+
+	this->out.open(file.c_str(), std::ofstream::out | std::ofstream::trunc);
+	this->out.imbue(std::locale::classic());
+	this->out << "# Xournal++ input recording, version 1" << std::endl;
+}
+
+InputRecorder::~InputRecorder()
+{
+	XOJ_CHECK_TYPE(InputRecorder);
+
+	this->out.close();
+
+	XOJ_RELEASE_TYPE(InputRecorder);
+}
+
+bool InputRecorder::isOpen()
+{
+	XOJ_CHECK_TYPE(InputRecorder);
+
+	return this->out.is_open();
+}
+
+const char* InputRecorder::getTypeName(InputRecordType type)
+{
+	switch (type)
+	{
+	case INPUT_RECORD_PRESS:
+		return "press";
+	case INPUT_RECORD_MOTION:
+		return "motion";
+	case INPUT_RECORD_RELEASE:
+	default:
+		return "release";
+	}
+}
+
+/**
+ * Record an event which is passed to the page
+ */
+void InputRecorder::record(InputRecordType type, XojPageView* view, const PositionInputData& pos)
+{
+	XOJ_CHECK_TYPE(InputRecorder);
+
+	double zoom = control->getZoomControl()->getZoom();
+
+	if (type == INPUT_RECORD_PRESS)
+	{
+		ToolHandler* h = control->getToolHandler();
+		this->out << "tool " << h->getToolType() << " " << h->getSize() << " " << h->getColor() << " "
+		          << h->getEraserType() << " " << h->getDrawingType() << "\n";
+		this->out << "zoom " << zoom << "\n";
+	}
+
+	this->out << getTypeName(type) << " " << control->getDocument()->indexOf(view->getPage()) << " "
+	          << pos.x / zoom << " " << pos.y / zoom << " " << pos.pressure << " "
+	          << pos.timestamp << " " << (int) pos.state << "\n";
+
+	if (type == INPUT_RECORD_RELEASE)
+	{
+		this->out.flush();
+	}
+}
@@ -0,0 +1,64 @@
+/*
+ * Xournal++
+ *
+ * Records the input events which reach the pages, to replay them later with InputReplay
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "PositionInputData.h"
+
+#include <Path.h>
+#include <XournalType.h>
+
+#include <fstream>
+
+class Control;
+class XojPageView;
+
+enum InputRecordType
+{
+	INPUT_RECORD_PRESS = 0,
+	INPUT_RECORD_MOTION,
+	INPUT_RECORD_RELEASE
+};
+
+/**
+ * File format, one event per line, coordinates in page coordinates (unzoomed):
+ *
+ * tool TOOL SIZE COLOR ERASER_TYPE DRAWING_TYPE   (before each press)
+ * zoom ZOOM                                       (before each press)
+ * press|motion|release PAGE X Y PRESSURE TIMESTAMP STATE
+ */
+class InputRecorder
+{
+public:
+	InputRecorder(Control* control, Path file);
+	virtual ~InputRecorder();
+
+public:
+	/**
+	 * Record an event which is passed to the page
+	 */
+	void record(InputRecordType type, XojPageView* view, const PositionInputData& pos);
+
+	/**
+	 * @return true if the file could be opened
+	 */
+	bool isOpen();
+
+public:
+	static const char* getTypeName(InputRecordType type);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	Control* control;
+
+	std::ofstream out;
+};
@@ -0,0 +1,392 @@
+#include "InputReplay.h"
+
+#include "control/Control.h"
+#include "gui/PageView.h"
+#include "gui/XournalView.h"
+
+#include <StringUtils.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * Refresh interval of the simulated display, in µs (60 Hz)
+ */
+#define REPLAY_REFRESH_INTERVAL 16667
+
+InputReplay::InputReplay(Control* control, Path file, Path report)
+ : control(control),
+   file(file),
+   report(report)
+{
+	XOJ_INIT_TYPE(InputReplay);
+}
+
+InputReplay::~InputReplay()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	if (this->timeoutId)
+	{
+		g_source_remove(this->timeoutId);
+		this->timeoutId = 0;
+	}
+
+	if (this->frameBuffer)
+	{
+		cairo_surface_destroy(this->frameBuffer);
+		this->frameBuffer = NULL;
+	}
+
+	XOJ_RELEASE_TYPE(InputReplay);
+}
+
+/**
+ * Read the recording
+ */
+bool InputReplay::load()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	std::ifstream in(file.c_str());
+	if (!in.is_open())
+	{
+		return false;
+	}
+
+	InputReplayEvent current;
+	string line;
+	while (std::getline(in, line))
+	{
+		std::istringstream ls(line);
+		ls.imbue(std::locale::classic());
+
+		string type;
+		ls >> type;
+
+		if (type == "tool")
+		{
+			ls >> current.tool >> current.size >> current.color >> current.eraserType >> current.drawingType;
+			continue;
+		}
+		if (type == "zoom")
+		{
+			ls >> current.zoom;
+			continue;
+		}
+
+		if (type == "press")
+		{
+			current.type = INPUT_RECORD_PRESS;
+		}
+		else if (type == "motion")
+		{
+			current.type = INPUT_RECORD_MOTION;
+		}
+		else if (type == "release")
+		{
+			current.type = INPUT_RECORD_RELEASE;
+		}
+		else
+		{
+			// Comment or unknown line
+			continue;
+		}
+
+		int state = 0;
+		ls >> current.page >> current.pos.x >> current.pos.y >> current.pos.pressure >> current.pos.timestamp >> state;
+		current.pos.state = (GdkModifierType) state;
+
+		if (ls.fail())
+		{
+			g_warning("InputReplay: invalid line \"%s\"", line.c_str());
+			continue;
+		}
+
+		this->events.push_back(current);
+
+		// Tool and zoom are only applied on the press event they belong to
+		current.tool = -1;
+		current.zoom = -1;
+	}
+
+	return !this->events.empty();
+}
+
+/**
+ * Start the replay, with the original timing of the recording.
+ */
+void InputReplay::start()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	this->startTime = g_get_monotonic_time();
+	this->firstTimestamp = this->events.front().pos.timestamp;
+	this->nextFrameTime = this->startTime + REPLAY_REFRESH_INTERVAL;
+
+	this->timeoutId = g_timeout_add(1, (GSourceFunc) replayCallback, this);
+}
+
+bool InputReplay::replayCallback(InputReplay* replay)
+{
+	XOJ_CHECK_TYPE_OBJ(replay, InputReplay);
+
+	gint64 now = g_get_monotonic_time();
+	gint64 elapsed = (now - replay->startTime) / 1000;
+
+	while (replay->nextEvent < replay->events.size())
+	{
+		InputReplayEvent& e = replay->events[replay->nextEvent];
+		if ((gint64) (e.pos.timestamp - replay->firstTimestamp) > elapsed)
+		{
+			break;
+		}
+
+		replay->nextEvent++;
+		replay->replayEvent(e);
+	}
+
+	if (now >= replay->nextFrameTime)
+	{
+		replay->paintFrame();
+	}
+
+	// Wait for the frame which paints the last events
+	if (replay->nextEvent < replay->events.size() || !replay->damage.empty())
+	{
+		return true;
+	}
+
+	replay->timeoutId = 0;
+	replay->finish();
+	return false;
+}
+
+void InputReplay::replayEvent(InputReplayEvent& e)
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	if (e.tool != -1)
+	{
+		ToolHandler* h = control->getToolHandler();
+		h->selectTool((ToolType) e.tool);
+		h->setSize((ToolSize) e.size);
+		h->setColor(e.color, false);
+		h->setEraserType((EraserType) e.eraserType);
+		h->setDrawingType((DrawingType) e.drawingType);
+	}
+	if (e.zoom > 0)
+	{
+		control->getZoomControl()->setZoom(e.zoom);
+	}
+
+	XojPageView* view = control->getWindow()->getXournal()->getViewFor(e.page);
+	if (view == NULL)
+	{
+		return;
+	}
+
+	double zoom = control->getZoomControl()->getZoom();
+	PositionInputData pos = e.pos;
+	pos.x *= zoom;
+	pos.y *= zoom;
+
+	gint64 begin = g_get_monotonic_time();
+
+	if (this->redrawPendingSince == -1)
+	{
+		this->redrawPendingSince = begin;
+	}
+
+	switch (e.type)
+	{
+	case INPUT_RECORD_PRESS:
+		view->onButtonPressEvent(pos);
+		this->pressTime = begin;
+		break;
+	case INPUT_RECORD_MOTION:
+		view->onMotionNotifyEvent(pos);
+		break;
+	case INPUT_RECORD_RELEASE:
+		view->onButtonReleaseEvent(pos);
+		break;
+	}
+
+	this->processingTimes.push_back(g_get_monotonic_time() - begin);
+}
+
+/**
+ * Called from the RepaintHandler instead of queuing a redraw of the widget
+ */
+void InputReplay::addDamage(XojPageView* view, int x1, int y1, int x2, int y2)
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	GdkRectangle bounds = { 0, 0, view->getDisplayWidth(), view->getDisplayHeight() };
+	GdkRectangle area = { x1, y1, x2 - x1, y2 - y1 };
+	if (!gdk_rectangle_intersect(&area, &bounds, &area))
+	{
+		return;
+	}
+
+	auto it = this->damage.find(view);
+	if (it == this->damage.end())
+	{
+		this->damage[view] = area;
+	}
+	else
+	{
+		gdk_rectangle_union(&it->second, &area, &it->second);
+	}
+}
+
+/**
+ * Paints the damaged areas offscreen, like the widget would on a vertical sync
+ */
+void InputReplay::paintFrame()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	gint64 frameTime = this->nextFrameTime;
+
+	// Nothing to paint: the events since the last frame did not need a redraw
+	if (this->damage.empty())
+	{
+		this->redrawPendingSince = -1;
+	}
+	else
+	{
+		// Only paint views which still exist, pages may have been removed
+		ArrayIterator<XojPageView*> it = control->getWindow()->getXournal()->pageViewIterator();
+		while (it.hasNext())
+		{
+			XojPageView* view = it.next();
+			auto d = this->damage.find(view);
+			if (d == this->damage.end())
+			{
+				continue;
+			}
+
+			GdkRectangle& area = d->second;
+			if (this->frameBuffer == NULL
+			    || cairo_image_surface_get_width(this->frameBuffer) < area.width
+			    || cairo_image_surface_get_height(this->frameBuffer) < area.height)
+			{
+				int width = area.width;
+				int height = area.height;
+				if (this->frameBuffer)
+				{
+					width = MAX(width, cairo_image_surface_get_width(this->frameBuffer));
+					height = MAX(height, cairo_image_surface_get_height(this->frameBuffer));
+					cairo_surface_destroy(this->frameBuffer);
+				}
+				this->frameBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+			}
+
+			cairo_t* cr = cairo_create(this->frameBuffer);
+			cairo_rectangle(cr, 0, 0, area.width, area.height);
+			cairo_clip(cr);
+			cairo_translate(cr, -area.x, -area.y);
+			view->paintPage(cr, NULL);
+			cairo_destroy(cr);
+		}
+		this->damage.clear();
+
+		gint64 painted = g_get_monotonic_time();
+		if (this->pressTime != -1)
+		{
+			this->firstPaintTimes.push_back(painted - this->pressTime);
+			this->pressTime = -1;
+		}
+
+		// An interval is only measured if replayed events wait for this frame,
+		// else every idle gap is counted as dropped frames
+		if (this->redrawPendingSince != -1)
+		{
+			gint64 start = MAX(this->lastFrameTime, this->redrawPendingSince);
+			this->frameIntervals.push_back(MAX(frameTime - start, 0));
+			this->redrawPendingSince = -1;
+		}
+		this->lastFrameTime = frameTime;
+	}
+
+	// A frame which takes longer than the refresh interval misses the next vertical syncs
+	gint64 now = g_get_monotonic_time();
+	while (this->nextFrameTime <= now)
+	{
+		this->nextFrameTime += REPLAY_REFRESH_INTERVAL;
+	}
+}
+
+void InputReplay::finish()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	writeReport();
+
+	gtk_main_quit();
+}
+
+static void writeStatistics(std::ostream& out, const char* name, vector<gint64> values)
+{
+	std::sort(values.begin(), values.end());
+
+	gint64 total = 0;
+	for (gint64 v : values)
+	{
+		total += v;
+	}
+
+	out << "  \"" << name << "\": {\"count\": " << values.size();
+	if (!values.empty())
+	{
+		out << ", \"mean_us\": " << total / (gint64) values.size()
+		    << ", \"median_us\": " << values[values.size() / 2]
+		    << ", \"p95_us\": " << values[values.size() * 95 / 100]
+		    << ", \"max_us\": " << values.back();
+	}
+	out << "}";
+}
+
+void InputReplay::writeReport()
+{
+	XOJ_CHECK_TYPE(InputReplay);
+
+	// Frames which took longer than 1.5 refresh intervals dropped at least one frame
+	gint64 refresh = REPLAY_REFRESH_INTERVAL;
+	int droppedFrames = 0;
+	for (gint64 interval : this->frameIntervals)
+	{
+		if (interval > refresh * 3 / 2)
+		{
+			droppedFrames += (int) (interval / refresh) - 1;
+		}
+	}
+
+	std::ostringstream out;
+	out << "{" << std::endl;
+	out << "  \"recording\": \"" << StringUtils::escapeJson(file.str()) << "\"," << std::endl;
+	out << "  \"events\": " << this->events.size() << "," << std::endl;
+	writeStatistics(out, "event_processing", this->processingTimes);
+	out << "," << std::endl;
+	writeStatistics(out, "time_to_first_paint", this->firstPaintTimes);
+	out << "," << std::endl;
+	writeStatistics(out, "frame_interval", this->frameIntervals);
+	out << "," << std::endl;
+	out << "  \"refresh_interval_us\": " << refresh << "," << std::endl;
+	out << "  \"frames\": " << this->frameIntervals.size() << "," << std::endl;
+	out << "  \"dropped_frames\": " << droppedFrames << std::endl;
+	out << "}" << std::endl;
+
+	if (report.isEmpty())
+	{
+		std::cout << out.str();
+	}
+	else
+	{
+		std::ofstream reportFile(report.c_str());
+		reportFile << out.str();
+	}
+}
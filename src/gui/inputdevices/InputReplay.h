@@ -0,0 +1,139 @@
+/*
+ * Xournal++
+ *
+ * Replays an input recording of InputRecorder against the opened document
+ * and reports the processing time per event, the time to the first paint
+ * after pen down and dropped frame statistics
+ *
+ * The replay is headless: the main window is not shown, the damaged page
+ * areas are painted offscreen on a simulated frame clock
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "InputRecorder.h"
+
+#include <Path.h>
+#include <XournalType.h>
+
+#include <gtk/gtk.h>
+
+#include <map>
+#include <vector>
+using std::vector;
+
+class Control;
+class XojPageView;
+
+class InputReplayEvent
+{
+public:
+	InputRecordType type = INPUT_RECORD_MOTION;
+	size_t page = 0;
+	PositionInputData pos;
+
+	/**
+	 * Tool configuration, only for press events
+	 */
+	int tool = -1;
+	int size = 0;
+	int color = 0;
+	int eraserType = 0;
+	int drawingType = 0;
+	double zoom = -1;
+};
+
+class InputReplay
+{
+public:
+	/**
+	 * @param report JSON report filename, stdout if empty
+	 */
+	InputReplay(Control* control, Path file, Path report);
+	virtual ~InputReplay();
+
+public:
+	/**
+	 * Read the recording
+	 *
+	 * @return false if the file could not be read
+	 */
+	bool load();
+
+	/**
+	 * Start the replay, with the original timing of the recording.
+	 * The application quits when the replay is finished.
+	 */
+	void start();
+
+	/**
+	 * Called from the RepaintHandler instead of queuing a redraw of the widget,
+	 * coordinates are in view coordinates
+	 */
+	void addDamage(XojPageView* view, int x1, int y1, int x2, int y2);
+
+private:
+	static bool replayCallback(InputReplay* replay);
+
+	void replayEvent(InputReplayEvent& e);
+	void paintFrame();
+	void finish();
+	void writeReport();
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	Control* control;
+	Path file;
+	Path report;
+
+	vector<InputReplayEvent> events;
+	size_t nextEvent = 0;
+
+	gint64 startTime = 0;
+	guint32 firstTimestamp = 0;
+	guint timeoutId = 0;
+
+	/**
+	 * Processing time of each event, in µs
+	 */
+	vector<gint64> processingTimes;
+
+	/**
+	 * Time from pen down until the next paint, in µs
+	 */
+	vector<gint64> firstPaintTimes;
+	gint64 pressTime = -1;
+
+	/**
+	 * Areas to paint on the next frame, per page view
+	 */
+	std::map<XojPageView*, GdkRectangle> damage;
+
+	/**
+	 * Offscreen target of the painted frames, grows to the largest damaged area
+	 */
+	cairo_surface_t* frameBuffer = NULL;
+
+	/**
+	 * Time of the next simulated vertical sync
+	 */
+	gint64 nextFrameTime = 0;
+	gint64 lastFrameTime = -1;
+
+	/**
+	 * Time of the first replayed event since the last frame, -1 if no redraw is pending
+	 */
+	gint64 redrawPendingSince = -1;
+
+	/**
+	 * For each frame after replayed events: time since the previous frame, or since
+	 * the first event if it came later. Idle time between strokes is not counted.
+	 */
+	vector<gint64> frameIntervals;
+};
@@ -76,12 +76,47 @@ void SidebarIndexPage::enableSidebar()
 	XOJ_CHECK_TYPE(SidebarIndexPage);
 
 	toolbar->setHidden(true);
+	this->enabled = true;
+
+	if (!this->modelLoaded)
+	{
+		loadContentsModel();
+
+		Document* doc = control->getDocument();
+		size_t page = control->getCurrentPageNo();
+
+		doc->lock();
+		PageRef p = doc->getPage(page);
+		size_t pdfPage = (p.isValid() && p->getBackgroundType().isPdfPage()) ? p->getPdfPageNr() : size_t_npos;
+		doc->unlock();
+
+		if (pdfPage != size_t_npos)
+		{
+			selectPageNr(page, pdfPage);
+		}
+	}
 }
 
 void SidebarIndexPage::disableSidebar()
 {
 	XOJ_CHECK_TYPE(SidebarIndexPage);
-	// Nothing to do at the moment
+
+	this->enabled = false;
+}
+
+void SidebarIndexPage::loadContentsModel()
+{
+	XOJ_CHECK_TYPE(SidebarIndexPage);
+
+	Document* doc = this->control->getDocument();
+
+	doc->lock();
+	GtkTreeModel* model = doc->getContentsModel();
+	gtk_tree_view_set_model(GTK_TREE_VIEW(this->treeViewBookmarks), model);
+	expandOpenLinks(model, NULL);
+	doc->unlock();
+
+	this->modelLoaded = true;
 }
 
 void SidebarIndexPage::askInsertPdfPage(size_t pdfPage)
@@ -339,6 +374,12 @@ void SidebarIndexPage::selectPageNr(size_t page, size_t pdfPage)
 {
 	XOJ_CHECK_TYPE(SidebarIndexPage);
 
+	if (!this->modelLoaded)
+	{
+		// The selection is updated when the tree is shown
+		return;
+	}
+
 	selectPageNr(page, pdfPage, NULL);
 }
 
@@ -435,18 +476,22 @@ void SidebarIndexPage::documentChanged(DocumentChangeType type)
 	if (type == DOCUMENT_CHANGE_CLEARED)
 	{
 		gtk_tree_view_set_model(GTK_TREE_VIEW(this->treeViewBookmarks), NULL);
+		this->modelLoaded = false;
 	}
 	else if (type == DOCUMENT_CHANGE_PDF_BOOKMARKS || type == DOCUMENT_CHANGE_COMPLETE)
 	{
+		gtk_tree_view_set_model(GTK_TREE_VIEW(this->treeViewBookmarks), NULL);
+		this->modelLoaded = false;
 
+		// Only check if there is an outline, the tree is built when it's shown
 		Document* doc = this->control->getDocument();
-
 		doc->lock();
-		GtkTreeModel* model = doc->getContentsModel();
-		gtk_tree_view_set_model(GTK_TREE_VIEW(this->treeViewBookmarks), model);
-		int count = expandOpenLinks(model, NULL);
+		hasContents = doc->hasContents();
 		doc->unlock();
 
-		hasContents = (count != 0);
+		if (this->enabled)
+		{
+			loadContentsModel();
+		}
 	}
 }
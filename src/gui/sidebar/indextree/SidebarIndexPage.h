@@ -86,6 +86,11 @@ private:
 	static bool searchTimeoutFunc(SidebarIndexPage* sidebar);
 
 private:
+	/**
+	 * Build the contents model of the document, if not yet done, and show it in the tree
+	 */
+	void loadContentsModel();
+
 	/**
 	 * Expand links
 	 */
@@ -116,4 +121,14 @@ private:
 	 */
 	bool hasContents = false;
 
+	/**
+	 * If this page is currently shown in the sidebar
+	 */
+	bool enabled = false;
+
+	/**
+	 * The tree model is only set when the page is shown, for huge outlines
+	 */
+	bool modelLoaded = false;
+
 };
@@ -3,7 +3,7 @@
 #include "SidebarPreviewBaseEntry.h"
 #include "SidebarPreviewBase.h"
 
-#include <list>
+#include <algorithm>
 
 SidebarLayout::SidebarLayout()
 {
@@ -16,125 +16,82 @@ SidebarLayout::~SidebarLayout()
 	XOJ_RELEASE_TYPE(SidebarLayout);
 }
 
-class SidebarRow
+void SidebarLayout::layout(SidebarPreviewBase* sidebar)
 {
-public:
-	SidebarRow(int width)
-	{
-		this->width = width;
-		this->currentWidth = 0;
-	}
-
-	~SidebarRow()
-	{
-		clear();
-	}
+	XOJ_CHECK_TYPE(SidebarLayout);
 
-public:
-	bool isSpaceFor(SidebarPreviewBaseEntry* p)
-	{
-		if (this->list.size() == 0)
-		{
-			return true;
-		}
-
-		if (this->currentWidth + p->getWidth() < width)
-		{
-			return true;
-		}
-		return false;
-	}
-
-	void add(SidebarPreviewBaseEntry* p)
-	{
-		this->list.push_back(p);
-		this->currentWidth += p->getWidth();
-	}
+	GtkAllocation alloc;
+	gtk_widget_get_allocation(sidebar->scrollPreview, &alloc);
 
-	void clear()
-	{
-		this->list.clear();
-		this->currentWidth = 0;
-	}
+	size_t count = sidebar->previews.size();
+	this->positions.resize(count);
 
-	int getCount()
-	{
-		return this->list.size();
-	}
+	int y = 0;
+	int width = 0;
 
-	int getWidth()
-	{
-		return this->currentWidth;
-	}
+	size_t rowStart = 0;
+	int rowWidth = 0;
+	int rowHeight = 0;
 
-	int placeAt(int y, GtkLayout* layout)
+	for (size_t i = 0; i <= count; i++)
 	{
-		int height = 0;
-		int x = 0;
-
-		for (SidebarPreviewBaseEntry* p : this->list)
+		SidebarPreviewBaseEntry* p = i < count ? sidebar->previews[i] : NULL;
+		if (p != NULL && (i == rowStart || rowWidth + p->getWidth() < alloc.width))
 		{
-			height = MAX(height, p->getHeight());
+			rowWidth += p->getWidth();
+			rowHeight = MAX(rowHeight, p->getHeight());
+			continue;
 		}
 
-
-		for (SidebarPreviewBaseEntry* p : this->list)
+		// The row [rowStart, i) is full, place it
+		int x = 0;
+		for (size_t j = rowStart; j < i; j++)
 		{
-			int currentY = (height - p->getHeight()) / 2;
+			SidebarPreviewBaseEntry* e = sidebar->previews[j];
+			SidebarLayoutPosition& pos = this->positions[j];
 
-			gtk_layout_move(layout, p->getWidget(), x, y + currentY);
+			pos.x = x;
+			pos.y = y + (rowHeight - e->getHeight()) / 2;
+			pos.rowTop = y;
+			pos.rowBottom = y + rowHeight;
 
-			x += p->getWidth();
+			x += e->getWidth();
 		}
 
+		y += rowHeight;
+		width = MAX(width, rowWidth);
 
-		return height;
-	}
-
-private:
-	int width;
-	int currentWidth;
-
-	std::list<SidebarPreviewBaseEntry*> list;
-};
-
-void SidebarLayout::layout(SidebarPreviewBase* sidebar)
-{
-	int y = 0;
-	int width = 0;
-
-	GtkAllocation alloc;
-
-	gtk_widget_get_allocation(sidebar->scrollPreview, &alloc);
-
-	SidebarRow row(alloc.width);
+		rowStart = i;
+		rowWidth = 0;
+		rowHeight = 0;
 
-	for (SidebarPreviewBaseEntry* p : sidebar->previews)
-	{
-		if (row.isSpaceFor(p))
+		if (p != NULL)
 		{
-			row.add(p);
+			rowWidth = p->getWidth();
+			rowHeight = p->getHeight();
 		}
-		else
-		{
-			y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+	}
 
-			width = MAX(width, row.getWidth());
+	gtk_layout_set_size(GTK_LAYOUT(sidebar->iconViewPreview), width, y);
+}
 
-			row.clear();
-			row.add(p);
-		}
-	}
+const SidebarLayoutPosition& SidebarLayout::getPosition(size_t index)
+{
+	XOJ_CHECK_TYPE(SidebarLayout);
 
-	if (row.getCount() != 0)
-	{
-		y += row.placeAt(y, GTK_LAYOUT(sidebar->iconViewPreview));
+	return this->positions[index];
+}
 
-		width = MAX(width, row.getWidth());
+void SidebarLayout::getRange(int top, int bottom, size_t& first, size_t& last)
+{
+	XOJ_CHECK_TYPE(SidebarLayout);
 
-		row.clear();
-	}
+	// Rows are ordered, so both borders can be searched binary
+	auto firstIt = std::lower_bound(this->positions.begin(), this->positions.end(), top,
+		[](const SidebarLayoutPosition& pos, int top) { return pos.rowBottom <= top; });
+	auto lastIt = std::lower_bound(firstIt, this->positions.end(), bottom,
+		[](const SidebarLayoutPosition& pos, int bottom) { return pos.rowTop < bottom; });
 
-	gtk_layout_set_size(GTK_LAYOUT(sidebar->iconViewPreview), width, y);
+	first = firstIt - this->positions.begin();
+	last = lastIt - this->positions.begin();
 }
-
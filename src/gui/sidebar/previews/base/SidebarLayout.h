@@ -15,8 +15,26 @@
 
 #include <gtk/gtk.h>
 
+#include <vector>
+
 class SidebarPreviewBase;
 
+/**
+ * Position of a preview, calculated from the page size, also if the preview has no widget
+ */
+class SidebarLayoutPosition
+{
+public:
+	int x = 0;
+	int y = 0;
+
+	/**
+	 * The row containing the preview, rows are ordered from top to bottom
+	 */
+	int rowTop = 0;
+	int rowBottom = 0;
+};
+
 class SidebarLayout
 {
 public:
@@ -25,11 +43,23 @@ public:
 
 public:
 	/**
-	 * Layouts the sidebar
+	 * Layouts the sidebar, only the positions are calculated, the widgets
+	 * are placed by SidebarPreviewBase::updateVisiblePreviews()
 	 */
 	void layout(SidebarPreviewBase* sidebar);
 
+	/**
+	 * The position of a preview, as calculated by the last layout()
+	 */
+	const SidebarLayoutPosition& getPosition(size_t index);
+
+	/**
+	 * The previews [first, last) which are at least partially between top and bottom
+	 */
+	void getRange(int top, int bottom, size_t& first, size_t& last);
+
 private:
 	XOJ_TYPE_ATTRIB;
 
+	std::vector<SidebarLayoutPosition> positions;
 };
@@ -5,6 +5,11 @@
 #include "SidebarLayout.h"
 #include "SidebarPreviewBaseEntry.h"
 
+/**
+ * Previews are kept with widget and buffer up to this count of screens above and below the visible area
+ */
+#define SIDEBAR_PREVIEW_PRELOAD_SCREENS 1
+
 
 SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarToolbar* toolbar)
  : AbstractSidebarPage(control, toolbar)
@@ -33,6 +38,16 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
 
 	g_signal_connect(this->scrollPreview, "size-allocate", G_CALLBACK(sizeChanged), this);
 
+	GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+	g_signal_connect(vadj, "value-changed", G_CALLBACK(
+		+[](GtkAdjustment* adjustment, SidebarPreviewBase* self)
+		{
+			XOJ_CHECK_TYPE_OBJ(self, SidebarPreviewBase);
+
+			// Also emitted while the scrolled window is allocated
+			self->queueUpdateVisiblePreviews();
+		}), this);
+
 	gtk_widget_show_all(this->scrollPreview);
 
 	g_signal_connect(this->iconViewPreview, "draw", G_CALLBACK(Util::paintBackgroundWhite), NULL);
@@ -42,6 +57,22 @@ SidebarPreviewBase::~SidebarPreviewBase()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewBase);
 
+	if (this->updateVisibleSource)
+	{
+		g_source_remove(this->updateVisibleSource);
+		this->updateVisibleSource = 0;
+	}
+
+	GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+	g_signal_handlers_disconnect_by_data(vadj, this);
+
+	// The previews destroy their widgets, so they are deleted before the layout
+	for (SidebarPreviewBaseEntry* p : this->previews)
+	{
+		delete p;
+	}
+	this->previews.clear();
+
 	gtk_widget_destroy(this->iconViewPreview);
 	this->iconViewPreview = NULL;
 
@@ -53,12 +84,6 @@ SidebarPreviewBase::~SidebarPreviewBase()
 
 	this->scrollPreview = NULL;
 
-	for (SidebarPreviewBaseEntry* p : this->previews)
-	{
-		delete p;
-	}
-	this->previews.clear();
-
 	XOJ_RELEASE_TYPE(SidebarPreviewBase);
 }
 
@@ -92,6 +117,11 @@ void SidebarPreviewBase::sizeChanged(GtkWidget* widget, GtkAllocation* allocatio
 		sidebar->layout();
 		lastWidth = allocation->width;
 	}
+	else
+	{
+		// The height may have changed
+		sidebar->queueUpdateVisiblePreviews();
+	}
 }
 
 double SidebarPreviewBase::getZoom()
@@ -113,6 +143,79 @@ void SidebarPreviewBase::layout()
 	XOJ_CHECK_TYPE(SidebarPreviewBase);
 
 	this->layoutmanager->layout(this);
+
+	// The previews may be added, removed or moved, all of them are checked again
+	this->visibleRangeValid = false;
+	queueUpdateVisiblePreviews();
+}
+
+void SidebarPreviewBase::queueUpdateVisiblePreviews()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBase);
+
+	if (this->updateVisibleSource)
+	{
+		return;
+	}
+
+	// Before redrawing, so the sidebar is not painted without previews
+	this->updateVisibleSource = g_idle_add_full(G_PRIORITY_HIGH_IDLE, (GSourceFunc) updateVisiblePreviewsCallback, this, NULL);
+}
+
+bool SidebarPreviewBase::updateVisiblePreviewsCallback(SidebarPreviewBase* sidebar)
+{
+	XOJ_CHECK_TYPE_OBJ(sidebar, SidebarPreviewBase);
+
+	sidebar->updateVisibleSource = 0;
+	sidebar->updateVisiblePreviews();
+
+	return false;
+}
+
+void SidebarPreviewBase::updateVisiblePreviews()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBase);
+
+	GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+	int top = gtk_adjustment_get_value(vadj);
+	int height = gtk_adjustment_get_page_size(vadj);
+	int preload = height * SIDEBAR_PREVIEW_PRELOAD_SCREENS;
+
+	size_t first = 0;
+	size_t last = 0;
+	this->layoutmanager->getRange(top - preload, top + height + preload, first, last);
+
+	if (this->visibleRangeValid)
+	{
+		// Only the previews of the last range can have a widget
+		for (size_t i = this->visibleFirst; i < this->visibleLast && i < this->previews.size(); i++)
+		{
+			if (i < first || i >= last)
+			{
+				this->previews[i]->detach();
+			}
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < this->previews.size(); i++)
+		{
+			if (i < first || i >= last)
+			{
+				this->previews[i]->detach();
+			}
+		}
+	}
+
+	for (size_t i = first; i < last && i < this->previews.size(); i++)
+	{
+		const SidebarLayoutPosition& pos = this->layoutmanager->getPosition(i);
+		this->previews[i]->attach(GTK_LAYOUT(this->iconViewPreview), pos.x, pos.y);
+	}
+
+	this->visibleFirst = first;
+	this->visibleLast = last;
+	this->visibleRangeValid = true;
 }
 
 bool SidebarPreviewBase::hasData()
@@ -163,25 +266,14 @@ bool SidebarPreviewBase::scrollToPreview(SidebarPreviewBase* sidebar)
 	if (sidebar->selectedEntry != size_t_npos && sidebar->selectedEntry < sidebar->previews.size())
 	{
 		SidebarPreviewBaseEntry* p = sidebar->previews[sidebar->selectedEntry];
+		const SidebarLayoutPosition& pos = sidebar->layoutmanager->getPosition(sidebar->selectedEntry);
 
-		// scroll to preview
+		// scroll to preview, the position is known also if the preview has no widget yet
 		GtkAdjustment* hadj = gtk_scrolled_window_get_hadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
 		GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollPreview));
-		GtkWidget* widget = p->getWidget();
-
-		GtkAllocation allocation;
-		gtk_widget_get_allocation(widget, &allocation);
-		int x = allocation.x;
-		int y = allocation.y;
-
-		if (x == -1)
-		{
-			g_idle_add((GSourceFunc) scrollToPreview, sidebar);
-			return false;
-		}
 
-		gtk_adjustment_clamp_page(vadj, y, y + allocation.height);
-		gtk_adjustment_clamp_page(hadj, x, x + allocation.width);
+		gtk_adjustment_clamp_page(vadj, pos.y, pos.y + p->getHeight());
+		gtk_adjustment_clamp_page(hadj, pos.x, pos.x + p->getWidth());
 	}
 	return false;
 }
@@ -37,6 +37,12 @@ public:
 	 */
 	void layout();
 
+	/**
+	 * Create the widgets of the previews near the visible area, and destroy
+	 * the widgets and buffers of all other previews
+	 */
+	void updateVisiblePreviews();
+
 	/**
 	 * Update the preview images
 	 */
@@ -79,6 +85,12 @@ protected:
 	 */
 	static void sizeChanged(GtkWidget* widget, GtkAllocation* allocation, SidebarPreviewBase* sidebar);
 
+	/**
+	 * Update the visible previews from the main loop, widgets cannot be added while allocating
+	 */
+	void queueUpdateVisiblePreviews();
+	static bool updateVisiblePreviewsCallback(SidebarPreviewBase* sidebar);
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -102,6 +114,18 @@ private:
 	 */
 	SidebarLayout* layoutmanager = NULL;
 
+	/**
+	 * Idle source of queueUpdateVisiblePreviews(), 0 if none
+	 */
+	guint updateVisibleSource = 0;
+
+	/**
+	 * The previews [visibleFirst, visibleLast) have a widget, invalid after layout()
+	 */
+	size_t visibleFirst = 0;
+	size_t visibleLast = 0;
+	bool visibleRangeValid = false;
+
 
 	// Members also used by subclasses
 protected:
@@ -118,7 +142,7 @@ protected:
 	GtkWidget* iconViewPreview = NULL;
 
 	/**
-	 * The previews
+	 * The previews, only the previews near the visible area have a widget
 	 */
 	vector<SidebarPreviewBaseEntry*> previews;
 
@@ -13,12 +13,25 @@ SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, Pa
 {
 	XOJ_INIT_TYPE(SidebarPreviewBaseEntry);
 
+	g_mutex_init(&this->drawingMutex);
+}
+
+SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
+
+	detach();
+	this->page = NULL;
+
+	XOJ_RELEASE_TYPE(SidebarPreviewBaseEntry);
+}
+
+void SidebarPreviewBaseEntry::createWidget()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
+
 	this->widget = gtk_button_new();	// re: issue 1072
-	
 	gtk_widget_show(this->widget);
-	g_object_ref(this->widget);
-
-	g_mutex_init(&this->drawingMutex);
 
 	updateSize();
 	gtk_widget_set_events(widget, GDK_EXPOSURE_MASK ); 
@@ -34,23 +47,54 @@ SidebarPreviewBaseEntry::SidebarPreviewBaseEntry(SidebarPreviewBase* sidebar, Pa
 		}), this);
 }
 
-SidebarPreviewBaseEntry::~SidebarPreviewBaseEntry()
+void SidebarPreviewBaseEntry::destroyWidget()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
 
-	this->sidebar->getControl()->getScheduler()->removeSidebar(this);
-	this->page = NULL;
-
 	gtk_widget_destroy(this->widget);
 	this->widget = NULL;
+}
+
+void SidebarPreviewBaseEntry::attach(GtkLayout* layout, int x, int y)
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
 
+	if (this->widget == NULL)
+	{
+		createWidget();
+		gtk_layout_put(layout, getWidget(), x, y);
+	}
+	else if (this->x != x || this->y != y)
+	{
+		gtk_layout_move(layout, getWidget(), x, y);
+	}
+
+	this->x = x;
+	this->y = y;
+}
+
+void SidebarPreviewBaseEntry::detach()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
+
+	// Only attached previews are rendered, so there is neither a buffer nor a job
+	if (this->widget == NULL)
+	{
+		return;
+	}
+
+	// Drops a queued PreviewJob, waits only if the running job renders this preview
+	this->sidebar->getControl()->getScheduler()->removeSidebar(this);
+
+	destroyWidget();
+
+	g_mutex_lock(&this->drawingMutex);
 	if (this->crBuffer)
 	{
 		cairo_surface_destroy(this->crBuffer);
 		this->crBuffer = NULL;
 	}
-
-	XOJ_RELEASE_TYPE(SidebarPreviewBaseEntry);
+	g_mutex_unlock(&this->drawingMutex);
 }
 
 gboolean SidebarPreviewBaseEntry::drawCallback(GtkWidget* widget, cairo_t* cr, SidebarPreviewBaseEntry* preview)
@@ -71,13 +115,22 @@ void SidebarPreviewBaseEntry::setSelected(bool selected)
 	}
 	this->selected = selected;
 
-	gtk_widget_queue_draw(this->widget);
+	if (this->widget)
+	{
+		gtk_widget_queue_draw(this->widget);
+	}
 }
 
 void SidebarPreviewBaseEntry::repaint()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
 
+	// Previews without widget are rendered when they are attached again
+	if (this->widget == NULL)
+	{
+		return;
+	}
+
 	sidebar->getControl()->getScheduler()->addRepaintSidebar(this);
 }
 
@@ -85,10 +138,7 @@ void SidebarPreviewBaseEntry::drawLoadingPage()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
 
-	GtkAllocation alloc;
-	gtk_widget_get_allocation(widget, &alloc);
-
-	this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+	this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, getWidgetWidth(), getWidgetHeight());
 
 	double zoom = sidebar->getZoom();
 
@@ -170,7 +220,10 @@ void SidebarPreviewBaseEntry::updateSize()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewBaseEntry);
 
-	gtk_widget_set_size_request(this->widget, getWidgetWidth(), getWidgetHeight());
+	if (this->widget)
+	{
+		gtk_widget_set_size_request(this->widget, getWidgetWidth(), getWidgetHeight());
+	}
 }
 
 int SidebarPreviewBaseEntry::getWidgetWidth()
@@ -40,10 +40,23 @@ public:
 	virtual ~SidebarPreviewBaseEntry();
 
 public:
+	/**
+	 * The widget which is placed in the sidebar, NULL if the preview is not attached
+	 */
 	virtual GtkWidget* getWidget();
 	virtual int getWidth();
 	virtual int getHeight();
 
+	/**
+	 * Create the widget if the preview has none, and place it in the layout
+	 */
+	void attach(GtkLayout* layout, int x, int y);
+
+	/**
+	 * Destroy the widget and the buffer, used for previews which are not near the visible area
+	 */
+	void detach();
+
 	virtual void setSelected(bool selected);
 
 	virtual void repaint();
@@ -60,6 +73,12 @@ private:
 protected:
 	virtual void mouseButtonPressCallback() = 0;
 
+	/**
+	 * Create this->widget, the drawing area of the preview
+	 */
+	virtual void createWidget();
+	virtual void destroyWidget();
+
 	virtual int getWidgetWidth();
 	virtual int getWidgetHeight();
 
@@ -91,9 +110,15 @@ protected:
 	GMutex drawingMutex;
 
 	/**
-	 * The Widget which is used for drawing
+	 * The Widget which is used for drawing, NULL if not attached
+	 */
+	GtkWidget* widget = NULL;
+
+	/**
+	 * Position in the layout, if attached
 	 */
-	GtkWidget* widget;
+	int x = 0;
+	int y = 0;
 
 	/**
 	 * Buffer because of performance reasons
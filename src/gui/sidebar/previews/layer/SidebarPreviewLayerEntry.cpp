@@ -9,11 +9,46 @@
 SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar, PageRef page, int layer, size_t index)
  : SidebarPreviewBaseEntry(sidebar, page),
    index(index),
-   layer(layer),
-   box(gtk_box_new(GTK_ORIENTATION_VERTICAL, 2))
+   layer(layer)
 {
 	XOJ_INIT_TYPE(SidebarPreviewLayerEntry);
 
+	toolbarHeight = getToolbarHeight();
+}
+
+SidebarPreviewLayerEntry::~SidebarPreviewLayerEntry()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewLayerEntry);
+
+	// Needs to be done here, the base class cannot call destroyWidget() of this class
+	detach();
+
+	XOJ_RELEASE_TYPE(SidebarPreviewLayerEntry);
+}
+
+int SidebarPreviewLayerEntry::getToolbarHeight()
+{
+	static int toolbarHeight = -1;
+	if (toolbarHeight == -1)
+	{
+		GtkWidget* cb = gtk_check_button_new_with_label(_("Background"));
+		g_object_ref_sink(cb);
+		gtk_widget_get_preferred_height(cb, NULL, &toolbarHeight);
+		g_object_unref(cb);
+
+		toolbarHeight += Shadow::getShadowTopLeftSize() + 20;
+	}
+
+	return toolbarHeight;
+}
+
+void SidebarPreviewLayerEntry::createWidget()
+{
+	XOJ_CHECK_TYPE(SidebarPreviewLayerEntry);
+
+	SidebarPreviewBaseEntry::createWidget();
+
+	box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
 	GtkWidget* toolbar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL,6);
 
 	string text;
@@ -27,6 +62,7 @@ SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar,
 	}
 
 	cbVisible = gtk_check_button_new_with_label(text.c_str());
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cbVisible), layerVisible);
 
 	g_signal_connect(cbVisible, "toggled", G_CALLBACK(
 		+[](GtkToggleButton* source, SidebarPreviewLayerEntry* self)
@@ -48,18 +84,17 @@ SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar,
 	gtk_container_add(GTK_CONTAINER(box), toolbar);
 
 	gtk_widget_show_all(box);
-
-	toolbarHeight = gtk_widget_get_allocated_height(cbVisible) + Shadow::getShadowTopLeftSize() + 20;
 }
 
-SidebarPreviewLayerEntry::~SidebarPreviewLayerEntry()
+void SidebarPreviewLayerEntry::destroyWidget()
 {
 	XOJ_CHECK_TYPE(SidebarPreviewLayerEntry);
 
+	// Also destroys the preview widget
 	gtk_widget_destroy(this->box);
 	this->box = NULL;
-
-	XOJ_RELEASE_TYPE(SidebarPreviewLayerEntry);
+	this->cbVisible = NULL;
+	this->widget = NULL;
 }
 
 void SidebarPreviewLayerEntry::checkboxToggled()
@@ -72,6 +107,7 @@ void SidebarPreviewLayerEntry::checkboxToggled()
 	}
 
 	bool check = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(cbVisible));
+	layerVisible = check;
 	((SidebarPreviewLayers*)sidebar)->layerVisibilityChanged(layer + 1, check);
 }
 
@@ -117,6 +153,12 @@ void SidebarPreviewLayerEntry::setVisibleCheckbox(bool enabled)
 {
 	XOJ_CHECK_TYPE(SidebarPreviewLayerEntry);
 
+	layerVisible = enabled;
+	if (cbVisible == NULL)
+	{
+		return;
+	}
+
 	inUpdate = true;
 
 	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(cbVisible), enabled);
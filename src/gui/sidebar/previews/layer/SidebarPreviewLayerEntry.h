@@ -45,8 +45,16 @@ public:
 
 protected:
 	virtual void mouseButtonPressCallback();
+	virtual void createWidget();
+	virtual void destroyWidget();
 	void checkboxToggled();
 
+private:
+	/**
+	 * Height of the checkbox row below the preview, the same for all layers
+	 */
+	static int getToolbarHeight();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -66,15 +74,20 @@ private:
 	int toolbarHeight = 0;
 
 	/**
-	 * Container box for the preview and the button
+	 * Container box for the preview and the button, NULL if not attached
 	 */
-	GtkWidget* box;
+	GtkWidget* box = NULL;
 
 	/**
 	 * Visible checkbox
 	 */
 	GtkWidget* cbVisible = NULL;
 
+	/**
+	 * State of the visible checkbox, also if the widget does not exist
+	 */
+	bool layerVisible = true;
+
 	/**
 	 * Ignore events
 	 */
@@ -142,9 +142,7 @@ void SidebarPreviewLayers::updatePreviews()
 	size_t index = 0;
 	for (int i = layerCount; i >= 0; i--)
 	{
-		SidebarPreviewBaseEntry* p = new SidebarPreviewLayerEntry(this, page, i - 1, index++);
-		this->previews.push_back(p);
-		gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
+		this->previews.push_back(new SidebarPreviewLayerEntry(this, page, i - 1, index++));
 	}
 
 	layout();
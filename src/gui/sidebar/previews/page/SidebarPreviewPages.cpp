@@ -158,9 +158,7 @@ void SidebarPreviewPages::updatePreviews()
 
 	for (size_t i = 0; i < len; i++)
 	{
-		SidebarPreviewBaseEntry* p = new SidebarPreviewPageEntry(this, doc->getPage(i));
-		this->previews.push_back(p);
-		gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
+		this->previews.push_back(new SidebarPreviewPageEntry(this, doc->getPage(i)));
 	}
 
 	layout();
@@ -226,8 +224,6 @@ void SidebarPreviewPages::pageInserted(size_t page)
 
 	this->previews.insert(this->previews.begin() + page, p);
 
-	gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
-
 	// Unselect page, to prevent double selection displaying
 	unselectPage();
 
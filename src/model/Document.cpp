@@ -1,6 +1,7 @@
 #include "Document.h"
 
 #include "pdf/base/XojPdfAction.h"
+#include "pdf/base/XojPdfPageSizeCache.h"
 
 #include "LinkDestination.h"
 #include "XojPage.h"
@@ -38,6 +39,7 @@ void Document::freeTreeContentModel()
 		g_object_unref(this->contentsModel);
 		this->contentsModel = NULL;
 	}
+	this->contentsModelBuilt = false;
 }
 
 bool Document::freeTreeContentEntry(GtkTreeModel* treeModel, GtkTreePath* path, GtkTreeIter* iter, Document* doc)
@@ -320,6 +322,7 @@ void Document::buildContentsModel()
 	XOJ_CHECK_TYPE(Document);
 
 	freeTreeContentModel();
+	this->contentsModelBuilt = true;
 
 	XojPdfBookmarkIterator* iter = pdfDocument.getContentsIter();
 	if (iter == NULL)
@@ -333,13 +336,39 @@ void Document::buildContentsModel()
 	delete iter;
 }
 
+/**
+ * The model is built on the first call, for PDFs with a huge outline
+ * nothing is done until the index is shown
+ */
 GtkTreeModel* Document::getContentsModel()
 {
 	XOJ_CHECK_TYPE(Document);
 
+	if (!this->contentsModelBuilt)
+	{
+		buildContentsModel();
+		updateIndexPageNumbers();
+	}
+
 	return this->contentsModel;
 }
 
+bool Document::hasContents()
+{
+	XOJ_CHECK_TYPE(Document);
+
+	if (this->contentsModelBuilt)
+	{
+		return this->contentsModel != NULL;
+	}
+
+	XojPdfBookmarkIterator* iter = pdfDocument.getContentsIter();
+	bool contents = iter != NULL;
+	delete iter;
+
+	return contents;
+}
+
 bool Document::fillPageLabels(GtkTreeModel* treeModel, GtkTreePath* path, GtkTreeIter* iter, Document* doc)
 {
 	XojLinkDest* link = NULL;
@@ -350,12 +379,12 @@ bool Document::fillPageLabels(GtkTreeModel* treeModel, GtkTreePath* path, GtkTre
 		return false;
 	}
 
-	int page = doc->findPdfPage(link->dest->getPdfPage());
+	size_t pdfPage = link->dest->getPdfPage();
 
 	gchar* pageLabel = NULL;
-	if (page != -1)
+	if (pdfPage < doc->pdfPageIndex.size() && doc->pdfPageIndex[pdfPage] != size_t_npos)
 	{
-		pageLabel = g_strdup_printf("%i", page + 1);
+		pageLabel = g_strdup_printf("%" G_GSIZE_FORMAT, doc->pdfPageIndex[pdfPage] + 1);
 	}
 	gtk_tree_store_set(GTK_TREE_STORE(treeModel), iter, DOCUMENT_LINKS_COLUMN_PAGE_NUMBER, pageLabel, -1);
 	g_free(pageLabel);
@@ -364,14 +393,37 @@ bool Document::fillPageLabels(GtkTreeModel* treeModel, GtkTreePath* path, GtkTre
 	return false;
 }
 
+/**
+ * Does nothing as long as the contents model is not built, the first page of every
+ * PDF page is looked up once, and not once per bookmark
+ */
 void Document::updateIndexPageNumbers()
 {
 	XOJ_CHECK_TYPE(Document);
 
-	if (this->contentsModel != NULL)
+	if (this->contentsModel == NULL)
 	{
-		gtk_tree_model_foreach(this->contentsModel, (GtkTreeModelForeachFunc) fillPageLabels, this);
+		return;
+	}
+
+	this->pdfPageIndex.assign(pdfDocument.getPageCount(), size_t_npos);
+	for (size_t i = 0; i < this->pages.size(); i++)
+	{
+		PageRef p = this->pages[i];
+		if (p->getBackgroundType().isPdfPage())
+		{
+			size_t pdfPage = p->getPdfPageNr();
+			if (pdfPage < this->pdfPageIndex.size() && this->pdfPageIndex[pdfPage] == size_t_npos)
+			{
+				this->pdfPageIndex[pdfPage] = i;
+			}
+		}
 	}
+
+	gtk_tree_model_foreach(this->contentsModel, (GtkTreeModelForeachFunc) fillPageLabels, this);
+
+	this->pdfPageIndex.clear();
+	this->pdfPageIndex.shrink_to_fit();
 }
 
 bool Document::readPdf(Path filename, bool initPages, bool attachToDocument, gpointer data, gsize length)
@@ -410,25 +462,42 @@ bool Document::readPdf(Path filename, bool initPages, bool attachToDocument, gpo
 
 	lastError = "";
 
+	// The outline is read again when it's shown the next time
+	freeTreeContentModel();
+
 	if (initPages)
 	{
 		this->pages.clear();
-	}
 
-	if (initPages)
-	{
-		for (size_t i = 0; i < pdfDocument.getPageCount(); i++)
+		// Only the page sizes are needed here, the poppler pages are created when they are rendered
+		size_t pageCount = pdfDocument.getPageCount();
+		vector<double> sizes;
+		bool cached = data == nullptr && XojPdfPageSizeCache::load(filename, pageCount, sizes);
+		if (!cached)
 		{
-			XojPdfPageSPtr page = pdfDocument.getPage(i);
-			PageRef p = new XojPage(page->getWidth(), page->getHeight());
+			sizes.resize(pageCount * 2);
+			for (size_t i = 0; i < pageCount; i++)
+			{
+				XojPdfPageSPtr page = pdfDocument.getPage(i);
+				sizes[i * 2] = page->getWidth();
+				sizes[i * 2 + 1] = page->getHeight();
+			}
+
+			if (data == nullptr)
+			{
+				XojPdfPageSizeCache::save(filename, sizes);
+			}
+		}
+
+		this->pages.reserve(pageCount);
+		for (size_t i = 0; i < pageCount; i++)
+		{
+			PageRef p = new XojPage(sizes[i * 2], sizes[i * 2 + 1]);
 			p->setBackgroundPdfPageNr(i);
-			addPage(p);
+			this->pages.push_back(p);
 		}
 	}
 
-	buildContentsModel();
-	updateIndexPageNumbers();
-
 	unlock();
 
 	this->handler->fireDocumentChanged(DOCUMENT_CHANGE_PDF_BOOKMARKS);
@@ -543,7 +612,7 @@ void Document::operator=(Document& doc)
 
 	clearDocument();
 
-	// Copy PDF Document
+	// Copy PDF Document, the outline is read again when it's shown the next time
 	this->pdfDocument = doc.pdfDocument;
 
 	this->password = doc.password;
@@ -557,9 +626,6 @@ void Document::operator=(Document& doc)
 		addPage(p);
 	}
 
-	buildContentsModel();
-	updateIndexPageNumbers();
-
 	bool lastLock = tryLock();
 	unlock();
 	this->handler->fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
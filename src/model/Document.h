@@ -76,6 +76,11 @@ public:
 
 	GtkTreeModel* getContentsModel();
 
+	/**
+	 * @return true if the PDF has an outline, without building the contents model
+	 */
+	bool hasContents();
+
 	void setCreateBackupOnSave(bool backup);
 	bool shouldCreateBackupOnSave();
 
@@ -128,6 +133,16 @@ private:
 	 */
 	GtkTreeModel* contentsModel = NULL;
 
+	/**
+	 * The contents model is built on the first access
+	 */
+	bool contentsModelBuilt = false;
+
+	/**
+	 * The first page of each PDF page, only filled while the page labels are updated
+	 */
+	vector<size_t> pdfPageIndex;
+
 	/**
 	 *  create a backup before save, because the original file was an older fileversion
 	 */
@@ -83,7 +83,7 @@ void Image::setImage(string data)
 		cairo_surface_destroy(this->image);
 		this->image = NULL;
 	}
-	this->data = data;
+	this->data = std::move(data);
 }
 
 void Image::setImage(GdkPixbuf* img)
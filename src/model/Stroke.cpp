@@ -1,10 +1,14 @@
 #include "Stroke.h"
 
+#include "StrokeSegmentTree.h"
+#include "eraser/EraserCapsule.h"
+
 #include <serializing/ObjectInputStream.h>
 #include <serializing/ObjectOutputStream.h>
 
 #include <i18n.h>
 
+#include <algorithm>
 #include <cmath>
 
 Stroke::Stroke()
@@ -17,6 +21,8 @@ Stroke::~Stroke()
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	g_free(this->points);
 	this->points = NULL;
 	this->pointCount = 0;
@@ -85,6 +91,8 @@ void Stroke::readSerialized(ObjectInputStream& in)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	in.readObject("Stroke");
 
 	readSerializedAudioElement(in);
@@ -99,6 +107,7 @@ void Stroke::readSerialized(ObjectInputStream& in)
 	this->points = NULL;
 	this->pointCount = 0;
 	in.readData((void**) &this->points, &this->pointCount);
+	this->pointAllocCount = this->pointCount;
 
 	this->lineStyle.readSerialized(in);
 
@@ -169,6 +178,8 @@ void Stroke::setFirstPoint(double x, double y)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointCount > 0)
 	{
 		Point& p = this->points[0];
@@ -182,6 +193,8 @@ void Stroke::setLastPoint(double x, double y)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointCount > 0)
 	{
 		Point& p = this->points[this->pointCount - 1];
@@ -200,6 +213,8 @@ void Stroke::addPoint(Point p)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointCount >= this->pointAllocCount - 1)
 	{
 		this->allocPointSize(this->pointAllocCount + 100);
@@ -212,6 +227,8 @@ void Stroke::allocPointSize(int size)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	this->pointAllocCount = size;
 	this->points = (Point*) g_realloc(this->points, this->pointAllocCount * sizeof(Point));
 }
@@ -234,6 +251,8 @@ void Stroke::deletePointsFrom(int index)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointCount <= index)
 	{
 		return;
@@ -245,6 +264,8 @@ void Stroke::deletePoint(int index)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointCount <= index)
 	{
 		return;
@@ -283,6 +304,8 @@ void Stroke::freeUnusedPointItems()
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	if (this->pointAllocCount == this->pointCount)
 	{
 		return;
@@ -323,6 +346,8 @@ void Stroke::move(double dx, double dy)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	for (int i = 0; i < pointCount; i++)
 	{
 		points[i].x += dx;
@@ -335,6 +360,8 @@ void Stroke::move(double dx, double dy)
 void Stroke::rotate(double x0, double y0, double xo, double yo, double th)
 {
 	XOJ_CHECK_TYPE(Stroke);
+
+	invalidateSegmentTree();
 	
 	for (int i = 0; i < this->pointCount; i++)
 	{
@@ -342,7 +369,7 @@ void Stroke::rotate(double x0, double y0, double xo, double yo, double th)
 
 		p.x -= x0;	//move to origin
 		p.y -= y0;
-		double offset = 0.7; // __DBL_EPSILON__;
+		double offset = STROKE_ROTATE_OFFSET; // __DBL_EPSILON__;
 		p.x -= xo-offset;	//center to origin
 		p.y -= yo-offset;
 
@@ -365,6 +392,8 @@ void Stroke::scale(double x0, double y0, double fx, double fy)
 {
 	XOJ_CHECK_TYPE(Stroke);
 
+	invalidateSegmentTree();
+
 	double fz = sqrt(fx * fy);
 
 	for (int i = 0; i < this->pointCount; i++)
@@ -389,6 +418,71 @@ void Stroke::scale(double x0, double y0, double fx, double fy)
 	this->sizeCalculated = false;
 }
 
+void Stroke::transform(const cairo_matrix_t& matrix, double widthFactor)
+{
+	XOJ_CHECK_TYPE(Stroke);
+
+	invalidateSegmentTree();
+
+	if (this->pointCount == 0)
+	{
+		return;
+	}
+
+	// Local copies, so the compiler knows they don't alias the points
+	const double xx = matrix.xx;
+	const double xy = matrix.xy;
+	const double yx = matrix.yx;
+	const double yy = matrix.yy;
+	const double x0 = matrix.x0;
+	const double y0 = matrix.y0;
+
+	Point* p = this->points;
+	const int count = this->pointCount;
+
+	double minX = xx * p[0].x + xy * p[0].y + x0;
+	double minY = yx * p[0].x + yy * p[0].y + y0;
+	double maxX = minX;
+	double maxY = minY;
+
+	// No branches in the loop, so it can be vectorized
+	for (int i = 0; i < count; i++)
+	{
+		double px = p[i].x;
+		double py = p[i].y;
+
+		double nx = xx * px + xy * py + x0;
+		double ny = yx * px + yy * py + y0;
+
+		p[i].x = nx;
+		p[i].y = ny;
+
+		minX = std::min(minX, nx);
+		maxX = std::max(maxX, nx);
+		minY = std::min(minY, ny);
+		maxY = std::max(maxY, ny);
+	}
+
+	if (widthFactor != 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (p[i].z != Point::NO_PRESSURE)
+			{
+				p[i].z *= widthFactor;
+			}
+		}
+		this->width *= widthFactor;
+	}
+
+	// Same as calcSize
+	Element::x = minX - 2;
+	Element::y = minY - 2;
+	Element::width = maxX - minX + 4 + this->width;
+	Element::height = maxY - minY + 4 + this->width;
+	this->sizeCalculated = true;
+}
+
 bool Stroke::hasPressure() const
 {
 	XOJ_CHECK_TYPE(Stroke);
@@ -473,7 +567,26 @@ bool Stroke::intersects(double x, double y, double halfEraserSize)
 }
 
 /**
- * split index is the split point, minimimum is 1 NOT 0
+ * Distance of (x, y) to the segment a - b
+ */
+static double segmentDistance(const Point& a, const Point& b, double x, double y)
+{
+	double dx = b.x - a.x;
+	double dy = b.y - a.y;
+	double len2 = dx * dx + dy * dy;
+
+	double t = 0;
+	if (len2 > 0)
+	{
+		t = std::max(0.0, std::min(1.0, ((x - a.x) * dx + (y - a.y) * dy) / len2));
+	}
+
+	return hypot(a.x + t * dx - x, a.y + t * dy - y);
+}
+
+/**
+ * The stroke is hit if a segment passes within halfEraserSize or a point is within
+ * the square around x / y. gap is set to the distance of the nearest segment.
  */
 bool Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
 {
@@ -489,61 +602,93 @@ bool Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
 	double y1 = y - halfEraserSize;
 	double y2 = y + halfEraserSize;
 
-	double lastX = points[0].x;
-	double lastY = points[0].y;
-	for (int i = 1; i < pointCount; i++)
+	if (this->pointCount == 1)
 	{
-		double px = points[i].x;
-		double py = points[i].y;
-
-		if (px >= x1 && py >= y1 && px <= x2 && py <= y2)
+		const Point& p = this->points[0];
+		if (p.x >= x1 && p.y >= y1 && p.x <= x2 && p.y <= y2)
 		{
 			if (gap)
 			{
-				*gap = 0;
+				*gap = hypot(p.x - x, p.y - y);
 			}
 			return true;
 		}
+		return false;
+	}
 
-		double len = hypot(px - lastX, py - lastY);
-		if (len >= halfEraserSize)
-		{
-			/**
-			 * The normale to a vector, the padding to a point
-			 */
-			double p = ABS((x - lastX) * (lastY - py) + (y - lastY) * (px - lastX)) / hypot(lastX - x, lastY - y);
+	bool found = false;
+	double minDistance = 0;
 
-			// The space to the line is in the range, but it can also be parallel
-			// and not enough close, so calculate a "circle" with the center on the
-			// center of the line
+	// Segments outside the square cannot be hit
+	getSegmentTree()->findSegments(x1, y1, x2, y2, [&](int i)
+	{
+		const Point& a = this->points[i];
+		const Point& b = this->points[i + 1];
 
-			if (p <= halfEraserSize)
-			{
-				double centerX = (lastX + x) / 2;
-				double centerY = (lastY + y) / 2;
-				double distance = hypot(x - centerX, y - centerY);
-
-				// we should calculate the length of the line within the rectangle, to find out
-				// the distance from the border to the point, but the stroken are not rectangular
-				// so we can do it simpler
-				distance -= hypot((x2 - x1) / 2, (y2 - y1) / 2);
-
-				if (distance <= (len / 2) + 0.1)
-				{
-					if (gap)
-					{
-						*gap = distance;
-					}
-					return true;
-				}
-			}
+		double distance = segmentDistance(a, b, x, y);
+		bool hit = distance <= halfEraserSize ||
+		           (a.x >= x1 && a.y >= y1 && a.x <= x2 && a.y <= y2) ||
+		           (b.x >= x1 && b.y >= y1 && b.x <= x2 && b.y <= y2);
+
+		if (hit && (!found || distance < minDistance))
+		{
+			found = true;
+			minDistance = distance;
 		}
 
-		lastX = px;
-		lastY = py;
+		// Only search on if the nearest segment is needed
+		return found && gap == NULL;
+	});
+
+	if (found && gap)
+	{
+		*gap = minDistance;
 	}
 
-	return false;
+	return found;
+}
+
+bool Stroke::intersects(const EraserCapsule& capsule)
+{
+	XOJ_CHECK_TYPE(Stroke);
+
+	if (this->pointCount < 1)
+	{
+		return false;
+	}
+
+	if (this->pointCount == 1)
+	{
+		return capsule.intersectsSegment(points[0], points[0]);
+	}
+
+	return getSegmentTree()->findSegments(capsule.getX(), capsule.getY(), capsule.getX2(), capsule.getY2(), [&](int i)
+	{
+		return capsule.intersectsSegment(this->points[i], this->points[i + 1]);
+	});
+}
+
+/**
+ * The segment tree is built on the first hit test after the points changed
+ */
+StrokeSegmentTree* Stroke::getSegmentTree()
+{
+	XOJ_CHECK_TYPE(Stroke);
+
+	if (this->segmentTree == NULL)
+	{
+		this->segmentTree = new StrokeSegmentTree(this->points, this->pointCount);
+	}
+
+	return this->segmentTree;
+}
+
+void Stroke::invalidateSegmentTree()
+{
+	XOJ_CHECK_TYPE(Stroke);
+
+	delete this->segmentTree;
+	this->segmentTree = NULL;
 }
 
 /**
@@ -23,7 +23,14 @@ enum StrokeTool
 	STROKE_TOOL_PEN, STROKE_TOOL_ERASER, STROKE_TOOL_HIGHLIGHTER
 };
 
+/**
+ * Stroke::rotate moves the rotation center by this offset
+ */
+#define STROKE_ROTATE_OFFSET 0.7
+
 class EraseableStroke;
+class EraserCapsule;
+class StrokeSegmentTree;
 
 class Stroke : public AudioElement
 {
@@ -83,6 +90,11 @@ public:
 	bool intersects(double x, double y, double halfSize) override;
 	bool intersects(double x, double y, double halfSize, double* gap) override;
 
+	/**
+	 * @return true if any segment touches the area swept by the eraser
+	 */
+	bool intersects(const EraserCapsule& capsule);
+
 	void setPressure(const vector<double>& pressure);
 	void setLastPressure(double pressure);
 	void clearPressure();
@@ -95,6 +107,13 @@ public:
 	virtual void scale(double x0, double y0, double fx, double fy);
 	virtual void rotate(double x0, double y0, double xo, double yo, double th);
 
+	/**
+	 * Apply an affine transformation to all points and update the size in the same pass
+	 *
+	 * @param widthFactor The stroke width and pressure are multiplied with this factor
+	 */
+	void transform(const cairo_matrix_t& matrix, double widthFactor);
+
 	virtual bool isInSelection(ShapeContainer* container);
 
 	EraseableStroke* getEraseable();
@@ -111,6 +130,10 @@ protected:
 	virtual void calcSize();
 	void allocPointSize(int size);
 
+private:
+	StrokeSegmentTree* getSegmentTree();
+	void invalidateSegmentTree();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -124,6 +147,12 @@ private:
 	int pointCount = 0;
 	int pointAllocCount = 0;
 
+	/**
+	 * Bounding box hierarchy for hit tests, built on demand
+	 * and deleted if the points are changed
+	 */
+	StrokeSegmentTree* segmentTree = NULL;
+
 	/**
 	 * Dashed line
 	 */
@@ -0,0 +1,74 @@
+#include "StrokeSegmentTree.h"
+
+#include <algorithm>
+
+StrokeSegmentTree::StrokeSegmentTree(const Point* points, int pointCount)
+ : points(points)
+{
+	XOJ_INIT_TYPE(StrokeSegmentTree);
+
+	int segments = pointCount - 1;
+	if (segments < 1)
+	{
+		return;
+	}
+
+	this->nodes.reserve(2 * (segments / STROKE_SEGMENT_TREE_LEAF_SIZE + 1));
+	build(0, segments);
+}
+
+StrokeSegmentTree::~StrokeSegmentTree()
+{
+	XOJ_RELEASE_TYPE(StrokeSegmentTree);
+}
+
+/**
+ * Build the node for the segments [first, last) and its children,
+ * the segments are split in the middle, consecutive segments are
+ * usually also near each other on the page
+ *
+ * @return The index of the node
+ */
+int StrokeSegmentTree::build(int first, int last)
+{
+	XOJ_CHECK_TYPE(StrokeSegmentTree);
+
+	int index = (int) this->nodes.size();
+	this->nodes.push_back(StrokeSegmentTreeNode());
+
+	StrokeSegmentTreeNode node;
+	node.first = first;
+	node.last = last;
+	node.second = -1;
+
+	if (last - first <= STROKE_SEGMENT_TREE_LEAF_SIZE)
+	{
+		node.x1 = node.x2 = this->points[first].x;
+		node.y1 = node.y2 = this->points[first].y;
+
+		for (int i = first + 1; i <= last; i++)
+		{
+			node.x1 = std::min(node.x1, this->points[i].x);
+			node.y1 = std::min(node.y1, this->points[i].y);
+			node.x2 = std::max(node.x2, this->points[i].x);
+			node.y2 = std::max(node.y2, this->points[i].y);
+		}
+	}
+	else
+	{
+		int middle = first + (last - first) / 2;
+		build(first, middle);
+		node.second = build(middle, last);
+
+		// The vector may be reallocated while the children are built
+		const StrokeSegmentTreeNode& a = this->nodes[index + 1];
+		const StrokeSegmentTreeNode& b = this->nodes[node.second];
+		node.x1 = std::min(a.x1, b.x1);
+		node.y1 = std::min(a.y1, b.y1);
+		node.x2 = std::max(a.x2, b.x2);
+		node.y2 = std::max(a.y2, b.y2);
+	}
+
+	this->nodes[index] = node;
+	return index;
+}
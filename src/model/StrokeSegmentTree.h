@@ -0,0 +1,128 @@
+/*
+ * Xournal++
+ *
+ * Bounding box hierarchy over the segments of a stroke, so long strokes
+ * don't need to test every segment for a hit
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Point.h"
+
+#include <XournalType.h>
+
+#include <algorithm>
+#include <vector>
+using std::vector;
+
+/**
+ * Maximum count of segments in a leaf node
+ */
+#define STROKE_SEGMENT_TREE_LEAF_SIZE 8
+
+class StrokeSegmentTreeNode
+{
+public:
+	double x1;
+	double y1;
+	double x2;
+	double y2;
+
+	/**
+	 * The node contains the segments [first, last), segment i
+	 * goes from point i to point i + 1
+	 */
+	int first;
+	int last;
+
+	/**
+	 * Index of the second child, the first child directly follows
+	 * the node. -1 for leaf nodes.
+	 */
+	int second;
+};
+
+class StrokeSegmentTree
+{
+public:
+	StrokeSegmentTree(const Point* points, int pointCount);
+	virtual ~StrokeSegmentTree();
+
+private:
+	StrokeSegmentTree(const StrokeSegmentTree& tree);
+	void operator=(const StrokeSegmentTree& tree);
+
+public:
+	/**
+	 * Call fn(int segment) for each segment which bounding box intersects
+	 * the area x1, y1, x2, y2. Stops if fn returns true.
+	 *
+	 * @return true if fn returned true
+	 */
+	template <class SegmentFunction>
+	bool findSegments(double x1, double y1, double x2, double y2, SegmentFunction fn) const
+	{
+		if (this->nodes.empty())
+		{
+			return false;
+		}
+
+		// The tree is balanced, so the depth is limited by log2 of the point count
+		int stack[64];
+		int depth = 0;
+		stack[depth++] = 0;
+
+		while (depth > 0)
+		{
+			int index = stack[--depth];
+			const StrokeSegmentTreeNode& node = this->nodes[index];
+			if (node.x2 < x1 || node.x1 > x2 || node.y2 < y1 || node.y1 > y2)
+			{
+				continue;
+			}
+
+			if (node.second != -1)
+			{
+				stack[depth++] = node.second;
+				stack[depth++] = index + 1;
+				continue;
+			}
+
+			for (int i = node.first; i < node.last; i++)
+			{
+				const Point& a = this->points[i];
+				const Point& b = this->points[i + 1];
+				if (std::max(a.x, b.x) < x1 || std::min(a.x, b.x) > x2 ||
+				    std::max(a.y, b.y) < y1 || std::min(a.y, b.y) > y2)
+				{
+					continue;
+				}
+
+				if (fn(i))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+private:
+	int build(int first, int last);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	/**
+	 * The points of the stroke, owned by the stroke
+	 */
+	const Point* points;
+
+	vector<StrokeSegmentTreeNode> nodes;
+};
@@ -4,6 +4,26 @@
 #include <serializing/ObjectInputStream.h>
 #include <serializing/ObjectOutputStream.h>
 
+#include <cmath>
+#include <list>
+
+/**
+ * Memory for all cached PDF rasters, in bytes
+ */
+#define TEXIMAGE_RASTER_CACHE_SIZE (64 * 1024 * 1024)
+
+/**
+ * Maximum width / height of a raster, larger formulas are rendered as vector
+ */
+#define TEXIMAGE_RASTER_MAX_SIZE 4096
+
+/**
+ * All TexImages with a PDF raster, the most recently used first
+ */
+static std::list<TexImage*> rasterCache;
+static size_t rasterCacheSize = 0;
+static GMutex rasterCacheLock;
+
 TexImage::TexImage()
  : Element(ELEMENT_TEXIMAGE)
 {
@@ -28,6 +48,8 @@ void TexImage::freeImageAndPdf()
 {
 	XOJ_CHECK_TYPE(TexImage);
 
+	freePdfRaster();
+
 	if (this->image)
 	{
 		cairo_surface_destroy(this->image);
@@ -76,6 +98,7 @@ void TexImage::setWidth(double width)
 	XOJ_CHECK_TYPE(TexImage);
 
 	this->width = width;
+	freePdfRaster();
 }
 
 void TexImage::setHeight(double height)
@@ -83,6 +106,7 @@ void TexImage::setHeight(double height)
 	XOJ_CHECK_TYPE(TexImage);
 
 	this->height = height;
+	freePdfRaster();
 }
 
 cairo_status_t TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length)
@@ -108,7 +132,7 @@ void TexImage::setBinaryData(string binaryData)
 {
 	XOJ_CHECK_TYPE(TexImage);
 
-	this->binaryData = binaryData;
+	this->binaryData = std::move(binaryData);
 }
 
 /**
@@ -207,6 +231,8 @@ void TexImage::setPdf(PopplerDocument* pdf)
 {
 	XOJ_CHECK_TYPE(TexImage);
 
+	freePdfRaster();
+
 	if (this->pdf != NULL)
 	{
 		g_object_unref(this->pdf);
@@ -221,6 +247,108 @@ void TexImage::setPdf(PopplerDocument* pdf)
 	}
 }
 
+/**
+ * Remove the cached raster of the PDF
+ */
+void TexImage::freePdfRaster()
+{
+	XOJ_CHECK_TYPE(TexImage);
+
+	g_mutex_lock(&rasterCacheLock);
+
+	if (this->pdfRaster)
+	{
+		rasterCache.remove(this);
+		rasterCacheSize -= cairo_image_surface_get_stride(this->pdfRaster) * cairo_image_surface_get_height(this->pdfRaster);
+
+		cairo_surface_destroy(this->pdfRaster);
+		this->pdfRaster = NULL;
+		this->pdfRasterScale = 0;
+	}
+
+	g_mutex_unlock(&rasterCacheLock);
+}
+
+cairo_surface_t* TexImage::getPdfRaster(double scale)
+{
+	XOJ_CHECK_TYPE(TexImage);
+
+	g_mutex_lock(&rasterCacheLock);
+	if (this->pdfRaster && this->pdfRasterScale >= scale)
+	{
+		// Move to the front, this is the most recently used raster
+		rasterCache.remove(this);
+		rasterCache.push_front(this);
+
+		cairo_surface_t* raster = cairo_surface_reference(this->pdfRaster);
+		g_mutex_unlock(&rasterCacheLock);
+		return raster;
+	}
+	g_mutex_unlock(&rasterCacheLock);
+
+	PopplerDocument* pdf = getPdf();
+	if (pdf == NULL || poppler_document_get_n_pages(pdf) < 1)
+	{
+		return NULL;
+	}
+
+	// Zoom buckets of sqrt(2), so zooming does not render the formula again for every step
+	double bucket = std::pow(2.0, std::ceil(std::log2(scale) * 2) / 2);
+
+	int rasterWidth = (int) std::ceil(this->width * bucket);
+	int rasterHeight = (int) std::ceil(this->height * bucket);
+	if (rasterWidth < 1 || rasterHeight < 1 || rasterWidth > TEXIMAGE_RASTER_MAX_SIZE || rasterHeight > TEXIMAGE_RASTER_MAX_SIZE)
+	{
+		return NULL;
+	}
+
+	PopplerPage* page = poppler_document_get_page(pdf, 0);
+
+	double pageWidth = 0;
+	double pageHeight = 0;
+	poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+	cairo_surface_t* raster = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, rasterWidth, rasterHeight);
+	cairo_t* cr = cairo_create(raster);
+	cairo_scale(cr, rasterWidth / pageWidth, rasterHeight / pageHeight);
+	poppler_page_render(page, cr);
+	cairo_destroy(cr);
+
+	g_object_unref(page);
+
+	size_t rasterSize = cairo_image_surface_get_stride(raster) * rasterHeight;
+
+	g_mutex_lock(&rasterCacheLock);
+
+	if (this->pdfRaster)
+	{
+		rasterCache.remove(this);
+		rasterCacheSize -= cairo_image_surface_get_stride(this->pdfRaster) * cairo_image_surface_get_height(this->pdfRaster);
+		cairo_surface_destroy(this->pdfRaster);
+	}
+
+	this->pdfRaster = cairo_surface_reference(raster);
+	this->pdfRasterScale = bucket;
+	rasterCache.push_front(this);
+	rasterCacheSize += rasterSize;
+
+	// Free the least recently used rasters, but always keep this one
+	while (rasterCacheSize > TEXIMAGE_RASTER_CACHE_SIZE && rasterCache.size() > 1)
+	{
+		TexImage* img = rasterCache.back();
+		rasterCache.pop_back();
+
+		rasterCacheSize -= cairo_image_surface_get_stride(img->pdfRaster) * cairo_image_surface_get_height(img->pdfRaster);
+		cairo_surface_destroy(img->pdfRaster);
+		img->pdfRaster = NULL;
+		img->pdfRasterScale = 0;
+	}
+
+	g_mutex_unlock(&rasterCacheLock);
+
+	return raster;
+}
+
 void TexImage::scale(double x0, double y0, double fx, double fy)
 {
 	XOJ_CHECK_TYPE(TexImage);
@@ -234,6 +362,8 @@ void TexImage::scale(double x0, double y0, double fx, double fy)
 
 	this->width *= fx;
 	this->height *= fy;
+
+	freePdfRaster();
 }
 
 void TexImage::rotate(double x0, double y0, double xo, double yo, double th)
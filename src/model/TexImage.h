@@ -56,6 +56,16 @@ public:
 	 */
 	void setPdf(PopplerDocument* pdf);
 
+	/**
+	 * Returns a raster of the PDF for a resolution of at least scale pixel per point.
+	 * The raster is cached and reused for smaller scales, all rasters together are
+	 * limited to TEXIMAGE_RASTER_CACHE_SIZE, the least recently used are freed first.
+	 *
+	 * @return A referenced image surface of the full element, NULL if this is not a PDF
+	 *         or the raster would be too large
+	 */
+	cairo_surface_t* getPdfRaster(double scale);
+
 	virtual void scale(double x0, double y0, double fx, double fy);
 	virtual void rotate(double x0, double y0, double xo, double yo, double th);
 
@@ -85,6 +95,11 @@ private:
 	 */
 	void loadBinaryData();
 
+	/**
+	 * Remove the cached raster of the PDF
+	 */
+	void freePdfRaster();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -98,6 +113,13 @@ private:
 	 */
 	cairo_surface_t* image = NULL;
 
+	/**
+	 * Cached raster of the PDF and its resolution in pixel per point,
+	 * protected by the global raster cache lock
+	 */
+	cairo_surface_t* pdfRaster = NULL;
+	double pdfRasterScale = 0;
+
 	/**
 	 * PNG Image / PDF Document
 	 */
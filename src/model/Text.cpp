@@ -6,6 +6,14 @@
 #include <serializing/ObjectOutputStream.h>
 #include <Stacktrace.h>
 
+#include <atomic>
+
+/**
+ * Source of the layout versions, shared by all Text elements so that a
+ * new Text at the address of a deleted one does not reuse its layout
+ */
+static std::atomic<guint64> nextLayoutVersion(1);
+
 Text::Text()
  : AudioElement(ELEMENT_TEXT)
 {
@@ -13,10 +21,14 @@ Text::Text()
 
 	this->font.setName("Sans");
 	this->font.setSize(12);
+
+	invalidateLayout();
 }
 
 Text::~Text()
 {
+	XOJ_CHECK_TYPE(Text);
+
 	XOJ_RELEASE_TYPE(Text);
 }
 
@@ -47,6 +59,8 @@ void Text::setFont(XojFont& font)
 	XOJ_CHECK_TYPE(Text);
 
 	this->font = font;
+
+	invalidateLayout();
 }
 
 string Text::getText()
@@ -62,6 +76,7 @@ void Text::setText(string text)
 
 	this->text = text;
 
+	invalidateLayout();
 	calcSize();
 }
 
@@ -72,6 +87,20 @@ void Text::calcSize()
 	TextView::calcSize(this, this->width, this->height);
 }
 
+guint64 Text::getLayoutVersion()
+{
+	XOJ_CHECK_TYPE(Text);
+
+	return this->layoutVersion;
+}
+
+void Text::invalidateLayout()
+{
+	XOJ_CHECK_TYPE(Text);
+
+	this->layoutVersion = nextLayoutVersion++;
+}
+
 void Text::setWidth(double width)
 {
 	XOJ_CHECK_TYPE(Text);
@@ -113,6 +142,7 @@ void Text::scale(double x0, double y0, double fx, double fy)
 
 	double size = this->font.getSize() * fx;
 	this->font.setSize(size);
+	invalidateLayout();
 
 	this->sizeCalculated = false;
 }
@@ -183,4 +213,6 @@ void Text::readSerialized(ObjectInputStream& in)
 	font.readSerialized(in);
 
 	in.endObject();
+
+	invalidateLayout();
 }
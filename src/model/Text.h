@@ -49,6 +49,12 @@ public:
 	bool intersects(double x, double y, double halfSize) override;
 	bool intersects(double x, double y, double halfSize, double* gap) override;
 
+	/**
+	 * Changes each time the text or the font changes, unique over all Text elements.
+	 * Used as key for the shaped layouts cached by TextView::getLayout()
+	 */
+	guint64 getLayoutVersion();
+
 public:
 	// Serialize interface
 	void serialize(ObjectOutputStream& out);
@@ -57,6 +63,9 @@ public:
 protected:
 	virtual void calcSize();
 
+private:
+	void invalidateLayout();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -65,4 +74,6 @@ private:
 	string text;
 
 	bool inEditing = false;
+
+	guint64 layoutVersion = 0;
 };
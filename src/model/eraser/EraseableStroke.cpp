@@ -1,37 +1,71 @@
 #include "EraseableStroke.h"
 
-#include "EraseableStrokePart.h"
-#include "PartList.h"
+#include "EraserCapsule.h"
 #include "model/Stroke.h"
+#include "model/StrokeSegmentTree.h"
 
 #include <Range.h>
 
+#include <algorithm>
 #include <cmath>
 
+/**
+ * Pieces shorter than this are removed while erasing
+ */
+#define ERASEABLE_MIN_PIECE_LENGTH 0.01
+
 EraseableStroke::EraseableStroke(Stroke* stroke)
  : stroke(stroke)
 {
 	XOJ_INIT_TYPE(EraseableStroke);
 
-	this->parts = new PartList();
 	g_mutex_init(&this->partLock);
 
-	for (int i = 1; i < stroke->getPointCount(); i++)
+	int count = stroke->getPointCount();
+	const Point* strokePoints = stroke->getPoints();
+	this->points.assign(strokePoints, strokePoints + count);
+
+	int segments = std::max(count - 1, 0);
+	this->intervals.reserve(segments);
+	this->segmentIndex.reserve(segments + 1);
+
+	for (int i = 0; i < segments; i++)
 	{
-		this->parts->add(new EraseableStrokePart(stroke->getPoint(i - 1), stroke->getPoint(i)));
+		this->segmentIndex.push_back(i);
+		this->intervals.push_back({ 0, 1 });
 	}
+	this->segmentIndex.push_back(segments);
 }
 
 EraseableStroke::~EraseableStroke()
 {
 	XOJ_CHECK_TYPE(EraseableStroke);
 
-	delete this->parts;
-	this->parts = NULL;
+	g_mutex_clear(&this->partLock);
+
+	delete this->segmentTree;
+	this->segmentTree = NULL;
 
 	XOJ_RELEASE_TYPE(EraseableStroke);
 }
 
+double EraseableStroke::getSegmentWidth(int segment)
+{
+	XOJ_CHECK_TYPE(EraseableStroke);
+
+	double width = this->points[segment].z;
+	if (width == Point::NO_PRESSURE)
+	{
+		return this->stroke->getWidth();
+	}
+	return width;
+}
+
+static inline Point interpolate(const Point& a, const Point& b, double t)
+{
+	return Point(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // This is done in a Thread, every thing else in the main loop /////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,362 +74,250 @@ void EraseableStroke::draw(cairo_t* cr)
 {
 	XOJ_CHECK_TYPE(EraseableStroke);
 
-	Point lastPoint;
-
 	g_mutex_lock(&this->partLock);
-	PartList * tmpCopy = this->parts->clone();
+	vector<EraseableInterval> intervals = this->intervals;
+	vector<int> segmentIndex = this->segmentIndex;
 	g_mutex_unlock(&this->partLock);
 
-	double w = this->stroke->getWidth();
+	int segments = (int) segmentIndex.size() - 1;
+
+	// Segment and width of the path which is not stroked yet, pieces which
+	// touch the end of the previous segment with the same width are joined
+	int lastSegment = -2;
+	bool lastEndsAtPoint = false;
+	double lastWidth = -1;
 
-	for (GList* l = tmpCopy->data; l != NULL; l = l->next)
+	for (int i = 0; i < segments; i++)
 	{
-		EraseableStrokePart* part = (EraseableStrokePart*) l->data;
-		if (part->getWidth() == Point::NO_PRESSURE)
-		{
-			cairo_set_line_width(cr, w);
-		}
-		else
+		const Point& a = this->points[i];
+		const Point& b = this->points[i + 1];
+		double width = getSegmentWidth(i);
+
+		for (int k = segmentIndex[i]; k < segmentIndex[i + 1]; k++)
 		{
-			cairo_set_line_width(cr, part->getWidth());
-		}
+			EraseableInterval& interval = intervals[k];
 
-		GList* pl = part->getPoints();
-		Point* p = (Point*) pl->data;
-		cairo_move_to(cr, p->x, p->y);
+			bool continues = lastSegment == i - 1 && lastEndsAtPoint && interval.start == 0 && lastWidth == width;
+			if (!continues)
+			{
+				if (lastSegment != -2)
+				{
+					cairo_stroke(cr);
+				}
+
+				cairo_set_line_width(cr, width);
+				Point p = interpolate(a, b, interval.start);
+				cairo_move_to(cr, p.x, p.y);
+			}
 
-		pl = pl->next;
-		for (; pl != NULL; pl = pl->next)
-		{
-			Point* p = (Point*) pl->data;
-			cairo_line_to(cr, p->x, p->y);
+			Point p = interpolate(a, b, interval.end);
+			cairo_line_to(cr, p.x, p.y);
+
+			lastSegment = i;
+			lastEndsAtPoint = interval.end == 1;
+			lastWidth = width;
 		}
-		cairo_stroke(cr);
 	}
 
-	delete tmpCopy;
+	if (lastSegment != -2)
+	{
+		cairo_stroke(cr);
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
-/**
- * The only public method
- */
-Range* EraseableStroke::erase(double x, double y, double halfEraserSize, Range* range)
+static void addRepaintRect(Range*& range, const Point& a, const Point& b, double width)
 {
-	XOJ_CHECK_TYPE(EraseableStroke);
-
-	this->repaintRect = range;
-
-	g_mutex_lock(&this->partLock);
-	PartList* tmpCopy = this->parts->clone();
-	g_mutex_unlock(&this->partLock);
-
-	for (GList* l = tmpCopy->data; l != NULL;)
+	if (range == NULL)
 	{
-		EraseableStrokePart* p = (EraseableStrokePart*) l->data;
-		l = l->next;
-		erase(x, y, halfEraserSize, p, tmpCopy);
+		range = new Range(a.x, a.y);
 	}
 
-	g_mutex_lock(&this->partLock);
-	PartList* old = this->parts;
-	this->parts = tmpCopy;
-	g_mutex_unlock(&this->partLock);
-
-	delete old;
-
-	return this->repaintRect;
+	range->addPoint(std::min(a.x, b.x) - width, std::min(a.y, b.y) - width);
+	range->addPoint(std::max(a.x, b.x) + width, std::max(a.y, b.y) + width);
 }
 
-void EraseableStroke::addRepaintRect(double x, double y, double width, double height)
-{
-	XOJ_CHECK_TYPE(EraseableStroke);
-
-	if (this->repaintRect)
-	{
-		this->repaintRect->addPoint(x, y);
-	}
-	else
-	{
-		this->repaintRect = new Range(x, y);
-	}
-
-	this->repaintRect->addPoint(x + width, y + height);
-}
-
-void EraseableStroke::erase(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list)
+/**
+ * Subtracts the capsule from the visible intervals of the segments it touches.
+ * Only the segments found in the segment tree are tested. If something was erased,
+ * the arrays are rebuilt from the first changed segment on, and the new tail is
+ * swapped in under the lock, so the render thread never sees a partial update.
+ */
+Range* EraseableStroke::erase(const EraserCapsule& capsule, Range* range)
 {
 	XOJ_CHECK_TYPE(EraseableStroke);
 
-	if (part->points->next == NULL)
-	{
-		return;
-	}
-
-	Point eraser(x, y);
-
-	Point* a = (Point*) g_list_first(part->points)->data;
-	Point* b = (Point*) g_list_last(part->points)->data;
-
-	if (eraser.lineLengthTo(*a) < halfEraserSize * 1.2 && eraser.lineLengthTo(*b) < halfEraserSize * 1.2)
+	if (this->segmentTree == NULL)
 	{
-		list->data = g_list_remove(list->data, part);
-		addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-
-		delete part;
-		return;
+		// The points are not changed while erasing
+		this->segmentTree = new StrokeSegmentTree(this->points.data(), (int) this->points.size());
 	}
 
-	double x1 = x - halfEraserSize;
-	double x2 = x + halfEraserSize;
-	double y1 = y - halfEraserSize;
-	double y2 = y + halfEraserSize;
-
-	double aX = a->x;
-	double aY = a->y;
-	double bX = b->x;
-	double bY = b->y;
+	// The new intervals of each changed segment
+	vector<std::pair<int, vector<EraseableInterval>>> changes;
 
-	// check first point
-	if (aX >= x1 && aY >= y1 && aX <= x2 && aY <= y2)
+	this->segmentTree->findSegments(capsule.getX(), capsule.getY(), capsule.getX2(), capsule.getY2(), [&](int i)
 	{
-		bool deleteAfter = false;
-
-		if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter))
-		{
-			addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-			part->calcSize();
-		}
-
-		if (deleteAfter)
+		int first = this->segmentIndex[i];
+		int last = this->segmentIndex[i + 1];
+		if (first == last)
 		{
-			delete part;
+			return false;
 		}
 
-		return;
-	}
-
-	// check last point
-	if (bX >= x1 && bY >= y1 && bX <= x2 && bY <= y2)
-	{
-		bool deleteAfter = false;
+		const Point& a = this->points[i];
+		const Point& b = this->points[i + 1];
 
-		if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter))
+		double t0 = 0;
+		double t1 = 0;
+		if (!capsule.intersectSegment(a, b, t0, t1))
 		{
-			addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-			part->calcSize();
+			return false;
 		}
 
-		if (deleteAfter)
-		{
-			delete part;
-		}
-
-		return;
-	}
-
-	double len = hypot(bX - aX, bY - aY);
-	/**
-	 * The normale to a vector, the padding to a point
-	 */
-	double p = ABS((x - aX) * (aY - bY) + (y - aY) * (bX - aX)) / hypot(aX - x, aY - y);
-
-	// The space to the line is in the range, but it can also be parallel
-	// and not enough close, so calculate a "circle" with the center on the
-	// center of the line
+		double length = hypot(b.x - a.x, b.y - a.y);
+		bool segmentChanged = false;
+		vector<EraseableInterval> segmentIntervals;
 
-	if (p <= halfEraserSize)
-	{
-		double centerX = (aX + x) / 2;
-		double centerY = (aY + y) / 2;
-		double distance = hypot(x - centerX, y - centerY);
-
-		// we should calculate the length of the line within the rectangle, to find out
-		// the distance from the border to the point, but the stroke are not rectangular
-		// so we can do it simpler
-		distance -= hypot((x2 - x1) / 2, (y2 - y1) / 2);
-
-		if (distance <= (len / 2) + 0.1)
+		for (int k = first; k < last; k++)
 		{
-			bool deleteAfter = false;
-
-			if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter))
+			const EraseableInterval& interval = this->intervals[k];
+			if (t1 <= interval.start || t0 >= interval.end)
 			{
-				addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-				part->calcSize();
+				segmentIntervals.push_back(interval);
+				continue;
 			}
 
-			if (deleteAfter)
+			segmentChanged = true;
+
+			if (t0 > interval.start && (t0 - interval.start) * length >= ERASEABLE_MIN_PIECE_LENGTH)
 			{
-				delete part;
+				segmentIntervals.push_back({ interval.start, t0 });
+			}
+			if (t1 < interval.end && (interval.end - t1) * length >= ERASEABLE_MIN_PIECE_LENGTH)
+			{
+				segmentIntervals.push_back({ t1, interval.end });
 			}
-
-			return;
 		}
-	}
-}
-
-bool EraseableStroke::erasePart(double x, double y, double halfEraserSize, EraseableStrokePart* part,
-								PartList* list, bool* deleteStrokeAfter)
-{
-	XOJ_CHECK_TYPE(EraseableStroke);
 
-	bool changed = false;
-
-	part->splitFor(halfEraserSize);
-
-	double x1 = x - halfEraserSize;
-	double x2 = x + halfEraserSize;
-	double y1 = y - halfEraserSize;
-	double y2 = y + halfEraserSize;
-
-	/**
-	 * erase the beginning
-	 */
-	for (GList* l = part->getPoints(); l != NULL;)
-	{
-		Point* p = (Point*) l->data;
-		l = l->next;
-		if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2)
+		if (segmentChanged)
 		{
-			part->points = g_list_remove(part->points, p);
-			delete p;
-			changed = true;
+			changes.emplace_back(i, std::move(segmentIntervals));
+			addRepaintRect(range, a, b, getSegmentWidth(i));
 		}
-		else
-		{
-			// only the beginning is handled here
-			break;
-		}
-	}
 
-	/**
-	 * erase the end
-	 */
-	for (GList* l = g_list_last(part->getPoints()); l != NULL;)
+		return false;
+	});
+
+	if (changes.empty())
 	{
-		Point* p = (Point*) l->data;
-		l = l->prev;
-		if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2)
-		{
-			part->points = g_list_remove(part->points, p);
-			delete p;
-			changed = true;
-		}
-		else
-		{
-			// only the end is handled here
-			break;
-		}
+		return range;
 	}
 
-	/**
-	 * handle the rest
-	 */
+	std::sort(changes.begin(), changes.end(),
+	          [](const std::pair<int, vector<EraseableInterval>>& a, const std::pair<int, vector<EraseableInterval>>& b)
+	          {
+		          return a.first < b.first;
+	          });
+
+	// Only this thread writes, so the current state can be read without the lock
+	int segments = (int) this->segmentIndex.size() - 1;
+	int firstSegment = changes.front().first;
+	int base = this->segmentIndex[firstSegment];
 
-	GList* lists = NULL;
-	GList* current = NULL;
+	vector<EraseableInterval> newIntervals;
+	vector<int> newIndex;
+	newIntervals.reserve(this->intervals.size() - base + changes.size());
+	newIndex.reserve(segments - firstSegment + 1);
 
-	for (GList* l = part->points; l != NULL;)
+	size_t c = 0;
+	for (int i = firstSegment; i < segments; i++)
 	{
-		Point* p = (Point*) l->data;
-		l = l->next;
-		if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2)
+		newIndex.push_back(base + (int) newIntervals.size());
+
+		if (c < changes.size() && changes[c].first == i)
 		{
-			part->points = g_list_remove(part->points, p);
-			delete p;
-			if (current)
-			{
-				lists = g_list_append(lists, current);
-				current = NULL;
-			}
-			changed = true;
+			newIntervals.insert(newIntervals.end(), changes[c].second.begin(), changes[c].second.end());
+			c++;
 		}
 		else
 		{
-			current = g_list_append(current, p);
+			newIntervals.insert(newIntervals.end(), this->intervals.begin() + this->segmentIndex[i],
+			                    this->intervals.begin() + this->segmentIndex[i + 1]);
 		}
 	}
+	newIndex.push_back(base + (int) newIntervals.size());
 
-	if (current)
-	{
-		lists = g_list_append(lists, current);
-		current = NULL;
-	}
-
-	g_list_free(part->points);
-	part->points = NULL;
-	if (lists)
-	{
-		part->points = (GList*) lists->data;
-		lists = g_list_delete_link(lists, lists);
-
-		int pos = g_list_index(list->data, part) + 1;
-		
-		// create data structure for all new (splitted) parts
-		for (GList* l = lists; l != NULL; l = l->next)
-		{
-			EraseableStrokePart* newPart = new EraseableStrokePart(part->width);
-			newPart->points = (GList*) l->data;
-			list->data = g_list_insert(list->data, newPart, pos++);
-		}
-
-		g_list_free(lists);
-	}
-	else
-	{
-		// no parts, all deleted
-		list->data = g_list_remove(list->data, part);
-		*deleteStrokeAfter = true;
-	}
+	g_mutex_lock(&this->partLock);
+	this->intervals.resize(base);
+	this->intervals.insert(this->intervals.end(), newIntervals.begin(), newIntervals.end());
+	std::copy(newIndex.begin(), newIndex.end(), this->segmentIndex.begin() + firstSegment);
+	g_mutex_unlock(&this->partLock);
 
-	return changed;
+	return range;
 }
 
+/**
+ * Build the strokes which are left over, in one pass over the intervals.
+ * Pieces which end on a point of the original stroke and continue on the
+ * next segment stay in the same stroke.
+ */
 GList* EraseableStroke::getStroke(Stroke* original)
 {
 	XOJ_CHECK_TYPE(EraseableStroke);
 
 	GList* list = NULL;
-
 	Stroke* s = NULL;
-	Point lastPoint(NAN, NAN);
-	for (GList* l = this->parts->data; l != NULL; l = l->next)
-	{
-		EraseableStrokePart* p = (EraseableStrokePart*) l->data;
-		GList* points = p->getPoints();
-		if (g_list_length(points) < 2)
-		{
-			continue;
-		}
 
-		Point a = *((Point*) g_list_first(points)->data);
-		Point b = *((Point*) g_list_last(points)->data);
-		a.z = p->width;
+	int segments = (int) this->segmentIndex.size() - 1;
+	int lastSegment = -2;
+	bool lastEndsAtPoint = false;
+	Point lastPoint;
+
+	for (int i = 0; i < segments; i++)
+	{
+		const Point& a = this->points[i];
+		const Point& b = this->points[i + 1];
 
-		if (!lastPoint.equalsPos(a) || s == NULL)
+		for (int k = this->segmentIndex[i]; k < this->segmentIndex[i + 1]; k++)
 		{
-			if (s)
+			EraseableInterval& interval = this->intervals[k];
+
+			if (lastSegment == i - 1 && lastEndsAtPoint && interval.start == 0)
 			{
-				s->addPoint(lastPoint);
+				// Continue with the original point, it keeps its own pressure
+				s->addPoint(a);
 			}
-			s = new Stroke();
-			s->setColor(original->getColor());
-			s->setToolType(original->getToolType());
-			s->setLineStyle(original->getLineStyle());
-			s->setWidth(original->getWidth());
-			list = g_list_append(list, s);
+			else
+			{
+				if (s)
+				{
+					s->addPoint(lastPoint);
+				}
+
+				s = new Stroke();
+				s->setColor(original->getColor());
+				s->setToolType(original->getToolType());
+				s->setLineStyle(original->getLineStyle());
+				s->setWidth(original->getWidth());
+				list = g_list_prepend(list, s);
+
+				s->addPoint(interpolate(a, b, interval.start));
+			}
+
+			lastPoint = interpolate(a, b, interval.end);
+			lastSegment = i;
+			lastEndsAtPoint = interval.end == 1;
 		}
-		s->addPoint(a);
-		lastPoint = b;
 	}
+
 	if (s)
 	{
 		s->addPoint(lastPoint);
 	}
 
-	return list;
+	return g_list_reverse(list);
 }
@@ -16,10 +16,23 @@
 
 #include <gtk/gtk.h>
 
-class EraseableStrokePart;
-class PartList;
+#include <vector>
+using std::vector;
+
+class EraserCapsule;
 class Range;
 class Stroke;
+class StrokeSegmentTree;
+
+/**
+ * A visible piece of one segment, 0 is the start point of the segment, 1 the end point
+ */
+class EraseableInterval
+{
+public:
+	double start;
+	double end;
+};
 
 class EraseableStroke
 {
@@ -29,29 +42,46 @@ public:
 
 public:
 	/**
+	 * Erase the area swept by the eraser
+	 *
 	 * Returns a repaint rectangle or NULL, the rectangle is own by the caller
 	 */
-	Range* erase(double x, double y, double halfEraserSize, Range* range = NULL);
+	Range* erase(const EraserCapsule& capsule, Range* range = NULL);
 
+	/**
+	 * Build the strokes which are left over
+	 */
 	GList* getStroke(Stroke* original);
 
 	void draw(cairo_t* cr);
 
 private:
-	void erase(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list);
-	bool erasePart(double x, double y, double halfEraserSize, EraseableStrokePart* part,
-				   PartList* list, bool* deleteStrokeAfter);
-
-	void addRepaintRect(double x, double y, double width, double height);
+	double getSegmentWidth(int segment);
 
 private:
 	XOJ_TYPE_ATTRIB;
 
+	/**
+	 * The points of the original stroke, they are not changed while erasing
+	 */
+	vector<Point> points;
 
 	GMutex partLock;
-	PartList * parts = NULL;
 
-	Range* repaintRect = NULL;
+	/**
+	 * The visible intervals of all segments, sorted by segment
+	 */
+	vector<EraseableInterval> intervals;
+
+	/**
+	 * Segment i owns the intervals [segmentIndex[i], segmentIndex[i + 1])
+	 */
+	vector<int> segmentIndex;
+
+	/**
+	 * Bounding boxes of the segments of points, built on the first erase() call
+	 */
+	StrokeSegmentTree* segmentTree = NULL;
 
 	Stroke* stroke = NULL;
 };
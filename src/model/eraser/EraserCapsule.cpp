@@ -0,0 +1,181 @@
+#include "EraserCapsule.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+EraserCapsule::EraserCapsule(double x1, double y1, double x2, double y2, double radius)
+ : x1(x1),
+   y1(y1),
+   x2(x2),
+   y2(y2),
+   radius(radius)
+{
+	XOJ_INIT_TYPE(EraserCapsule);
+}
+
+EraserCapsule::EraserCapsule(const EraserCapsule& capsule)
+ : x1(capsule.x1),
+   y1(capsule.y1),
+   x2(capsule.x2),
+   y2(capsule.y2),
+   radius(capsule.radius)
+{
+	XOJ_INIT_TYPE(EraserCapsule);
+}
+
+EraserCapsule::~EraserCapsule()
+{
+	XOJ_RELEASE_TYPE(EraserCapsule);
+}
+
+/**
+ * Restrict [tStart, tEnd] to the t with min <= v0 + v1 * t <= max
+ */
+static bool clipLinear(double v0, double v1, double min, double max, double& tStart, double& tEnd)
+{
+	if (std::abs(v1) < 1e-12)
+	{
+		return v0 >= min && v0 <= max;
+	}
+
+	double ta = (min - v0) / v1;
+	double tb = (max - v0) / v1;
+	if (ta > tb)
+	{
+		std::swap(ta, tb);
+	}
+
+	tStart = std::max(tStart, ta);
+	tEnd = std::min(tEnd, tb);
+
+	return tStart <= tEnd;
+}
+
+/**
+ * The t of a + t * d within radius of (cx, cy)
+ */
+static bool clipCircle(const Point& a, double dx, double dy, double cx, double cy, double radius,
+                       double& tStart, double& tEnd)
+{
+	double ax = a.x - cx;
+	double ay = a.y - cy;
+
+	double qa = dx * dx + dy * dy;
+	double qb = 2 * (dx * ax + dy * ay);
+	double qc = ax * ax + ay * ay - radius * radius;
+
+	if (qa < 1e-12)
+	{
+		// The segment is a point
+		tStart = 0;
+		tEnd = 1;
+		return qc <= 0;
+	}
+
+	double disc = qb * qb - 4 * qa * qc;
+	if (disc < 0)
+	{
+		return false;
+	}
+
+	disc = std::sqrt(disc);
+	tStart = (-qb - disc) / (2 * qa);
+	tEnd = (-qb + disc) / (2 * qa);
+	return true;
+}
+
+/**
+ * Calculates the part of the segment a - b within the capsule
+ *
+ * The capsule is convex, so this is one interval: the union of
+ * the intervals within both end circles and the rectangle between them.
+ */
+bool EraserCapsule::intersectSegment(const Point& a, const Point& b, double& t0, double& t1) const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	double dx = b.x - a.x;
+	double dy = b.y - a.y;
+
+	double lo = std::numeric_limits<double>::infinity();
+	double hi = -std::numeric_limits<double>::infinity();
+
+	double tStart = 0;
+	double tEnd = 0;
+
+	if (clipCircle(a, dx, dy, this->x1, this->y1, this->radius, tStart, tEnd))
+	{
+		lo = std::min(lo, tStart);
+		hi = std::max(hi, tEnd);
+	}
+
+	if (clipCircle(a, dx, dy, this->x2, this->y2, this->radius, tStart, tEnd))
+	{
+		lo = std::min(lo, tStart);
+		hi = std::max(hi, tEnd);
+	}
+
+	double length = std::hypot(this->x2 - this->x1, this->y2 - this->y1);
+	if (length > 0)
+	{
+		double ux = (this->x2 - this->x1) / length;
+		double uy = (this->y2 - this->y1) / length;
+
+		double ax = a.x - this->x1;
+		double ay = a.y - this->y1;
+
+		tStart = -std::numeric_limits<double>::infinity();
+		tEnd = std::numeric_limits<double>::infinity();
+
+		// Along the eraser movement and perpendicular to it
+		if (clipLinear(ax * ux + ay * uy, dx * ux + dy * uy, 0, length, tStart, tEnd) &&
+		    clipLinear(ay * ux - ax * uy, dy * ux - dx * uy, -this->radius, this->radius, tStart, tEnd))
+		{
+			lo = std::min(lo, tStart);
+			hi = std::max(hi, tEnd);
+		}
+	}
+
+	t0 = std::max(lo, 0.0);
+	t1 = std::min(hi, 1.0);
+
+	return t0 <= t1;
+}
+
+bool EraserCapsule::intersectsSegment(const Point& a, const Point& b) const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	double t0 = 0;
+	double t1 = 0;
+	return intersectSegment(a, b, t0, t1);
+}
+
+double EraserCapsule::getX() const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	return std::min(this->x1, this->x2) - this->radius;
+}
+
+double EraserCapsule::getY() const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	return std::min(this->y1, this->y2) - this->radius;
+}
+
+double EraserCapsule::getX2() const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	return std::max(this->x1, this->x2) + this->radius;
+}
+
+double EraserCapsule::getY2() const
+{
+	XOJ_CHECK_TYPE(EraserCapsule);
+
+	return std::max(this->y1, this->y2) + this->radius;
+}
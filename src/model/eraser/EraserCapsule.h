@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * The area swept by the eraser between two events:
+ * all points within radius of the line from (x1, y1) to (x2, y2)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "model/Point.h"
+#include <XournalType.h>
+
+class EraserCapsule
+{
+public:
+	EraserCapsule(double x1, double y1, double x2, double y2, double radius);
+	EraserCapsule(const EraserCapsule& capsule);
+	virtual ~EraserCapsule();
+
+private:
+	void operator=(const EraserCapsule& capsule);
+
+public:
+	/**
+	 * Calculates the part of the segment a - b within the capsule
+	 *
+	 * @param t0 Start of the part, 0 is a, 1 is b
+	 * @param t1 End of the part
+	 * @return false if the segment does not touch the capsule
+	 */
+	bool intersectSegment(const Point& a, const Point& b, double& t0, double& t1) const;
+
+	/**
+	 * @return true if the segment a - b touches the capsule
+	 */
+	bool intersectsSegment(const Point& a, const Point& b) const;
+
+	/**
+	 * Bounding box
+	 */
+	double getX() const;
+	double getY() const;
+	double getX2() const;
+	double getY2() const;
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	double x1;
+	double y1;
+	double x2;
+	double y2;
+	double radius;
+};
@@ -45,6 +45,12 @@ public:
 
 	virtual vector<XojPdfRectangle> findText(string& text) = 0;
 
+	/**
+	 * @param characters The bounding box of each UTF-8 character of the text, in page coordinates
+	 * @return The text of the page
+	 */
+	virtual string getText(vector<XojPdfRectangle>& characters) = 0;
+
 	virtual int getPageId() = 0;
 
 private:
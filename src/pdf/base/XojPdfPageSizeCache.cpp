@@ -0,0 +1,66 @@
+#include "XojPdfPageSizeCache.h"
+
+#include <Util.h>
+
+#include <glib/gstdio.h>
+
+#include <string.h>
+
+XojPdfPageSizeCache::XojPdfPageSizeCache() { }
+
+XojPdfPageSizeCache::~XojPdfPageSizeCache() { }
+
+Path XojPdfPageSizeCache::getCacheFile(Path pdfFile)
+{
+	GStatBuf attrib;
+	if (g_stat(pdfFile.c_str(), &attrib) != 0)
+	{
+		return Path();
+	}
+
+	string key = pdfFile.str() + "\n" + std::to_string((gint64) attrib.st_size) + "\n" + std::to_string((gint64) attrib.st_mtime);
+
+	gchar* hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, key.c_str(), key.length());
+	Path file = Util::ensureFolderExists(Path(g_get_user_cache_dir()) / "xournalpp" / "pagesizes") / (string(hash) + ".bin");
+	g_free(hash);
+
+	return file;
+}
+
+bool XojPdfPageSizeCache::load(Path pdfFile, size_t pageCount, vector<double>& sizes)
+{
+	Path file = getCacheFile(pdfFile);
+	if (file.isEmpty())
+	{
+		return false;
+	}
+
+	gchar* contents = NULL;
+	gsize length = 0;
+	if (!g_file_get_contents(file.c_str(), &contents, &length, NULL))
+	{
+		return false;
+	}
+
+	bool valid = length == pageCount * 2 * sizeof(double);
+	if (valid)
+	{
+		sizes.resize(pageCount * 2);
+		memcpy(sizes.data(), contents, length);
+	}
+	g_free(contents);
+
+	return valid;
+}
+
+void XojPdfPageSizeCache::save(Path pdfFile, const vector<double>& sizes)
+{
+	Path file = getCacheFile(pdfFile);
+	if (file.isEmpty())
+	{
+		return;
+	}
+
+	// Only a cache, errors are ignored
+	g_file_set_contents(file.c_str(), (const gchar*) sizes.data(), sizes.size() * sizeof(double), NULL);
+}
@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * Disk cache of the page sizes of PDF files, so opening a big PDF again
+ * does not need to load every page only to read its size
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <Path.h>
+
+#include <vector>
+using std::vector;
+
+class XojPdfPageSizeCache
+{
+private:
+	XojPdfPageSizeCache();
+	virtual ~XojPdfPageSizeCache();
+
+public:
+	/**
+	 * Load the cached sizes, width and height of each page
+	 *
+	 * @return false if the file was not cached, or changed since
+	 */
+	static bool load(Path pdfFile, size_t pageCount, vector<double>& sizes);
+
+	/**
+	 * Store the sizes, width and height of each page
+	 */
+	static void save(Path pdfFile, const vector<double>& sizes);
+
+private:
+	/**
+	 * The cache file name contains a hash of the path, the size and the modification time of the PDF
+	 */
+	static Path getCacheFile(Path pdfFile);
+};
@@ -115,3 +115,31 @@ vector<XojPdfRectangle> PopplerGlibPage::findText(string& text)
 
 	return findings;
 }
+
+string PopplerGlibPage::getText(vector<XojPdfRectangle>& characters)
+{
+	XOJ_CHECK_TYPE(PopplerGlibPage);
+
+	gchar* text = poppler_page_get_text(page);
+	if (text == NULL)
+	{
+		return "";
+	}
+
+	string result = text;
+	g_free(text);
+
+	PopplerRectangle* rects = NULL;
+	guint count = 0;
+	if (poppler_page_get_text_layout(page, &rects, &count))
+	{
+		characters.reserve(count);
+		for (guint i = 0; i < count; i++)
+		{
+			characters.push_back(XojPdfRectangle(rects[i].x1, rects[i].y1, rects[i].x2, rects[i].y2));
+		}
+		g_free(rects);
+	}
+
+	return result;
+}
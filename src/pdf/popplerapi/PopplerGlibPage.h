@@ -31,6 +31,7 @@ public:
 	virtual void render(cairo_t* cr, bool forPrinting = false);
 
 	virtual vector<XojPdfRectangle> findText(string& text);
+	virtual string getText(vector<XojPdfRectangle>& characters);
 
 	virtual int getPageId();
 
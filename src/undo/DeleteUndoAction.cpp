@@ -43,6 +43,18 @@ void DeleteUndoAction::addElement(Layer* layer, Element* e, int pos)
 										  (GCompareFunc) PageLayerPosEntry<Element>::cmp);
 }
 
+vector<Element*> DeleteUndoAction::getRemovedElements()
+{
+	XOJ_CHECK_TYPE(DeleteUndoAction);
+
+	vector<Element*> removed;
+	for (GList* l = this->elements; l != NULL; l = l->next)
+	{
+		removed.push_back(((PageLayerPosEntry<Element>*) l->data)->element);
+	}
+	return removed;
+}
+
 bool DeleteUndoAction::undo(Control* control)
 {
 	XOJ_CHECK_TYPE(DeleteUndoAction);
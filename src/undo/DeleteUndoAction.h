@@ -32,6 +32,8 @@ public:
 
 	virtual string getText();
 
+	virtual vector<Element*> getRemovedElements();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
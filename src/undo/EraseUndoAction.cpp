@@ -48,6 +48,18 @@ EraseUndoAction::~EraseUndoAction()
 	XOJ_RELEASE_TYPE(EraseUndoAction);
 }
 
+vector<Element*> EraseUndoAction::getRemovedElements()
+{
+	XOJ_CHECK_TYPE(EraseUndoAction);
+
+	vector<Element*> removed;
+	for (GList* l = this->original; l != NULL; l = l->next)
+	{
+		removed.push_back(((PageLayerPosEntry<Stroke>*) l->data)->element);
+	}
+	return removed;
+}
+
 void EraseUndoAction::addOriginal(Layer* layer, Stroke* element, int pos)
 {
 	XOJ_CHECK_TYPE(EraseUndoAction);
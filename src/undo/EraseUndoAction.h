@@ -35,6 +35,8 @@ public:
 	void finalize();
 
 	virtual string getText();
+
+	virtual vector<Element*> getRemovedElements();
 	
 private:
 	XOJ_TYPE_ATTRIB;
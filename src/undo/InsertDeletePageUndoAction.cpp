@@ -4,6 +4,7 @@
 #include "gui/XournalppCursor.h"
 #include "model/PageRef.h"
 #include "model/Document.h"
+#include "model/Layer.h"
 
 #include <i18n.h>
 
@@ -26,6 +27,26 @@ InsertDeletePageUndoAction::~InsertDeletePageUndoAction()
 	XOJ_RELEASE_TYPE(InsertDeletePageUndoAction);
 }
 
+/**
+ * The elements of a deleted page
+ */
+vector<Element*> InsertDeletePageUndoAction::getRemovedElements()
+{
+	XOJ_CHECK_TYPE(InsertDeletePageUndoAction);
+
+	vector<Element*> removed;
+	if (this->inserted)
+	{
+		return removed;
+	}
+
+	for (Layer* l : *this->page->getLayers())
+	{
+		removed.insert(removed.end(), l->getElements()->begin(), l->getElements()->end());
+	}
+	return removed;
+}
+
 bool InsertDeletePageUndoAction::undo(Control* control)
 {
 	XOJ_CHECK_TYPE(InsertDeletePageUndoAction);
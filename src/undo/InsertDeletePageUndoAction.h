@@ -25,6 +25,8 @@ public:
 	virtual bool redo(Control* control);
 
 	virtual string getText();
+
+	virtual vector<Element*> getRemovedElements();
 private:
 	bool insertPage(Control* control);
 	bool deletePage(Control* control);
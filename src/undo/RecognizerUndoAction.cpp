@@ -40,6 +40,13 @@ RecognizerUndoAction::~RecognizerUndoAction()
 	XOJ_RELEASE_TYPE(RecognizerUndoAction);
 }
 
+vector<Element*> RecognizerUndoAction::getRemovedElements()
+{
+	XOJ_CHECK_TYPE(RecognizerUndoAction);
+
+	return vector<Element*>(this->original.begin(), this->original.end());
+}
+
 void RecognizerUndoAction::addSourceElement(Stroke* s)
 {
 	XOJ_CHECK_TYPE(RecognizerUndoAction);
@@ -31,6 +31,8 @@ public:
 
 	virtual string getText();
 
+	virtual vector<Element*> getRemovedElements();
+
 private:
 	XOJ_TYPE_ATTRIB;
 
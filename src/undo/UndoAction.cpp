@@ -22,6 +22,13 @@ vector<PageRef> UndoAction::getPages()
 	return pages;
 }
 
+vector<Element*> UndoAction::getRemovedElements()
+{
+	XOJ_CHECK_TYPE(UndoAction);
+
+	return vector<Element*>();
+}
+
 const char* UndoAction::getClassName() const
 {
 	return this->className;
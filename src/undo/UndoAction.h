@@ -16,6 +16,7 @@
 #include <config.h>
 
 class Control;
+class Element;
 class XojPage;
 
 class UndoAction
@@ -35,6 +36,12 @@ public:
 	 */
 	virtual vector<PageRef> getPages();
 
+	/**
+	 * Elements which are not part of the document while this action is on the
+	 * undo stack, they are only referenced by this action (e.g. deleted elements)
+	 */
+	virtual vector<Element*> getRemovedElements();
+
 	const char* getClassName() const;
 
 protected:
@@ -1,6 +1,9 @@
 #include "UndoRedoHandler.h"
 
+#include "UndoSpillFile.h"
+
 #include "control/Control.h"
+#include "model/Stroke.h"
 
 #include <config.h>
 #include <i18n.h>
@@ -62,6 +65,9 @@ UndoRedoHandler::~UndoRedoHandler()
 
 	clearContents();
 
+	delete this->spillFile;
+	this->spillFile = NULL;
+
 	XOJ_RELEASE_TYPE(UndoRedoHandler);
 }
 
@@ -77,11 +83,19 @@ void UndoRedoHandler::clearContents()
 		g_message("clearContents()::Delete UndoAction: %" PRIu64 " / %s", (uint64_t)action, action->getClassName());
 #endif //UNDO_TRACE
 
-		delete action;
+		deleteAction(action);
 	}
 	g_list_free(this->undoList);
 	this->undoList = NULL;
 
+	if (this->spillFile)
+	{
+		this->spillFile->clear();
+	}
+	this->memoryCosts.clear();
+	this->usedMemory = 0;
+	this->spillQueue.clear();
+
 	clearRedo();
 
 	this->savedUndo = NULL;
@@ -102,7 +116,7 @@ void UndoRedoHandler::clearRedo()
 		g_message("clearRedo()::Delete UndoAction: %" PRIu64 " / %s", (uint64_t)action, action->getClassName());
 #endif
 
-		delete action;
+		deleteAction(action);
 	}
 	g_list_free(this->redoList);
 	this->redoList = NULL;
@@ -110,6 +124,147 @@ void UndoRedoHandler::clearRedo()
 	PRINTCONTENTS();
 }
 
+void UndoRedoHandler::deleteAction(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	forgetAction(action);
+	if (this->spillFile)
+	{
+		this->spillFile->remove(action);
+	}
+
+	delete action;
+}
+
+bool UndoRedoHandler::restoreAction(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	if (this->spillFile == NULL || this->spillFile->restore(action))
+	{
+		return true;
+	}
+
+	string msg = FS(_F("Could not undo \"{1}\"\n" "The undo data could not be read back from the temporary file.")
+	                % action->getText());
+	XojMsgBox::showErrorToUser(control->getGtkWindow(), msg);
+	return false;
+}
+
+void UndoRedoHandler::setMemoryBudget(size_t bytes)
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	this->memoryBudget = bytes;
+	enforceMemoryBudget();
+}
+
+/**
+ * The strokes only referenced by the action, which can be spilled
+ *
+ * @return The memory of their points
+ */
+static size_t getSpillableStrokes(UndoAction* action, vector<Stroke*>& strokes)
+{
+	size_t cost = 0;
+	for (Element* e : action->getRemovedElements())
+	{
+		if (e->getType() == ELEMENT_STROKE)
+		{
+			Stroke* s = (Stroke*) e;
+			strokes.push_back(s);
+			cost += s->getPointCount() * sizeof(Point);
+		}
+	}
+	return cost;
+}
+
+void UndoRedoHandler::accountAction(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	if (this->memoryCosts.find(action) != this->memoryCosts.end() ||
+	    (this->spillFile && this->spillFile->isSpilled(action)))
+	{
+		return;
+	}
+
+	vector<Stroke*> strokes;
+	size_t cost = getSpillableStrokes(action, strokes);
+	if (cost == 0)
+	{
+		return;
+	}
+
+	this->memoryCosts[action] = cost;
+	this->usedMemory += cost;
+	this->spillQueue.push_back(action);
+
+	if (this->spillQueue.size() > 2 * this->memoryCosts.size() + 64)
+	{
+		// Drop the entries of forgotten actions, else undo / redo cycles would let the queue grow
+		std::deque<UndoAction*> queue;
+		for (UndoAction* a : this->spillQueue)
+		{
+			if (this->memoryCosts.find(a) != this->memoryCosts.end())
+			{
+				queue.push_back(a);
+			}
+		}
+		this->spillQueue.swap(queue);
+	}
+}
+
+void UndoRedoHandler::forgetAction(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	auto it = this->memoryCosts.find(action);
+	if (it != this->memoryCosts.end())
+	{
+		this->usedMemory -= it->second;
+		this->memoryCosts.erase(it);
+	}
+}
+
+/**
+ * The newest action is never spilled, it may still be extended (e.g. while erasing),
+ * so it is only accounted once the next action is added.
+ */
+void UndoRedoHandler::enforceMemoryBudget()
+{
+	XOJ_CHECK_TYPE(UndoRedoHandler);
+
+	while (this->usedMemory > this->memoryBudget && !this->spillQueue.empty())
+	{
+		UndoAction* action = this->spillQueue.front();
+		auto it = this->memoryCosts.find(action);
+		if (it == this->memoryCosts.end())
+		{
+			this->spillQueue.pop_front();
+			continue;
+		}
+
+		if (this->spillFile == NULL)
+		{
+			this->spillFile = new UndoSpillFile();
+		}
+
+		vector<Stroke*> strokes;
+		getSpillableStrokes(action, strokes);
+		if (!this->spillFile->spill(action, strokes))
+		{
+			// The file is not writable, keep everything in memory
+			return;
+		}
+
+		this->spillQueue.pop_front();
+		this->usedMemory -= it->second;
+		this->memoryCosts.erase(it);
+	}
+}
+
 void UndoRedoHandler::undo()
 {
 	XOJ_CHECK_TYPE(UndoRedoHandler);
@@ -128,6 +283,12 @@ void UndoRedoHandler::undo()
 
 	UndoAction* undo = (UndoAction*) e->data;
 
+	if (!restoreAction(undo))
+	{
+		// Applying the action without its strokes would delete them from the document
+		return;
+	}
+
 	Document* doc = control->getDocument();
 	doc->lock();
 	bool undoResult = undo->undo(this->control);
@@ -142,6 +303,7 @@ void UndoRedoHandler::undo()
 
 	this->redoList = g_list_append(this->redoList, undo);
 	this->undoList = g_list_delete_link(this->undoList, e);
+	forgetAction(undo);
 	fireUpdateUndoRedoButtons(undo->getPages());
 
 	PRINTCONTENTS();
@@ -177,10 +339,18 @@ void UndoRedoHandler::redo()
 		XojMsgBox::showErrorToUser(control->getGtkWindow(), msg);
 	}
 
+	GList* newest = g_list_last(this->undoList);
+	if (newest)
+	{
+		accountAction((UndoAction*) newest->data);
+	}
+
 	this->undoList = g_list_append(this->undoList, redo);
 	this->redoList = g_list_delete_link(this->redoList, e);
 	fireUpdateUndoRedoButtons(redo->getPages());
 
+	enforceMemoryBudget();
+
 	PRINTCONTENTS();
 }
 
@@ -210,10 +380,18 @@ void UndoRedoHandler::addUndoAction(UndoAction* action)
 		return;
 	}
 
+	GList* newest = g_list_last(this->undoList);
+	if (newest)
+	{
+		accountAction((UndoAction*) newest->data);
+	}
+
 	this->undoList = g_list_append(this->undoList, action);
 	clearRedo();
 	fireUpdateUndoRedoButtons(action->getPages());
 
+	enforceMemoryBudget();
+
 	PRINTCONTENTS();
 }
 
@@ -228,9 +406,12 @@ void UndoRedoHandler::addUndoActionBefore(UndoAction* action, UndoAction* before
 		return;
 	}
 	this->undoList = g_list_insert_before(this->undoList, data, action);
+	accountAction(action);
 	clearRedo();
 	fireUpdateUndoRedoButtons(action->getPages());
 
+	enforceMemoryBudget();
+
 	PRINTCONTENTS();
 }
 
@@ -244,6 +425,13 @@ bool UndoRedoHandler::removeUndoAction(UndoAction* action)
 		return false;
 	}
 
+	// The caller takes the action back
+	if (!restoreAction(action))
+	{
+		this->spillFile->remove(action);
+	}
+	forgetAction(action);
+
 	undoList = g_list_delete_link(undoList, l);
 	clearRedo();
 	fireUpdateUndoRedoButtons(action->getPages());
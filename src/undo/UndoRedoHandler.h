@@ -14,7 +14,11 @@
 #include "UndoAction.h"
 #include <XournalType.h>
 
+#include <deque>
+#include <map>
+
 class Control;
+class UndoSpillFile;
 
 class UndoRedoListener
 {
@@ -57,8 +61,38 @@ public:
 	const char* getUndoStackTopTypeName();
 	const char* getRedoStackTopTypeName();
 
+	/**
+	 * Memory for strokes which are only referenced by undo actions,
+	 * the strokes of older actions are moved to a temporary file
+	 */
+	void setMemoryBudget(size_t bytes);
+
 private:
 	void clearRedo();
+	void deleteAction(UndoAction* action);
+
+	/**
+	 * Read the strokes of a spilled action back
+	 *
+	 * @return false if they could not be read, the action must not be applied
+	 */
+	bool restoreAction(UndoAction* action);
+
+	/**
+	 * Count the strokes of the action to the used memory, called once the action
+	 * is not the newest one anymore (it may still be extended until then)
+	 */
+	void accountAction(UndoAction* action);
+
+	/**
+	 * The action is not in the undo list anymore, or it is deleted
+	 */
+	void forgetAction(UndoAction* action);
+
+	/**
+	 * Spill the oldest accounted actions until the used memory is within the budget
+	 */
+	void enforceMemoryBudget();
 
 private:
 	XOJ_TYPE_ATTRIB;
@@ -72,4 +106,19 @@ private:
 	GList* listener = NULL;
 
 	Control* control = NULL;
+
+	size_t memoryBudget = 256 * 1024 * 1024;
+	UndoSpillFile* spillFile = NULL;
+
+	/**
+	 * Stroke memory of each accounted action, which is not spilled
+	 */
+	std::map<UndoAction*, size_t> memoryCosts;
+	size_t usedMemory = 0;
+
+	/**
+	 * Accounted actions from the oldest to the newest, spilling continues at the front.
+	 * Entries of forgotten actions are skipped.
+	 */
+	std::deque<UndoAction*> spillQueue;
 };
@@ -0,0 +1,281 @@
+#include "UndoSpillFile.h"
+
+#include "model/Stroke.h"
+
+#include <serializing/BinObjectEncoding.h>
+#include <serializing/InputStreamException.h>
+#include <serializing/ObjectInputStream.h>
+#include <serializing/ObjectOutputStream.h>
+
+#include <glib/gstdio.h>
+
+#include <iterator>
+
+UndoSpillFile::UndoSpillFile()
+{
+	XOJ_INIT_TYPE(UndoSpillFile);
+}
+
+UndoSpillFile::~UndoSpillFile()
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	this->entries.clear();
+
+	if (this->stream.is_open())
+	{
+		this->stream.close();
+		g_unlink(this->file.c_str());
+	}
+
+	XOJ_RELEASE_TYPE(UndoSpillFile);
+}
+
+bool UndoSpillFile::open()
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	if (this->stream.is_open())
+	{
+		return true;
+	}
+
+	gchar* name = NULL;
+	GError* error = NULL;
+	int fd = g_file_open_tmp("xournalpp-undo-XXXXXX", &name, &error);
+	if (fd == -1)
+	{
+		g_warning("Could not create the undo spill file: %s", error->message);
+		g_error_free(error);
+		return false;
+	}
+	g_close(fd, NULL);
+
+	this->file = Path(name);
+	g_free(name);
+
+	this->stream.open(this->file.c_str(), std::fstream::in | std::fstream::out | std::fstream::binary | std::fstream::trunc);
+	this->end = 0;
+
+	return this->stream.is_open();
+}
+
+bool UndoSpillFile::spill(UndoAction* action, vector<Stroke*>& strokes)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	if (isSpilled(action) || !open())
+	{
+		return false;
+	}
+
+	ObjectOutputStream out(new BinObjectEncoding());
+	for (Stroke* s : strokes)
+	{
+		s->serialize(out);
+	}
+	GString* data = out.getStr();
+
+	std::streamoff offset = allocate(data->len);
+
+	this->stream.clear();
+	this->stream.seekp(offset);
+	this->stream.write(data->str, data->len);
+	this->stream.flush();
+
+	bool written = this->stream.good();
+	if (written)
+	{
+		UndoSpillEntry& entry = this->entries[action];
+		entry.offset = offset;
+		entry.length = data->len;
+		entry.strokes = strokes;
+
+		for (Stroke* s : strokes)
+		{
+			s->deletePointsFrom(0);
+			s->freeUnusedPointItems();
+		}
+	}
+	else
+	{
+		release(offset, data->len);
+		g_warning("Could not write the undo spill file \"%s\"", this->file.c_str());
+	}
+
+	g_string_free(data, true);
+
+	return written;
+}
+
+bool UndoSpillFile::restore(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	auto it = this->entries.find(action);
+	if (it == this->entries.end())
+	{
+		return true;
+	}
+
+	UndoSpillEntry& entry = it->second;
+
+	string data(entry.length, '\0');
+	this->stream.clear();
+	this->stream.seekg(entry.offset);
+	this->stream.read(&data[0], entry.length);
+
+	if (!this->stream.good())
+	{
+		g_warning("Could not read the undo spill file \"%s\"", this->file.c_str());
+		return false;
+	}
+
+	try
+	{
+		ObjectInputStream in;
+		if (!in.read(data.c_str(), data.length()))
+		{
+			throw InputStreamException("Invalid header", __FILE__, __LINE__);
+		}
+
+		for (Stroke* s : entry.strokes)
+		{
+			s->readSerialized(in);
+		}
+	}
+	catch (InputStreamException& e)
+	{
+		g_warning("Could not read the undo spill file: %s", e.what());
+
+		// Do not leave partially restored strokes
+		for (Stroke* s : entry.strokes)
+		{
+			s->deletePointsFrom(0);
+			s->freeUnusedPointItems();
+		}
+		return false;
+	}
+
+	removeEntry(it);
+
+	return true;
+}
+
+bool UndoSpillFile::isSpilled(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	return this->entries.find(action) != this->entries.end();
+}
+
+void UndoSpillFile::remove(UndoAction* action)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	auto it = this->entries.find(action);
+	if (it != this->entries.end())
+	{
+		removeEntry(it);
+	}
+}
+
+void UndoSpillFile::removeEntry(std::map<UndoAction*, UndoSpillEntry>::iterator it)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	release(it->second.offset, it->second.length);
+	this->entries.erase(it);
+
+	if (this->entries.empty())
+	{
+		clear();
+	}
+}
+
+std::streamoff UndoSpillFile::allocate(std::streamsize length)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	for (auto it = this->freeRanges.begin(); it != this->freeRanges.end(); it++)
+	{
+		if (it->second < length)
+		{
+			continue;
+		}
+
+		std::streamoff offset = it->first;
+		std::streamsize remaining = it->second - length;
+		this->freeRanges.erase(it);
+		if (remaining > 0)
+		{
+			this->freeRanges[offset + length] = remaining;
+		}
+		return offset;
+	}
+
+	std::streamoff offset = this->end;
+	this->end += length;
+	return offset;
+}
+
+void UndoSpillFile::release(std::streamoff offset, std::streamsize length)
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	auto next = this->freeRanges.lower_bound(offset);
+	if (next != this->freeRanges.end() && offset + length == next->first)
+	{
+		length += next->second;
+		next = this->freeRanges.erase(next);
+	}
+
+	if (next != this->freeRanges.begin())
+	{
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset)
+		{
+			offset = prev->first;
+			length += prev->second;
+			this->freeRanges.erase(prev);
+		}
+	}
+
+	if (offset + length == this->end)
+	{
+		// Free space at the end is given back by truncating on clear()
+		this->end = offset;
+	}
+	else
+	{
+		this->freeRanges[offset] = length;
+	}
+}
+
+void UndoSpillFile::clear()
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	this->entries.clear();
+	this->freeRanges.clear();
+	this->end = 0;
+
+	if (this->stream.is_open())
+	{
+		// Give the disk space back
+		this->stream.close();
+		this->stream.open(this->file.c_str(), std::fstream::in | std::fstream::out | std::fstream::binary | std::fstream::trunc);
+		if (!this->stream.is_open())
+		{
+			// open() creates a new file
+			g_unlink(this->file.c_str());
+		}
+	}
+}
+
+Path UndoSpillFile::getFile()
+{
+	XOJ_CHECK_TYPE(UndoSpillFile);
+
+	return this->file;
+}
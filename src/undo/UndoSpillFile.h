@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * Temporary file for the points of strokes which are only referenced
+ * by old undo actions. The stroke objects stay in memory, so all
+ * pointers to them stay valid, only their points are released.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <Path.h>
+#include <XournalType.h>
+
+#include <fstream>
+#include <map>
+#include <vector>
+using std::vector;
+
+class Stroke;
+class UndoAction;
+
+class UndoSpillEntry
+{
+public:
+	std::streamoff offset = 0;
+	std::streamsize length = 0;
+	vector<Stroke*> strokes;
+};
+
+class UndoSpillFile
+{
+public:
+	UndoSpillFile();
+	virtual ~UndoSpillFile();
+
+public:
+	/**
+	 * Write the strokes of the action to the file and release their points
+	 *
+	 * @return false if the file could not be written, the strokes are unchanged then
+	 */
+	bool spill(UndoAction* action, vector<Stroke*>& strokes);
+
+	/**
+	 * Read the strokes of the action back, if it was spilled
+	 *
+	 * @return false if the file could not be read, the action is kept spilled then
+	 *         and must not be applied
+	 */
+	bool restore(UndoAction* action);
+
+	bool isSpilled(UndoAction* action);
+
+	/**
+	 * Forget the action, it is deleted
+	 */
+	void remove(UndoAction* action);
+
+	/**
+	 * Forget all actions and truncate the file
+	 */
+	void clear();
+
+	/**
+	 * The temporary file, empty if nothing was spilled yet
+	 */
+	Path getFile();
+
+private:
+	bool open();
+
+	/**
+	 * @return The offset of a free range of length bytes, the file is only extended
+	 *         if no range of the freed entries is large enough
+	 */
+	std::streamoff allocate(std::streamsize length);
+	void release(std::streamoff offset, std::streamsize length);
+
+	/**
+	 * Forget the entry, the file is truncated if it was the last one
+	 */
+	void removeEntry(std::map<UndoAction*, UndoSpillEntry>::iterator it);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	Path file;
+	std::fstream stream;
+	std::streamoff end = 0;
+
+	/**
+	 * Ranges of removed entries before end, offset to length, adjacent ranges are merged
+	 */
+	std::map<std::streamoff, std::streamsize> freeRanges;
+
+	std::map<UndoAction*, UndoSpillEntry> entries;
+};
@@ -0,0 +1,215 @@
+#include "LatencyTrace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Maximum count of spans kept for the trace export, the histograms are
+ * updated also if this limit is reached
+ */
+#define LATENCY_TRACE_MAX_EVENTS 1000000
+
+/**
+ * Bucket i contains all spans with a duration of [2^(i-1), 2^i) µs
+ */
+#define LATENCY_HISTOGRAM_BUCKETS 24
+
+class LatencyTraceEvent
+{
+public:
+	const char* name;
+	gint64 begin;
+	gint64 duration;
+	int thread;
+};
+
+class LatencyHistogram
+{
+public:
+	gint64 count = 0;
+	gint64 total = 0;
+	gint64 max = 0;
+	gint64 buckets[LATENCY_HISTOGRAM_BUCKETS] = { 0 };
+
+public:
+	void add(const LatencyHistogram& other)
+	{
+		count += other.count;
+		total += other.total;
+		max = std::max(max, other.max);
+		for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+		{
+			buckets[i] += other.buckets[i];
+		}
+	}
+};
+
+std::atomic<bool> LatencyTrace::enabled(false);
+
+static GMutex traceMutex;
+static std::vector<LatencyTraceEvent> traceEvents;
+/**
+ * Keyed by the name literal, so no string is built on the hot path.
+ * The same name may have several literals, they are merged in the summary.
+ */
+static std::unordered_map<const char*, LatencyHistogram> traceHistograms;
+static gint64 traceDroppedEvents = 0;
+static std::atomic<int> traceThreadCounter(0);
+
+static int currentThreadId()
+{
+	static thread_local int id = ++traceThreadCounter;
+	return id;
+}
+
+LatencyTrace::LatencyTrace() { }
+
+LatencyTrace::~LatencyTrace() { }
+
+void LatencyTrace::setEnabled(bool enabled)
+{
+	LatencyTrace::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyTrace::addSpan(const char* name, gint64 begin, gint64 end)
+{
+	gint64 duration = end - begin;
+	int thread = currentThreadId();
+
+	int bucket = 0;
+	for (gint64 d = duration; d > 0 && bucket < LATENCY_HISTOGRAM_BUCKETS - 1; d >>= 1)
+	{
+		bucket++;
+	}
+
+	g_mutex_lock(&traceMutex);
+
+	if (traceEvents.size() < LATENCY_TRACE_MAX_EVENTS)
+	{
+		traceEvents.push_back({ name, begin, duration, thread });
+	}
+	else
+	{
+		traceDroppedEvents++;
+	}
+
+	LatencyHistogram& h = traceHistograms[name];
+	h.count++;
+	h.total += duration;
+	h.max = std::max(h.max, duration);
+	h.buckets[bucket]++;
+
+	g_mutex_unlock(&traceMutex);
+}
+
+void LatencyTrace::reset()
+{
+	g_mutex_lock(&traceMutex);
+
+	traceEvents.clear();
+	traceHistograms.clear();
+	traceDroppedEvents = 0;
+
+	g_mutex_unlock(&traceMutex);
+}
+
+static void writeJsonString(std::ostream& out, const char* str)
+{
+	out << '"';
+	for (const char* c = str; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			out << '\\';
+		}
+		out << *c;
+	}
+	out << '"';
+}
+
+bool LatencyTrace::writeChromeTrace(Path file)
+{
+	std::ofstream out(file.c_str(), std::ofstream::out | std::ofstream::trunc);
+	if (!out.is_open())
+	{
+		return false;
+	}
+	out.imbue(std::locale::classic());
+
+	g_mutex_lock(&traceMutex);
+
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	bool first = true;
+	for (LatencyTraceEvent& e : traceEvents)
+	{
+		out << (first ? "\n" : ",\n");
+		first = false;
+
+		out << "{\"name\": ";
+		writeJsonString(out, e.name);
+		out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread
+		    << ", \"ts\": " << e.begin << ", \"dur\": " << e.duration << "}";
+	}
+
+	out << "\n], \"otherData\": {\"droppedEvents\": " << traceDroppedEvents << "}}\n";
+
+	g_mutex_unlock(&traceMutex);
+
+	return out.good();
+}
+
+string LatencyTrace::getSummary()
+{
+	std::ostringstream out;
+	out.imbue(std::locale::classic());
+
+	g_mutex_lock(&traceMutex);
+
+	std::map<string, LatencyHistogram> histograms;
+	for (auto& it : traceHistograms)
+	{
+		histograms[it.first].add(it.second);
+	}
+
+	for (auto& it : histograms)
+	{
+		LatencyHistogram& h = it.second;
+
+		out << it.first << "\n";
+		out << "  count " << h.count << ", mean " << h.total / h.count << " µs, max " << h.max << " µs\n";
+
+		gint64 maxBucket = 1;
+		for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+		{
+			maxBucket = std::max(maxBucket, h.buckets[i]);
+		}
+
+		for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+		{
+			if (h.buckets[i] == 0)
+			{
+				continue;
+			}
+
+			gint64 upper = ((gint64) 1) << i;
+			out << "  < " << std::setw(9) << upper << " µs " << std::setw(8) << h.buckets[i] << " "
+			    << string((size_t) (h.buckets[i] * 40 / maxBucket), '#') << "\n";
+		}
+		out << "\n";
+	}
+
+	if (traceDroppedEvents > 0)
+	{
+		out << traceDroppedEvents << " spans not kept for the trace export\n";
+	}
+
+	g_mutex_unlock(&traceMutex);
+
+	return out.str();
+}
@@ -0,0 +1,99 @@
+/*
+ * Xournal++
+ *
+ * Lightweight latency tracing of the input and rendering hot path.
+ * Spans can be exported as Chrome / Perfetto trace (chrome://tracing, ui.perfetto.dev)
+ * and are summarized as latency histograms.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <Path.h>
+
+#include <glib.h>
+
+#include <atomic>
+#include <string>
+using std::string;
+
+class LatencyTrace
+{
+private:
+	LatencyTrace();
+	virtual ~LatencyTrace();
+
+public:
+	/**
+	 * Tracing is disabled by default, this is the only check
+	 * done on the hot path if it's disabled
+	 */
+	static inline bool isEnabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	static void setEnabled(bool enabled);
+
+	/**
+	 * Record a finished span, begin and end from g_get_monotonic_time()
+	 *
+	 * @param name Span name, has to be a string literal (only the pointer is stored)
+	 */
+	static void addSpan(const char* name, gint64 begin, gint64 end);
+
+	/**
+	 * Remove all recorded spans and histograms
+	 */
+	static void reset();
+
+	/**
+	 * Write all recorded spans in the Chrome trace event format
+	 *
+	 * @return false if the file could not be written
+	 */
+	static bool writeChromeTrace(Path file);
+
+	/**
+	 * A human readable histogram summary per span name
+	 */
+	static string getSummary();
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+/**
+ * Records a span from construction until it goes out of scope:
+ *
+ * LatencySpan span("StrokeHandler::onMotionNotifyEvent");
+ */
+class LatencySpan
+{
+public:
+	inline LatencySpan(const char* name)
+	 : name(name),
+	   begin(LatencyTrace::isEnabled() ? g_get_monotonic_time() : 0)
+	{
+	}
+
+	inline ~LatencySpan()
+	{
+		if (this->begin != 0)
+		{
+			LatencyTrace::addSpan(this->name, this->begin, g_get_monotonic_time());
+		}
+	}
+
+private:
+	LatencySpan(const LatencySpan&);
+	void operator=(const LatencySpan&);
+
+private:
+	const char* name;
+	gint64 begin;
+};
@@ -94,4 +94,40 @@ bool StringUtils::iequals(string a, string b)
 	return result == 0;
 }
 
-
+string StringUtils::escapeJson(string str)
+{
+	string out;
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+			if ((unsigned char) c < 0x20)
+			{
+				char buffer[8];
+				g_snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char) c);
+				out += buffer;
+			}
+			else
+			{
+				out += c;
+			}
+		}
+	}
+	return out;
+}
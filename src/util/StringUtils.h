@@ -30,4 +30,9 @@ public:
 	static string rtrim(string str);
 	static string trim(string str);
 	static bool iequals(string a, string b);
+
+	/**
+	 * Escape a string for use inside a JSON string literal (without the quotes)
+	 */
+	static string escapeJson(string str);
 };
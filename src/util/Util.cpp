@@ -9,6 +9,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 class CallbackUiData {
 public:
@@ -51,6 +54,79 @@ void Util::cairo_set_source_rgbi(cairo_t* cr, int c)
 	cairo_set_source_rgb(cr, r, g, b);
 }
 
+bool Util::cairo_is_vector_target(cairo_t* cr)
+{
+	cairo_surface_type_t type = cairo_surface_get_type(cairo_get_target(cr));
+	return type == CAIRO_SURFACE_TYPE_PDF || type == CAIRO_SURFACE_TYPE_PS || type == CAIRO_SURFACE_TYPE_SVG
+		|| type == CAIRO_SURFACE_TYPE_RECORDING || type == CAIRO_SURFACE_TYPE_SCRIPT;
+}
+
+double Util::cairo_get_device_scale(cairo_t* cr)
+{
+	double sx = 1;
+	double sy = 0;
+	cairo_user_to_device_distance(cr, &sx, &sy);
+	double tx = 0;
+	double ty = 1;
+	cairo_user_to_device_distance(cr, &tx, &ty);
+
+	return std::max(std::hypot(sx, sy), std::hypot(tx, ty));
+}
+
+void Util::cairo_downsample_box(cairo_surface_t* source, cairo_surface_t* target, int x, int y, int width, int height)
+{
+	int srcWidth = cairo_image_surface_get_width(source);
+	int srcHeight = cairo_image_surface_get_height(source);
+
+	width = std::min(width, cairo_image_surface_get_width(target) - x);
+	height = std::min(height, cairo_image_surface_get_height(target) - y);
+	if (srcWidth <= 0 || srcHeight <= 0 || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	cairo_surface_flush(source);
+	cairo_surface_flush(target);
+
+	const guint8* srcData = cairo_image_surface_get_data(source);
+	int srcStride = cairo_image_surface_get_stride(source);
+	guint8* dstData = cairo_image_surface_get_data(target);
+	int dstStride = cairo_image_surface_get_stride(target);
+
+	for (int dy = 0; dy < height; dy++)
+	{
+		int y0 = (int) ((gint64) dy * srcHeight / height);
+		int y1 = std::max(y0 + 1, (int) ((gint64) (dy + 1) * srcHeight / height));
+		guint32* dstRow = (guint32*) (dstData + (gint64) (y + dy) * dstStride) + x;
+
+		for (int dx = 0; dx < width; dx++)
+		{
+			int x0 = (int) ((gint64) dx * srcWidth / width);
+			int x1 = std::max(x0 + 1, (int) ((gint64) (dx + 1) * srcWidth / width));
+
+			// Premultiplied, so the channels can be averaged independently
+			guint32 a = 0, r = 0, g = 0, b = 0;
+			for (int sy = y0; sy < y1; sy++)
+			{
+				const guint32* srcRow = (const guint32*) (srcData + (gint64) sy * srcStride);
+				for (int sx = x0; sx < x1; sx++)
+				{
+					guint32 p = srcRow[sx];
+					a += p >> 24;
+					r += (p >> 16) & 0xff;
+					g += (p >> 8) & 0xff;
+					b += p & 0xff;
+				}
+			}
+
+			guint32 count = (y1 - y0) * (x1 - x0);
+			dstRow[dx] = ((a / count) << 24) | ((r / count) << 16) | ((g / count) << 8) | (b / count);
+		}
+	}
+
+	cairo_surface_mark_dirty(target);
+}
+
 
 void Util::apply_rgb_togdkrgba(GdkRGBA& col, int color)
 {
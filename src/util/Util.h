@@ -30,6 +30,22 @@ private:
 public:
 	static void cairo_set_source_rgbi(cairo_t* cr, int color);
 
+	/**
+	 * @return true if the target of the context is a vector surface (PDF, PostScript, SVG, recording)
+	 */
+	static bool cairo_is_vector_target(cairo_t* cr);
+
+	/**
+	 * @return Device pixels per user unit of the current transformation
+	 */
+	static double cairo_get_device_scale(cairo_t* cr);
+
+	/**
+	 * Scale an ARGB32 image surface into the rectangle x/y/width/height of target with a box filter,
+	 * every target pixel is the average of all source pixels it covers
+	 */
+	static void cairo_downsample_box(cairo_surface_t* source, cairo_surface_t* target, int x, int y, int width, int height);
+
 	static void apply_rgb_togdkrgba(GdkRGBA& col, int color);
 	static int gdkrgba_to_hex(GdkRGBA& color);
 
@@ -137,6 +137,16 @@ PreviewExtractResult XojPreviewExtractor::readFile(Path file)
 		return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
 	}
 
+	PreviewExtractResult result = readZipPreview(zipFp);
+	zip_close(zipFp);
+	return result;
+}
+
+/**
+ * Read thumbnails/thumbnail.png out of an opened .xopp file
+ */
+PreviewExtractResult XojPreviewExtractor::readZipPreview(zip_t* zipFp)
+{
 	zip_stat_t thumbStat;
 	int statStatus = zip_stat(zipFp, "thumbnails/thumbnail.png", 0, &thumbStat);
 	if (statStatus != 0)
@@ -144,10 +154,7 @@ PreviewExtractResult XojPreviewExtractor::readFile(Path file)
 		return PREVIEW_RESULT_NO_PREVIEW;
 	}
 
-	if (thumbStat.valid & ZIP_STAT_SIZE)
-	{
-		dataLen = thumbStat.size;
-	} else
+	if (!(thumbStat.valid & ZIP_STAT_SIZE))
 	{
 		return PREVIEW_RESULT_ERROR_READING_PREVIEW;
 	}
@@ -160,13 +167,18 @@ PreviewExtractResult XojPreviewExtractor::readFile(Path file)
 	}
 
 	data = (unsigned char *)g_malloc(thumbStat.size);
+	dataLen = thumbStat.size;
+
 	zip_uint64_t readBytes = 0;
 	while (readBytes < dataLen)
 	{
-		zip_int64_t read = zip_fread(thumb, data, thumbStat.size);
-		if (read == -1)
+		zip_int64_t read = zip_fread(thumb, data + readBytes, dataLen - readBytes);
+		if (read <= 0)
 		{
 			g_free(data);
+			data = NULL;
+			dataLen = 0;
+			zip_fclose(thumb);
 			return PREVIEW_RESULT_ERROR_READING_PREVIEW;
 		}
 
@@ -174,8 +186,5 @@ PreviewExtractResult XojPreviewExtractor::readFile(Path file)
 	}
 
 	zip_fclose(thumb);
-	zip_close(zipFp);
 	return PREVIEW_RESULT_IMAGE_READ;
 }
-
-
@@ -16,6 +16,8 @@
 
 #include <Path.h>
 
+#include <zip.h>
+
 #include <string>
 using std::string;
 
@@ -75,6 +77,12 @@ public:
 	 */
 	unsigned char* getData(gsize& dataLen);
 
+private:
+	/**
+	 * Read thumbnails/thumbnail.png out of an opened .xopp file
+	 */
+	PreviewExtractResult readZipPreview(zip_t* zipFp);
+
 	// Member
 private:
 
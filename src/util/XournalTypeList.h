@@ -40,7 +40,6 @@ XOJ_DECLARE_TYPE(XournalppCursor, 28);
 XOJ_DECLARE_TYPE(GladeGui, 29);
 XOJ_DECLARE_TYPE(GladeSearchpath, 30);
 XOJ_DECLARE_TYPE(EraseableStroke, 31);
-XOJ_DECLARE_TYPE(EraseableStrokePart, 32);
 XOJ_DECLARE_TYPE(Document, 33);
 XOJ_DECLARE_TYPE(DocumentHandler, 34);
 XOJ_DECLARE_TYPE(DocumentListener, 35);
@@ -153,7 +152,6 @@ XOJ_DECLARE_TYPE(GzOutputStream, 142);
 XOJ_DECLARE_TYPE(PageBackgroundChangedUndoAction, 143);
 XOJ_DECLARE_TYPE(PdfExportJob, 144);
 XOJ_DECLARE_TYPE(BackgroundImage, 145);
-XOJ_DECLARE_TYPE(PartList, 146);
 XOJ_DECLARE_TYPE(PageRangeEntry, 147);
 XOJ_DECLARE_TYPE(ImageExport, 148);
 XOJ_DECLARE_TYPE(ColorSelectImage, 149);
@@ -294,3 +292,17 @@ XOJ_DECLARE_TYPE(StylusInputHandler, 284);
 XOJ_DECLARE_TYPE(TouchDrawingInputHandler, 285);
 XOJ_DECLARE_TYPE(TouchInputHandler, 286);
 XOJ_DECLARE_TYPE(TouchDisableGdk, 287);
+XOJ_DECLARE_TYPE(InputRecorder, 288);
+XOJ_DECLARE_TYPE(InputReplay, 289);
+XOJ_DECLARE_TYPE(LatencyDialog, 290);
+XOJ_DECLARE_TYPE(LiveStrokeView, 291);
+XOJ_DECLARE_TYPE(LiveStrokeMask, 292);
+XOJ_DECLARE_TYPE(EraserCapsule, 293);
+XOJ_DECLARE_TYPE(StrokeSegmentTree, 294);
+XOJ_DECLARE_TYPE(ClipboardContents, 295);
+XOJ_DECLARE_TYPE(UndoSpillFile, 296);
+XOJ_DECLARE_TYPE(LatexCompiler, 297);
+XOJ_DECLARE_TYPE(RenderContext, 298);
+XOJ_DECLARE_TYPE(SearchIndexPage, 299);
+XOJ_DECLARE_TYPE(SearchIndex, 300);
+XOJ_DECLARE_TYPE(SearchIndexJob, 301);
@@ -12,6 +12,7 @@
 
 #include <config.h>
 #include <config-debug.h>
+#include <Util.h>
 
 
 DocumentView::DocumentView()
@@ -132,6 +133,44 @@ void DocumentView::drawImage(cairo_t* cr, Image* i)
 	cairo_set_matrix(cr, &defaultMatrix);
 }
 
+/**
+ * Draws the LaTeX PDF from the raster cache of the TexImage, if the target is a raster
+ * surface. PDF export, printing and SVG still get the vector version.
+ *
+ * @return false if the vector version needs to be drawn
+ */
+bool DocumentView::drawTexImageRaster(cairo_t* cr, TexImage* texImage)
+{
+	XOJ_CHECK_TYPE(DocumentView);
+
+	if (Util::cairo_is_vector_target(cr))
+	{
+		return false;
+	}
+
+	cairo_surface_t* raster = texImage->getPdfRaster(Util::cairo_get_device_scale(cr));
+	if (raster == NULL)
+	{
+		return false;
+	}
+
+	double xFactor = texImage->getElementWidth() / cairo_image_surface_get_width(raster);
+	double yFactor = texImage->getElementHeight() / cairo_image_surface_get_height(raster);
+
+	cairo_save(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+	cairo_translate(cr, texImage->getX(), texImage->getY());
+	cairo_scale(cr, xFactor, yFactor);
+	cairo_set_source_surface(cr, raster, 0, 0);
+	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+	cairo_paint(cr);
+	cairo_restore(cr);
+
+	cairo_surface_destroy(raster);
+
+	return true;
+}
+
 void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage)
 {
 	XOJ_CHECK_TYPE(DocumentView);
@@ -142,6 +181,11 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage)
 	PopplerDocument* pdf = texImage->getPdf();
 	cairo_surface_t* img = texImage->getImage();
 
+	if (pdf != nullptr && drawTexImageRaster(cr, texImage))
+	{
+		return;
+	}
+
 	if (pdf != nullptr)
 	{
 		if (poppler_document_get_n_pages(pdf) < 1)
@@ -162,6 +206,7 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage)
 		cairo_translate(cr, texImage->getX(), texImage->getY());
 		cairo_scale(cr, xFactor, yFactor);
 		poppler_page_render(page, cr);
+		g_object_unref(page);
 	}
 	else if (img != nullptr)
 	{
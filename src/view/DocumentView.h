@@ -97,6 +97,7 @@ private:
 	void drawText(cairo_t* cr, Text* t);
 	void drawImage(cairo_t* cr, Image* i);
 	void drawTexImage(cairo_t* cr, TexImage* texImage);
+	bool drawTexImageRaster(cairo_t* cr, TexImage* texImage);
 
 	void drawElement(cairo_t* cr, Element* e);
 
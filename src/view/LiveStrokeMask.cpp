@@ -0,0 +1,146 @@
+#include "LiveStrokeMask.h"
+
+#include <string.h>
+#include <vector>
+
+/**
+ * Count of unused tiles kept for the next strokes (64 KiB each)
+ */
+#define LIVE_STROKE_TILE_POOL_SIZE 128
+
+static GMutex tilePoolMutex;
+static std::vector<cairo_surface_t*> tilePool;
+
+LiveStrokeMask::LiveStrokeMask()
+{
+	XOJ_INIT_TYPE(LiveStrokeMask);
+}
+
+LiveStrokeMask::~LiveStrokeMask()
+{
+	XOJ_CHECK_TYPE(LiveStrokeMask);
+
+	clear();
+
+	XOJ_RELEASE_TYPE(LiveStrokeMask);
+}
+
+void LiveStrokeMask::start(int width, int height, double scale, cairo_antialias_t antialias, cairo_operator_t op)
+{
+	XOJ_CHECK_TYPE(LiveStrokeMask);
+
+	clear();
+
+	this->scale = scale;
+	this->tilesX = (width + LIVE_STROKE_TILE_SIZE - 1) / LIVE_STROKE_TILE_SIZE;
+	this->tilesY = (height + LIVE_STROKE_TILE_SIZE - 1) / LIVE_STROKE_TILE_SIZE;
+	this->antialias = antialias;
+	this->op = op;
+}
+
+cairo_surface_t* LiveStrokeMask::acquireSurface()
+{
+	g_mutex_lock(&tilePoolMutex);
+
+	cairo_surface_t* surface = NULL;
+	if (!tilePool.empty())
+	{
+		surface = tilePool.back();
+		tilePool.pop_back();
+	}
+
+	g_mutex_unlock(&tilePoolMutex);
+
+	if (surface == NULL)
+	{
+		// Image surfaces are initially transparent
+		return cairo_image_surface_create(CAIRO_FORMAT_A8, LIVE_STROKE_TILE_SIZE, LIVE_STROKE_TILE_SIZE);
+	}
+
+	cairo_surface_flush(surface);
+	memset(cairo_image_surface_get_data(surface), 0, cairo_image_surface_get_stride(surface) * LIVE_STROKE_TILE_SIZE);
+	cairo_surface_mark_dirty(surface);
+
+	return surface;
+}
+
+void LiveStrokeMask::releaseSurface(cairo_surface_t* surface)
+{
+	g_mutex_lock(&tilePoolMutex);
+
+	if (tilePool.size() < LIVE_STROKE_TILE_POOL_SIZE)
+	{
+		tilePool.push_back(surface);
+		surface = NULL;
+	}
+
+	g_mutex_unlock(&tilePoolMutex);
+
+	if (surface)
+	{
+		cairo_surface_destroy(surface);
+	}
+}
+
+cairo_t* LiveStrokeMask::getTile(int tx, int ty)
+{
+	XOJ_CHECK_TYPE(LiveStrokeMask);
+
+	int key = (ty << 16) | tx;
+	auto it = this->tiles.find(key);
+	if (it != this->tiles.end())
+	{
+		return it->second;
+	}
+
+	cairo_surface_t* surface = acquireSurface();
+	cairo_t* cr = cairo_create(surface);
+	// cairo_t holds a reference
+	cairo_surface_destroy(surface);
+
+	cairo_translate(cr, -tx * LIVE_STROKE_TILE_SIZE, -ty * LIVE_STROKE_TILE_SIZE);
+	cairo_scale(cr, this->scale, this->scale);
+
+	cairo_set_source_rgba(cr, 1, 1, 1, 1);
+	cairo_set_antialias(cr, this->antialias);
+	cairo_set_operator(cr, this->op);
+	cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+	cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+
+	this->tiles[key] = cr;
+	return cr;
+}
+
+void LiveStrokeMask::paint(cairo_t* cr)
+{
+	XOJ_CHECK_TYPE(LiveStrokeMask);
+
+	double x1, y1, x2, y2;
+	cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+
+	for (auto& it : this->tiles)
+	{
+		double x = (it.first & 0xffff) * LIVE_STROKE_TILE_SIZE;
+		double y = (it.first >> 16) * LIVE_STROKE_TILE_SIZE;
+
+		if (x > x2 || y > y2 || x + LIVE_STROKE_TILE_SIZE < x1 || y + LIVE_STROKE_TILE_SIZE < y1)
+		{
+			continue;
+		}
+
+		cairo_mask_surface(cr, cairo_get_target(it.second), x, y);
+	}
+}
+
+void LiveStrokeMask::clear()
+{
+	XOJ_CHECK_TYPE(LiveStrokeMask);
+
+	for (auto& it : this->tiles)
+	{
+		cairo_surface_t* surface = cairo_surface_reference(cairo_get_target(it.second));
+		cairo_destroy(it.second);
+		releaseSurface(surface);
+	}
+	this->tiles.clear();
+}
@@ -0,0 +1,98 @@
+/*
+ * Xournal++
+ *
+ * A8 mask for the stroke which is currently drawn, allocated as
+ * tiles only where something is drawn. Tiles are reused across strokes.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <XournalType.h>
+
+#include <gtk/gtk.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+/**
+ * Tile width and height in pixel
+ */
+#define LIVE_STROKE_TILE_SIZE 256
+
+class LiveStrokeMask
+{
+public:
+	LiveStrokeMask();
+	virtual ~LiveStrokeMask();
+
+public:
+	/**
+	 * Start a new, empty mask
+	 *
+	 * @param width Mask width in pixel
+	 * @param height Mask height in pixel
+	 * @param scale Scale from page coordinates to pixel
+	 * @param antialias Antialias mode of the tiles
+	 * @param op Operator used to draw to the tiles
+	 */
+	void start(int width, int height, double scale, cairo_antialias_t antialias, cairo_operator_t op);
+
+	/**
+	 * Call fn(cairo_t*) for each tile which intersects the area
+	 * x1, y1, x2, y2 (page coordinates), the tiles are allocated on demand.
+	 * The cairo_t is in page coordinates.
+	 */
+	template <class DrawFunction>
+	void draw(double x1, double y1, double x2, double y2, DrawFunction fn)
+	{
+		int tx1 = std::max(0, (int) std::floor(x1 * this->scale / LIVE_STROKE_TILE_SIZE));
+		int ty1 = std::max(0, (int) std::floor(y1 * this->scale / LIVE_STROKE_TILE_SIZE));
+		int tx2 = std::min(this->tilesX - 1, (int) std::floor(x2 * this->scale / LIVE_STROKE_TILE_SIZE));
+		int ty2 = std::min(this->tilesY - 1, (int) std::floor(y2 * this->scale / LIVE_STROKE_TILE_SIZE));
+
+		for (int ty = ty1; ty <= ty2; ty++)
+		{
+			for (int tx = tx1; tx <= tx2; tx++)
+			{
+				fn(getTile(tx, ty));
+			}
+		}
+	}
+
+	/**
+	 * Paint the current source of cr masked with this mask,
+	 * cr has to be in mask pixel coordinates
+	 */
+	void paint(cairo_t* cr);
+
+	/**
+	 * Give all tiles back for the next stroke
+	 */
+	void clear();
+
+private:
+	cairo_t* getTile(int tx, int ty);
+
+	static cairo_surface_t* acquireSurface();
+	static void releaseSurface(cairo_surface_t* surface);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	double scale = 1;
+	int tilesX = 0;
+	int tilesY = 0;
+	cairo_antialias_t antialias = CAIRO_ANTIALIAS_DEFAULT;
+	cairo_operator_t op = CAIRO_OPERATOR_OVER;
+
+	/**
+	 * Allocated tiles, key is (ty << 16) | tx
+	 */
+	std::map<int, cairo_t*> tiles;
+};
@@ -0,0 +1,174 @@
+#include "LiveStrokeView.h"
+
+#include "model/Stroke.h"
+
+#include <LatencyTrace.h>
+
+LiveStrokeView::LiveStrokeView()
+{
+	XOJ_INIT_TYPE(LiveStrokeView);
+}
+
+LiveStrokeView::~LiveStrokeView()
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	destroy();
+
+	XOJ_RELEASE_TYPE(LiveStrokeView);
+}
+
+void LiveStrokeView::start(Stroke* stroke, int width, int height, double scale)
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	this->stroke = stroke;
+	this->drawnPoints = stroke->getPointCount();
+	this->dashOffset = 0;
+
+	this->lineMask.start(width, height, scale, CAIRO_ANTIALIAS_DEFAULT, CAIRO_OPERATOR_OVER);
+
+	// Filled on finish, the tiles are only allocated then
+	this->fill = stroke->getFill() != -1 && stroke->getToolType() != STROKE_TOOL_HIGHLIGHTER;
+	if (this->fill)
+	{
+		this->fillMask.start(width, height, scale, CAIRO_ANTIALIAS_DEFAULT, CAIRO_OPERATOR_OVER);
+	}
+}
+
+bool LiveStrokeView::drawNewSegments(Range& damage)
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	LatencySpan span("LiveStrokeView::drawNewSegments");
+
+	int pointCount = this->stroke->getPointCount();
+	if (this->drawnPoints >= pointCount)
+	{
+		return false;
+	}
+
+	for (int i = std::max(this->drawnPoints, 1); i < pointCount; i++)
+	{
+		drawSegment(i, damage);
+	}
+	this->drawnPoints = pointCount;
+
+	return true;
+}
+
+void LiveStrokeView::drawSegment(int index, Range& damage)
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	Point p1 = this->stroke->getPoint(index - 1);
+	Point p2 = this->stroke->getPoint(index);
+
+	double width = this->stroke->getWidth();
+	if (p1.z != Point::NO_PRESSURE && this->stroke->getToolType() != STROKE_TOOL_HIGHLIGHTER)
+	{
+		width = p1.z;
+	}
+
+	const double* dashes = NULL;
+	int dashCount = 0;
+	bool dashed = this->stroke->getLineStyle().getDashes(dashes, dashCount);
+
+	this->lineMask.draw(std::min(p1.x, p2.x) - width, std::min(p1.y, p2.y) - width,
+	                    std::max(p1.x, p2.x) + width, std::max(p1.y, p2.y) + width,
+	                    [&](cairo_t* cr)
+	{
+		cairo_set_line_width(cr, width);
+		if (dashed)
+		{
+			cairo_set_dash(cr, dashes, dashCount, this->dashOffset);
+		}
+
+		cairo_move_to(cr, p1.x, p1.y);
+		cairo_line_to(cr, p2.x, p2.y);
+		cairo_stroke(cr);
+	});
+
+	this->dashOffset += p1.lineLengthTo(p2);
+
+	damage.addPoint(p1.x - width, p1.y - width);
+	damage.addPoint(p1.x + width, p1.y + width);
+	damage.addPoint(p2.x - width, p2.y - width);
+	damage.addPoint(p2.x + width, p2.y + width);
+}
+
+void LiveStrokeView::finish()
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	if (this->stroke->getFill() != -1 && this->stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER)
+	{
+		// The stroke is not filled on drawing time
+		// If the stroke has fill values, it needs to be re-rendered
+		// else the fill will not be visible.
+
+		double w = this->stroke->getWidth();
+		this->lineMask.draw(this->stroke->getX() - w, this->stroke->getY() - w,
+		                    this->stroke->getX() + this->stroke->getElementWidth() + w,
+		                    this->stroke->getY() + this->stroke->getElementHeight() + w,
+		                    [&](cairo_t* cr)
+		{
+			this->view.drawStroke(cr, this->stroke, 0, 1, true, true);
+		});
+	}
+	else if (this->fill)
+	{
+		// Same path, fill rule and antialiasing as StrokeView::drawFillStroke()
+		this->fillMask.draw(this->stroke->getX(), this->stroke->getY(),
+		                    this->stroke->getX() + this->stroke->getElementWidth(),
+		                    this->stroke->getY() + this->stroke->getElementHeight(),
+		                    [&](cairo_t* cr)
+		{
+			int count = this->stroke->getPointCount();
+			for (int i = 0; i < count; i++)
+			{
+				Point p = this->stroke->getPoint(i);
+				cairo_line_to(cr, p.x, p.y);
+			}
+			cairo_fill(cr);
+		});
+	}
+}
+
+void LiveStrokeView::paint(cairo_t* cr)
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	if (this->stroke == NULL)
+	{
+		return;
+	}
+
+	if (this->fill)
+	{
+		cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+		DocumentView::applyColor(cr, this->stroke, this->stroke->getFill());
+		this->fillMask.paint(cr);
+	}
+
+	DocumentView::applyColor(cr, this->stroke);
+
+	if (this->stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER)
+	{
+		cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
+	}
+	else
+	{
+		cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+	}
+
+	this->lineMask.paint(cr);
+}
+
+void LiveStrokeView::destroy()
+{
+	XOJ_CHECK_TYPE(LiveStrokeView);
+
+	this->lineMask.clear();
+	this->fillMask.clear();
+}
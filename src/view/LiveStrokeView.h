@@ -0,0 +1,110 @@
+/*
+ * Xournal++
+ *
+ * Draws the stroke which is currently drawn incrementally:
+ * each added point only draws the new segment, so the cost
+ * per point does not depend on the length of the stroke.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "DocumentView.h"
+#include "LiveStrokeMask.h"
+
+#include <Range.h>
+#include <XournalType.h>
+
+#include <gtk/gtk.h>
+
+class Stroke;
+
+/**
+ * The stroke is drawn opaquely on the initially transparent (tiled)
+ * mask, which is then used to mask the stroke color.
+ *
+ * Dashes continue over the segments, the dash offset is the length of
+ * the stroke so far.
+ *
+ * The fill is only drawn on finish, with the same path as the final
+ * rendering: an incremental fill would either need the even-odd rule or
+ * change the area up to the first point on each event, so the damage
+ * would grow with the stroke.
+ */
+class LiveStrokeView
+{
+public:
+	LiveStrokeView();
+	virtual ~LiveStrokeView();
+
+public:
+	/**
+	 * Start drawing a new stroke
+	 *
+	 * @param width Mask width in pixel
+	 * @param height Mask height in pixel
+	 * @param scale Scale from page coordinates to pixel
+	 */
+	void start(Stroke* stroke, int width, int height, double scale);
+
+	/**
+	 * Draw the segments to all points added since the last call
+	 *
+	 * @param damage The changed area (in page coordinates) is added
+	 * @return true if something was drawn
+	 */
+	bool drawNewSegments(Range& damage);
+
+	/**
+	 * The stroke is finished, draws everything which is not drawn live
+	 */
+	void finish();
+
+	/**
+	 * Paint the stroke to cr, which has to be in mask pixel coordinates
+	 */
+	void paint(cairo_t* cr);
+
+	/**
+	 * Give the mask tiles back
+	 */
+	void destroy();
+
+private:
+	/**
+	 * Draw the segment from point index - 1 to index
+	 */
+	void drawSegment(int index, Range& damage);
+
+private:
+	XOJ_TYPE_ATTRIB;
+
+	Stroke* stroke = NULL;
+
+	/**
+	 * Mask of the stroke line
+	 */
+	LiveStrokeMask lineMask;
+
+	/**
+	 * Mask of the fill, drawn on finish (not used for highlighter strokes)
+	 */
+	LiveStrokeMask fillMask;
+	bool fill = false;
+
+	/**
+	 * Count of points which are already drawn
+	 */
+	int drawnPoints = 0;
+
+	/**
+	 * Length of the stroke until the last drawn point
+	 */
+	double dashOffset = 0;
+
+	DocumentView view;
+};
@@ -7,17 +7,72 @@
 #include <Util.h>
 #include <StringUtils.h>
 
+#include <unordered_map>
+
 TextView::TextView() { }
 
 TextView::~TextView() { }
 
 static int textDpi = 72;
 
+/**
+ * Maximum number of cached layouts per thread, the cache is cleared if it is full
+ */
+#define TEXT_LAYOUT_CACHE_SIZE 1024
+
+/**
+ * The shaped layouts of one thread, with their own font map
+ */
+class TextLayoutCache
+{
+public:
+	struct Entry
+	{
+		PangoLayout* layout;
+		guint64 version;
+		int dpi;
+	};
+
+	TextLayoutCache()
+	{
+		this->fontMap = pango_cairo_font_map_new();
+	}
+
+	~TextLayoutCache()
+	{
+		clear();
+		g_object_unref(this->fontMap);
+	}
+
+	void clear()
+	{
+		for (auto& it : this->layouts)
+		{
+			g_object_unref(it.second.layout);
+		}
+		this->layouts.clear();
+	}
+
+public:
+	PangoFontMap* fontMap;
+
+	/**
+	 * Entries of deleted Text elements are only removed if the cache is cleared,
+	 * their version never matches a new Text
+	 */
+	std::unordered_map<Text*, Entry> layouts;
+};
+
 void TextView::setDpi(int dpi)
 {
 	textDpi = dpi;
 }
 
+int TextView::getDpi()
+{
+	return textDpi;
+}
+
 PangoLayout* TextView::initPango(cairo_t* cr, Text* t)
 {
 	PangoLayout* layout = pango_cairo_create_layout(cr);
@@ -34,6 +89,49 @@ PangoLayout* TextView::initPango(cairo_t* cr, Text* t)
 	return layout;
 }
 
+PangoLayout* TextView::getLayout(Text* t)
+{
+	static thread_local TextLayoutCache cache;
+
+	guint64 version = t->getLayoutVersion();
+
+	auto it = cache.layouts.find(t);
+	if (it != cache.layouts.end())
+	{
+		if (it->second.version == version && it->second.dpi == textDpi)
+		{
+			return it->second.layout;
+		}
+
+		g_object_unref(it->second.layout);
+		cache.layouts.erase(it);
+	}
+
+	if (cache.layouts.size() >= TEXT_LAYOUT_CACHE_SIZE)
+	{
+		cache.clear();
+	}
+
+	PangoContext* context = pango_font_map_create_context(cache.fontMap);
+	pango_cairo_context_set_resolution(context, textDpi);
+	pango_context_set_matrix(context, NULL);
+
+	PangoLayout* layout = pango_layout_new(context);
+	g_object_unref(context);
+
+	updatePangoFont(layout, t);
+
+	string str = t->getText();
+	pango_layout_set_text(layout, str.c_str(), str.length());
+
+	// Shape the text now, not on the first draw
+	pango_layout_get_size(layout, NULL, NULL);
+
+	cache.layouts[t] = { layout, version, textDpi };
+
+	return layout;
+}
+
 void TextView::updatePangoFont(PangoLayout* layout, Text* t)
 {
 	PangoFontDescription* desc = pango_font_description_from_string(t->getFont().getName().c_str());
@@ -50,37 +148,24 @@ void TextView::drawText(cairo_t* cr, Text* t)
 
 	cairo_translate(cr, t->getX(), t->getY());
 
-	PangoLayout* layout = initPango(cr, t);
-	string str = t->getText();
-	pango_layout_set_text(layout, str.c_str(), str.length());
-
-	pango_cairo_show_layout(cr, layout);
-
-	g_object_unref(layout);
+	pango_cairo_show_layout(cr, getLayout(t));
 
 	cairo_restore(cr);
 }
 
 vector<XojPdfRectangle> TextView::findText(Text* t, string& search)
 {
-	cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-	cairo_t* cr = cairo_create(surface);
-
-	PangoLayout* layout = initPango(cr, t);
-	string str = t->getText();
-	pango_layout_set_text(layout, str.c_str(), str.length());
-
-
-	string text = t->getText();
-
+	string text = StringUtils::toLowerCase(t->getText());
 	string srch = StringUtils::toLowerCase(search);
 
 	vector<XojPdfRectangle> list;
 
+	PangoLayout* layout = getLayout(t);
+
 	int pos = -1;
 	do
 	{
-		pos = StringUtils::toLowerCase(text).find(srch, pos + 1);
+		pos = text.find(srch, pos + 1);
 		if (pos != -1)
 		{
 			XojPdfRectangle mark;
@@ -98,28 +183,16 @@ vector<XojPdfRectangle> TextView::findText(Text* t, string& search)
 	}
 	while (pos != -1);
 
-	g_object_unref(layout);
-	cairo_surface_destroy(surface);
-	cairo_destroy(cr);
-
 	return list;
 }
 
 void TextView::calcSize(Text* t, double& width, double& height)
 {
-	cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-	cairo_t* cr = cairo_create(surface);
-
-	PangoLayout* layout = initPango(cr, t);
-	string str = t->getText();
-	pango_layout_set_text(layout, str.c_str(), str.length());
 	int w = 0;
 	int h = 0;
-	pango_layout_get_size(layout, &w, &h);
+
+	pango_layout_get_size(getLayout(t), &w, &h);
+
 	width = ((double) w) / PANGO_SCALE;
 	height = ((double) h) / PANGO_SCALE;
-	g_object_unref(layout);
-
-	cairo_surface_destroy(surface);
-	cairo_destroy(cr);
 }
@@ -25,6 +25,7 @@ private:
 
 public:
 	static void setDpi(int dpi);
+	static int getDpi();
 
 	/**
 	 * Calculates the size of a Text model
@@ -46,6 +47,13 @@ public:
 	 */
 	static PangoLayout* initPango(cairo_t* cr, Text* t);
 
+	/**
+	 * Returns the shaped layout of the Text model, cached per thread: Pango font maps and
+	 * layouts must not be shared between threads. Only created again if the text, the font
+	 * or the DPI changed. Valid until the next call from the same thread.
+	 */
+	static PangoLayout* getLayout(Text* t);
+
 	/**
 	 * Sets the font name from Text model
 	 */
@@ -2,6 +2,40 @@
 
 #include <Util.h>
 
+#include <cmath>
+#include <list>
+
+/**
+ * Count of tiles kept for all painters, there is one tile per (type, config, zoom)
+ */
+#define BACKGROUND_TILE_CACHE_SIZE 32
+
+/**
+ * Tiles smaller than this (in device pixel) are not used, the rounding to whole pixels
+ * would be visible
+ */
+#define BACKGROUND_TILE_MIN_SIZE 4
+
+class BackgroundTile
+{
+public:
+	BackgroundTileFunction createTile;
+	bool repeatX;
+	bool repeatY;
+	double period;
+	int color;
+	double size;
+	double scale;
+
+	cairo_surface_t* surface;
+};
+
+/**
+ * The most recently used tile first, shared between the render threads
+ */
+static std::list<BackgroundTile> tileCache;
+static GMutex tileCacheLock;
+
 BaseBackgroundPainter::BaseBackgroundPainter()
 {
 	XOJ_INIT_TYPE(BaseBackgroundPainter);
@@ -71,6 +105,193 @@ void BaseBackgroundPainter::paint()
 	paintBackgroundColor();
 }
 
+void BaseBackgroundPainter::paintLines(bool horizontal, double first, int count, double period, double from, double to, int color, double width)
+{
+	XOJ_CHECK_TYPE(BaseBackgroundPainter);
+
+	if (count <= 0)
+	{
+		return;
+	}
+
+	width *= lineWidthFactor;
+
+	// The tile is centered on the line
+	double start = first - period / 2;
+	double end = start + count * period;
+	bool painted = horizontal
+		? fillWithTile(createLineTile, false, true, period, color, width, from, start, to, end)
+		: fillWithTile(createLineTile, true, false, period, color, width, start, from, end, to);
+	if (painted)
+	{
+		return;
+	}
+
+	Util::cairo_set_source_rgbi(cr, color);
+	cairo_set_line_width(cr, width);
+
+	for (int i = 0; i < count; i++)
+	{
+		double pos = first + i * period;
+		if (horizontal)
+		{
+			cairo_move_to(cr, from, pos);
+			cairo_line_to(cr, to, pos);
+		}
+		else
+		{
+			cairo_move_to(cr, pos, from);
+			cairo_line_to(cr, pos, to);
+		}
+	}
+
+	cairo_stroke(cr);
+}
+
+void BaseBackgroundPainter::paintDots(double first, int countX, int countY, double period, int color, double size)
+{
+	XOJ_CHECK_TYPE(BaseBackgroundPainter);
+
+	if (countX <= 0 || countY <= 0)
+	{
+		return;
+	}
+
+	size *= lineWidthFactor;
+
+	double start = first - period / 2;
+	if (fillWithTile(createDotTile, true, true, period, color, size,
+	                 start, start, start + countX * period, start + countY * period))
+	{
+		return;
+	}
+
+	Util::cairo_set_source_rgbi(cr, color);
+	cairo_set_line_width(cr, size);
+	cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+
+	for (int i = 0; i < countX; i++)
+	{
+		double x = first + i * period;
+		for (int j = 0; j < countY; j++)
+		{
+			double y = first + j * period;
+			cairo_move_to(cr, x, y);
+			cairo_line_to(cr, x, y);
+		}
+	}
+
+	cairo_stroke(cr);
+}
+
+/**
+ * A vertical line in the center of the tile, rotated for horizontal lines
+ */
+cairo_surface_t* BaseBackgroundPainter::createLineTile(int w, int h, double scale, int color, double size)
+{
+	cairo_surface_t* tile = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+	cairo_t* cr = cairo_create(tile);
+	Util::cairo_set_source_rgbi(cr, color);
+
+	double lineWidth = size * scale;
+	if (w > h)
+	{
+		cairo_rectangle(cr, (w - lineWidth) / 2, 0, lineWidth, h);
+	}
+	else
+	{
+		cairo_rectangle(cr, 0, (h - lineWidth) / 2, w, lineWidth);
+	}
+	cairo_fill(cr);
+
+	cairo_destroy(cr);
+	return tile;
+}
+
+cairo_surface_t* BaseBackgroundPainter::createDotTile(int w, int h, double scale, int color, double size)
+{
+	cairo_surface_t* tile = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+	cairo_t* cr = cairo_create(tile);
+	Util::cairo_set_source_rgbi(cr, color);
+
+	cairo_arc(cr, w / 2.0, h / 2.0, size * scale / 2, 0, 2 * M_PI);
+	cairo_fill(cr);
+
+	cairo_destroy(cr);
+	return tile;
+}
+
+bool BaseBackgroundPainter::fillWithTile(BackgroundTileFunction createTile, bool repeatX, bool repeatY, double period,
+                                         int color, double size, double x1, double y1, double x2, double y2)
+{
+	XOJ_CHECK_TYPE(BaseBackgroundPainter);
+
+	if (Util::cairo_is_vector_target(cr))
+	{
+		return false;
+	}
+
+	// Zoom buckets of 1%, the tile is cheap to create but should not be created for every render
+	double scale = std::round(Util::cairo_get_device_scale(cr) * 100) / 100;
+
+	// One period in the repeated direction, one pixel in the other direction
+	int periodPixel = (int) std::round(period * scale);
+	if (periodPixel < BACKGROUND_TILE_MIN_SIZE)
+	{
+		return false;
+	}
+
+	int w = repeatX ? periodPixel : 1;
+	int h = repeatY ? periodPixel : 1;
+
+	cairo_surface_t* tile = NULL;
+
+	g_mutex_lock(&tileCacheLock);
+	for (auto it = tileCache.begin(); it != tileCache.end(); it++)
+	{
+		if (it->createTile == createTile && it->repeatX == repeatX && it->repeatY == repeatY && it->period == period
+			&& it->color == color && it->size == size && it->scale == scale)
+		{
+			tile = cairo_surface_reference(it->surface);
+			tileCache.splice(tileCache.begin(), tileCache, it);
+			break;
+		}
+	}
+	g_mutex_unlock(&tileCacheLock);
+
+	if (tile == NULL)
+	{
+		tile = createTile(w, h, scale, color, size);
+
+		g_mutex_lock(&tileCacheLock);
+		tileCache.push_front({ createTile, repeatX, repeatY, period, color, size, scale, cairo_surface_reference(tile) });
+		while (tileCache.size() > BACKGROUND_TILE_CACHE_SIZE)
+		{
+			cairo_surface_destroy(tileCache.back().surface);
+			tileCache.pop_back();
+		}
+		g_mutex_unlock(&tileCacheLock);
+	}
+
+	cairo_pattern_t* pattern = cairo_pattern_create_for_surface(tile);
+	cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+
+	// Pattern space is tile pixel, one period starts at x1 / y1
+	cairo_matrix_t matrix;
+	cairo_matrix_init_scale(&matrix, repeatX ? w / period : scale, repeatY ? h / period : scale);
+	cairo_matrix_translate(&matrix, -x1, -y1);
+	cairo_pattern_set_matrix(pattern, &matrix);
+
+	cairo_set_source(cr, pattern);
+	cairo_rectangle(cr, x1, y1, x2 - x1, y2 - y1);
+	cairo_fill(cr);
+
+	cairo_pattern_destroy(pattern);
+	cairo_surface_destroy(tile);
+
+	return true;
+}
+
 void BaseBackgroundPainter::paintBackgroundColor()
 {
 	XOJ_CHECK_TYPE(BaseBackgroundPainter);
@@ -19,6 +19,8 @@
 
 #include <gtk/gtk.h>
 
+typedef cairo_surface_t* (*BackgroundTileFunction)(int w, int h, double scale, int color, double size);
+
 class BaseBackgroundPainter
 {
 public:
@@ -42,6 +44,31 @@ public:
 protected:
 	void paintBackgroundColor();
 
+	/**
+	 * Paints count parallel lines, every period from first. Horizontal lines span from..to in x,
+	 * vertical lines in y. Raster targets repeat a cached tile of one period, vector targets
+	 * (PDF export, printing) get every line as path.
+	 */
+	void paintLines(bool horizontal, double first, int count, double period, double from, double to, int color, double width);
+
+	/**
+	 * Paints a grid of countX * countY dots of the diameter size, every period from first
+	 */
+	void paintDots(double first, int countX, int countY, double period, int color, double size);
+
+private:
+	/**
+	 * Fills the rectangle with a repeated tile of one period in the repeated directions
+	 *
+	 * @return false if the target is a vector surface, or the tile would be too small
+	 *         to repeat it exactly
+	 */
+	bool fillWithTile(BackgroundTileFunction createTile, bool repeatX, bool repeatY, double period,
+	                  int color, double size, double x1, double y1, double x2, double y2);
+
+	static cairo_surface_t* createLineTile(int w, int h, double scale, int color, double size);
+	static cairo_surface_t* createDotTile(int w, int h, double scale, int color, double size);
+
 private:
 	XOJ_TYPE_ATTRIB;
 
@@ -36,19 +36,17 @@ void DottedBackgroundPainter::paintBackgroundDotted()
 {
 	XOJ_CHECK_TYPE(DottedBackgroundPainter);
 
-	Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
-
-	cairo_set_line_width(cr, lineWidth * lineWidthFactor);
-	cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
-
+	int countX = 0;
 	for (double x = drawRaster1; x < width; x += drawRaster1)
 	{
-		for (double y = drawRaster1; y < height; y += drawRaster1)
-		{
-			cairo_move_to(cr, x, y);
-			cairo_line_to(cr, x, y);
-		}
+		countX++;
+	}
+
+	int countY = 0;
+	for (double y = drawRaster1; y < height; y += drawRaster1)
+	{
+		countY++;
 	}
 
-	cairo_stroke(cr);
+	paintDots(drawRaster1, countX, countY, drawRaster1, this->foregroundColor1, lineWidth);
 }
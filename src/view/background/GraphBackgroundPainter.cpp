@@ -46,9 +46,6 @@ void GraphBackgroundPainter::paintBackgroundGraph()
 {
 	XOJ_CHECK_TYPE(GraphBackgroundPainter);
 
-	Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
-
-	cairo_set_line_width(cr, lineWidth * lineWidthFactor);
 	double marginTopBottom = margin1;
 	double marginLeftRight = margin1;
 	double startX = drawRaster1;
@@ -68,26 +65,37 @@ void GraphBackgroundPainter::paintBackgroundGraph()
 		//startY = marginTopBottom;
 	}
 
+	// The visible lines are always one contiguous range
+	double firstX = 0;
+	int countX = 0;
 	for (double x = startX; x < width; x += drawRaster1)
 	{
 		if (x < margin1 || x > (width - margin1))
 		{
 			continue;
 		}
-		cairo_move_to(cr, x, marginTopBottom-snappingOffset);
-		cairo_line_to(cr, x, height - marginTopBottom-snappingOffset);
+		if (countX++ == 0)
+		{
+			firstX = x;
+		}
 	}
 
+	double firstY = 0;
+	int countY = 0;
 	for (double y = startY; y < height; y += drawRaster1)
 	{
 		if (y < margin1 || y > (height - marginTopBottom))
 		{
 			continue;
 		}
-
-		cairo_move_to(cr, marginLeftRight, y);
-		cairo_line_to(cr, width - marginLeftRight, y);
+		if (countY++ == 0)
+		{
+			firstY = y;
+		}
 	}
 
-	cairo_stroke(cr);
+	paintLines(false, firstX, countX, drawRaster1, marginTopBottom - snappingOffset,
+	           height - marginTopBottom - snappingOffset, this->foregroundColor1, lineWidth);
+	paintLines(true, firstY, countY, drawRaster1, marginLeftRight, width - marginLeftRight,
+	           this->foregroundColor1, lineWidth);
 }
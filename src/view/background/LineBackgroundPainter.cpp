@@ -44,16 +44,13 @@ void LineBackgroundPainter::paintBackgroundRuled()
 {
 	XOJ_CHECK_TYPE(LineBackgroundPainter);
 
-	Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
-	cairo_set_line_width(cr, lineWidth * lineWidthFactor);
-
+	int count = 0;
 	for (double y = 80; y < height; y += roulingSize)
 	{
-		cairo_move_to(cr, 0, y);
-		cairo_line_to(cr, width, y);
+		count++;
 	}
 
-	cairo_stroke(cr);
+	paintLines(true, 80, count, roulingSize, 0, width, this->foregroundColor1, lineWidth);
 }
 
 void LineBackgroundPainter::paintBackgroundLined()
@@ -0,0 +1,111 @@
+#include "ThumbnailBatch.h"
+#include "ThumbnailGenerator.h"
+
+#include <glib/gstdio.h>
+
+#include <iostream>
+using std::cerr;
+using std::cout;
+using std::endl;
+
+ThumbnailBatch::ThumbnailBatch(string cacheDir, int threads, bool renderMissingPreview)
+ : cacheDir(cacheDir),
+   renderMissingPreview(renderMissingPreview)
+{
+	g_mutex_init(&this->outputMutex);
+	g_mkdir_with_parents(cacheDir.c_str(), 0700);
+
+	if (threads <= 0)
+	{
+		threads = g_get_num_processors();
+	}
+
+	this->pool = g_thread_pool_new((GFunc) &processFile, this, threads, false, NULL);
+}
+
+ThumbnailBatch::~ThumbnailBatch()
+{
+	finish();
+	g_mutex_clear(&this->outputMutex);
+}
+
+/**
+ * Queue a file, the thumbnail path is printed as "INPUT<TAB>THUMBNAIL" on stdout when done
+ */
+void ThumbnailBatch::add(string input)
+{
+	g_thread_pool_push(this->pool, g_strdup(input.c_str()), NULL);
+}
+
+/**
+ * Wait until all queued files are processed
+ */
+int ThumbnailBatch::finish()
+{
+	if (this->pool)
+	{
+		g_thread_pool_free(this->pool, false, true);
+		this->pool = NULL;
+	}
+
+	return this->failed;
+}
+
+/**
+ * The cache key contains the path, mtime and size, so a changed file gets a new
+ * thumbnail and an existing thumbnail is always up to date
+ */
+string ThumbnailBatch::getCacheFilename(const gchar* input)
+{
+	GStatBuf st;
+	if (g_stat(input, &st) != 0)
+	{
+		return "";
+	}
+
+	gchar* key = g_strdup_printf("%s\n%" G_GINT64_FORMAT "\n%" G_GINT64_FORMAT, input, (gint64) st.st_mtime, (gint64) st.st_size);
+	gchar* hash = g_compute_checksum_for_string(G_CHECKSUM_MD5, key, -1);
+
+	gchar* filename = g_strconcat(hash, ".png", NULL);
+	gchar* path = g_build_filename(this->cacheDir.c_str(), filename, NULL);
+	string result = path;
+
+	g_free(path);
+	g_free(filename);
+	g_free(hash);
+	g_free(key);
+
+	return result;
+}
+
+void ThumbnailBatch::processFile(gchar* input, ThumbnailBatch* batch)
+{
+	string output = batch->getCacheFilename(input);
+
+	bool success = false;
+	if (!output.empty())
+	{
+		success = g_file_test(output.c_str(), G_FILE_TEST_EXISTS);
+
+		if (!success)
+		{
+			ThumbnailGenerator generator;
+			generator.setRenderMissingPreview(batch->renderMissingPreview);
+			success = generator.generate(input, output) == THUMBNAIL_RESULT_OK;
+		}
+	}
+
+	g_mutex_lock(&batch->outputMutex);
+	if (success)
+	{
+		cout << input << "\t" << output << endl;
+	}
+	else
+	{
+		cerr << "xoj-preview-extractor: no thumbnail for \"" << input << "\"" << endl;
+		batch->failed++;
+	}
+	g_mutex_unlock(&batch->outputMutex);
+
+	g_free(input);
+}
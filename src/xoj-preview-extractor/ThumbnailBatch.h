@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * Creates the thumbnails of many files in one process, using a worker pool
+ * and a thumbnail cache keyed by path, modification time and size
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+#include <string>
+using std::string;
+
+class ThumbnailBatch
+{
+public:
+	/**
+	 * @param cacheDir Directory the thumbnails are written to, also used as cache
+	 * @param threads Count of worker threads, <= 0 for one per processor
+	 * @param renderMissingPreview Render the first page with xournalpp if a file contains no preview
+	 */
+	ThumbnailBatch(string cacheDir, int threads, bool renderMissingPreview);
+	~ThumbnailBatch();
+
+public:
+	/**
+	 * Queue a file, the thumbnail path is printed as "INPUT<TAB>THUMBNAIL" on stdout when done
+	 */
+	void add(string input);
+
+	/**
+	 * Wait until all queued files are processed
+	 *
+	 * @return The count of files for which no thumbnail could be created
+	 */
+	int finish();
+
+private:
+	static void processFile(gchar* input, ThumbnailBatch* batch);
+
+	/**
+	 * @return The thumbnail filename for input, empty if the file could not be stat'ed
+	 */
+	string getCacheFilename(const gchar* input);
+
+private:
+	string cacheDir;
+
+	bool renderMissingPreview;
+
+	GThreadPool* pool = NULL;
+
+	/**
+	 * Guards stdout / stderr and the failed counter
+	 */
+	GMutex outputMutex;
+
+	int failed = 0;
+};
@@ -0,0 +1,137 @@
+#include "ThumbnailGenerator.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <stdio.h>
+
+#include <string>
+
+/**
+ * Maximum width and height of a rendered first page, the freedesktop "large" thumbnail size
+ */
+#define THUMBNAIL_RENDER_SIZE 256
+
+ThumbnailGenerator::ThumbnailGenerator()
+{
+}
+
+ThumbnailGenerator::~ThumbnailGenerator()
+{
+}
+
+/**
+ * @return The result of the preview extraction of the last generate() call
+ */
+PreviewExtractResult ThumbnailGenerator::getExtractResult()
+{
+	return this->extractResult;
+}
+
+/**
+ * Render the first page with xournalpp if a file contains no preview, enabled by default
+ */
+void ThumbnailGenerator::setRenderMissingPreview(bool render)
+{
+	this->renderMissingPreview = render;
+}
+
+/**
+ * Extract the preview of input and write it to output. If the file contains no
+ * preview the first page is rendered by a headless xournalpp instance, if enabled.
+ */
+ThumbnailResult ThumbnailGenerator::generate(Path input, string output)
+{
+	XojPreviewExtractor extractor;
+	this->extractResult = extractor.readFile(input);
+
+	if (this->extractResult == PREVIEW_RESULT_NO_PREVIEW && this->renderMissingPreview)
+	{
+		if (renderFirstPage(input, output))
+		{
+			this->extractResult = PREVIEW_RESULT_IMAGE_READ;
+			return THUMBNAIL_RESULT_OK;
+		}
+		return THUMBNAIL_RESULT_EXTRACT_FAILED;
+	}
+
+	if (this->extractResult != PREVIEW_RESULT_IMAGE_READ)
+	{
+		return THUMBNAIL_RESULT_EXTRACT_FAILED;
+	}
+
+	gsize dataLen = 0;
+	unsigned char* imageData = extractor.getData(dataLen);
+
+	if (!writeFile(output, imageData, dataLen))
+	{
+		return THUMBNAIL_RESULT_WRITE_FAILED;
+	}
+
+	return THUMBNAIL_RESULT_OK;
+}
+
+/**
+ * Write the buffer to a temporary file and rename it to output
+ */
+bool ThumbnailGenerator::writeFile(string output, unsigned char* data, gsize dataLen)
+{
+	string tmpFile = output + ".tmp";
+
+	FILE* fp = g_fopen(tmpFile.c_str(), "wb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	bool success = fwrite(data, dataLen, 1, fp) == 1;
+	success = (fclose(fp) == 0) && success;
+
+	if (!success || g_rename(tmpFile.c_str(), output.c_str()) != 0)
+	{
+		g_unlink(tmpFile.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Render the first page with "xournalpp --create-img --export-thumbnail-size", used if the
+ * file has no preview. This runs without display, and renders the page in thumbnail size.
+ */
+bool ThumbnailGenerator::renderFirstPage(Path input, string output)
+{
+	gchar* xournalpp = g_find_program_in_path("xournalpp");
+	if (xournalpp == NULL)
+	{
+		return false;
+	}
+
+	// The image export decides the format by the extension
+	string tmpFile = output + ".tmp.png";
+
+	string size = std::to_string(THUMBNAIL_RENDER_SIZE);
+	const gchar* argv[] = { xournalpp, "--create-img", tmpFile.c_str(), "--export-thumbnail-size", size.c_str(),
+	                        input.c_str(), NULL };
+
+	gint exitStatus = 0;
+	gboolean spawned = g_spawn_sync(NULL, (gchar**) argv, NULL,
+	                                (GSpawnFlags) (G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL),
+	                                NULL, NULL, NULL, NULL, &exitStatus, NULL);
+	g_free(xournalpp);
+
+	if (!spawned || !g_spawn_check_exit_status(exitStatus, NULL) || !g_file_test(tmpFile.c_str(), G_FILE_TEST_EXISTS))
+	{
+		g_unlink(tmpFile.c_str());
+		return false;
+	}
+
+	if (g_rename(tmpFile.c_str(), output.c_str()) != 0)
+	{
+		g_unlink(tmpFile.c_str());
+		return false;
+	}
+
+	return true;
+}
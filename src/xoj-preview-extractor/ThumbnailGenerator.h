@@ -0,0 +1,78 @@
+/*
+ * Xournal++
+ *
+ * Writes the thumbnail of a single .xoj / .xopp file
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <XojPreviewExtractor.h>
+
+#include <string>
+using std::string;
+
+enum ThumbnailResult
+{
+	/**
+	 * The thumbnail was written
+	 */
+	THUMBNAIL_RESULT_OK = 0,
+
+	/**
+	 * The input file could not be read, see the PreviewExtractResult
+	 */
+	THUMBNAIL_RESULT_EXTRACT_FAILED,
+
+	/**
+	 * The output file could not be written
+	 */
+	THUMBNAIL_RESULT_WRITE_FAILED
+};
+
+class ThumbnailGenerator
+{
+public:
+	ThumbnailGenerator();
+	~ThumbnailGenerator();
+
+public:
+	/**
+	 * Extract the preview of input and write it to output. If the file contains no
+	 * preview the first page is rendered by a headless xournalpp instance, if enabled.
+	 *
+	 * The output file is written atomically, so it never contains a partial image.
+	 */
+	ThumbnailResult generate(Path input, string output);
+
+	/**
+	 * @return The result of the preview extraction of the last generate() call
+	 */
+	PreviewExtractResult getExtractResult();
+
+	/**
+	 * Render the first page with xournalpp if a file contains no preview, enabled by default
+	 */
+	void setRenderMissingPreview(bool render);
+
+private:
+	/**
+	 * Render the first page with "xournalpp --create-img OUT --export-thumbnail-size N",
+	 * used if the file has no preview
+	 */
+	bool renderFirstPage(Path input, string output);
+
+	/**
+	 * Write the buffer to a temporary file and rename it to output
+	 */
+	bool writeFile(string output, unsigned char* data, gsize dataLen);
+
+private:
+	PreviewExtractResult extractResult = PREVIEW_RESULT_ERROR_READING_PREVIEW;
+
+	bool renderMissingPreview = true;
+};
@@ -18,6 +18,11 @@
 #include <i18n.h>
 #include <XojPreviewExtractor.h>
 
+#include "ThumbnailBatch.h"
+#include "ThumbnailGenerator.h"
+
+#include <string.h>
+
 #include <iostream>
 #include <fstream>
 using std::cerr;
@@ -65,26 +70,84 @@ void logMessage(string msg, bool error)
 #endif
 }
 
+/**
+ * Batch mode: xournal-thumbnailer [--no-render] --batch CACHE_DIR [INPUT...]
+ * If no input files are given, they are read line by line from stdin
+ */
+int runBatch(int argc, char* argv[], bool renderMissingPreview)
+{
+	ThumbnailBatch batch(argv[2], 0, renderMissingPreview);
+
+	if (argc > 3)
+	{
+		for (int i = 3; i < argc; i++)
+		{
+			batch.add(argv[i]);
+		}
+	}
+	else
+	{
+		string line;
+		while (std::getline(std::cin, line))
+		{
+			if (!line.empty())
+			{
+				batch.add(line);
+			}
+		}
+	}
+
+	int failed = batch.finish();
+	if (failed > 0)
+	{
+		logMessage((_F("xoj-preview-extractor: no thumbnail for {1} file(s)") % failed).str(), true);
+		return 7;
+	}
+
+	logMessage(_("xoj-preview-extractor: successfully extracted"), false);
+	return 0;
+}
+
 int main(int argc, char* argv[])
 {
 	initLocalisation();
 
+	// Files without preview are rendered by spawning "xournalpp --create-img", unless disabled
+	bool renderMissingPreview = true;
+	if (argc >= 2 && strcmp(argv[1], "--no-render") == 0)
+	{
+		renderMissingPreview = false;
+		argc--;
+		argv++;
+	}
+
+	if (argc >= 3 && strcmp(argv[1], "--batch") == 0)
+	{
+		return runBatch(argc, argv, renderMissingPreview);
+	}
+
 	// check args count
 	if (argc != 3)
 	{
-		logMessage(_("xoj-preview-extractor: call with INPUT.xoj OUTPUT.png"), true);
+		logMessage(_("xoj-preview-extractor: call with [--no-render] INPUT.xoj OUTPUT.png or [--no-render] --batch CACHE_DIR [INPUT...]"), true);
 		return 1;
 	}
-	
-	XojPreviewExtractor extractor;
-	PreviewExtractResult result = extractor.readFile(argv[1]);
 
-	switch (result)
+	ThumbnailGenerator generator;
+	generator.setRenderMissingPreview(renderMissingPreview);
+	ThumbnailResult thumbnailResult = generator.generate(argv[1], argv[2]);
+
+	if (thumbnailResult == THUMBNAIL_RESULT_WRITE_FAILED)
+	{
+		logMessage((_F("xoj-preview-extractor: opening output file \"{1}\" failed") % argv[2]).str(), true);
+		return 6;
+	}
+
+	switch (generator.getExtractResult())
 	{
 	case PREVIEW_RESULT_IMAGE_READ:
-		// continue to write preview
 		break;
-		
+
 	case PREVIEW_RESULT_BAD_FILE_EXTENSION:
 		logMessage((_F("xoj-preview-extractor: file \"{1}\" is not .xoj file") % argv[1]).str(), true);
 		return 2;
@@ -102,18 +165,6 @@ int main(int argc, char* argv[])
 		logMessage(_("xoj-preview-extractor: no preview and page found, maybe an invalid file?"), true);
 		return 5;
 	}
-	
-	FILE* fp = fopen(argv[2], "wb");
-	if (!fp)
-	{
-		logMessage((_F("xoj-preview-extractor: opening output file \"{1}\" failed") % argv[2]).str(), true);
-		return 6;
-	}
-
-	gsize dataLen = 0;
-	unsigned char* imageData = extractor.getData(dataLen);
-	fwrite(imageData, dataLen, 1, fp);
-	fclose(fp);
 
 	logMessage(_("xoj-preview-extractor: successfully extracted"), false);
 	return 0;
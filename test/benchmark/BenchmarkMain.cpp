@@ -0,0 +1,531 @@
+/*
+ * Xournal++
+ *
+ * Load / save / render / erase / export / live stroke benchmarks on generated documents
+ *
+ * Results are written as JSON, so they can be compared between releases
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "DocumentGenerator.h"
+
+#include "control/jobs/ImageExport.h"
+#include "control/jobs/ProgressListener.h"
+#include "control/ToolHandler.h"
+#include "control/tools/EraseHandler.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "gui/Redrawable.h"
+#include "model/Layer.h"
+#include "pdf/base/XojPdfExportFactory.h"
+#include "undo/UndoRedoHandler.h"
+#include "view/DocumentView.h"
+#include "view/LiveStrokeView.h"
+
+#include <config.h>
+#include <Path.h>
+#include <StringUtils.h>
+
+#include <glib/gstdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::vector;
+
+/**
+ * The benchmarks run without a widget, all repaint requests are ignored
+ */
+class BenchmarkRedrawable : public Redrawable
+{
+public:
+	virtual void repaintArea(double x1, double y1, double x2, double y2) { }
+	virtual void repaintPage() { }
+	virtual void rerenderPage() { }
+	virtual void rerenderRect(double x, double y, double width, double height) { }
+	virtual GtkColorWrapper getSelectionColor() { return GtkColorWrapper(0); }
+	virtual void deleteViewBuffer() { }
+	virtual int getX() const { return 0; }
+	virtual int getY() const { return 0; }
+};
+
+/**
+ * Collects the samples of one measurement, in seconds
+ */
+class BenchmarkResult
+{
+public:
+	BenchmarkResult(string name, string unit, double units)
+	 : name(name),
+	   unit(unit),
+	   units(units)
+	{
+	}
+
+	void addSample(double seconds)
+	{
+		samples.push_back(seconds);
+	}
+
+	void writeJson(std::ostream& out)
+	{
+		vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0;
+		for (double s : sorted)
+		{
+			total += s;
+		}
+		double mean = sorted.empty() ? 0 : total / sorted.size();
+		double median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+
+		out << "    {\"name\": \"" << StringUtils::escapeJson(name) << "\", \"iterations\": " << sorted.size()
+		    << ", \"min_s\": " << (sorted.empty() ? 0 : sorted.front())
+		    << ", \"median_s\": " << median
+		    << ", \"mean_s\": " << mean
+		    << ", \"max_s\": " << (sorted.empty() ? 0 : sorted.back())
+		    << ", \"throughput\": " << (median > 0 ? units / median : 0)
+		    << ", \"throughput_unit\": \"" << StringUtils::escapeJson(unit) << "/s\"}";
+	}
+
+	void print()
+	{
+		vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+		double median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+
+		cerr << name << ": " << median * 1000 << " ms (median of " << sorted.size() << ")" << endl;
+	}
+
+private:
+	string name;
+	string unit;
+	double units;
+	vector<double> samples;
+};
+
+class Stopwatch
+{
+public:
+	Stopwatch()
+	 : start(g_get_monotonic_time())
+	{
+	}
+
+	double elapsed()
+	{
+		return (g_get_monotonic_time() - start) / (double) G_USEC_PER_SEC;
+	}
+
+private:
+	gint64 start;
+};
+
+static double countPoints(Document* doc)
+{
+	double points = 0;
+	for (size_t p = 0; p < doc->getPageCount(); p++)
+	{
+		for (Layer* l : *doc->getPage(p)->getLayers())
+		{
+			for (Element* e : *l->getElements())
+			{
+				if (e->getType() == ELEMENT_STROKE)
+				{
+					points += ((Stroke*) e)->getPointCount();
+				}
+			}
+		}
+	}
+	return points;
+}
+
+static void benchmarkSave(Document* doc, string file, int iterations, vector<BenchmarkResult>& results)
+{
+	BenchmarkResult result("SaveHandler::saveTo", "pages", doc->getPageCount());
+	for (int i = 0; i < iterations; i++)
+	{
+		Stopwatch watch;
+		SaveHandler handler;
+		handler.prepareSave(doc);
+		handler.saveTo(file);
+		result.addSample(watch.elapsed());
+	}
+	results.push_back(result);
+}
+
+static void benchmarkLoad(string file, double pages, int iterations, vector<BenchmarkResult>& results)
+{
+	BenchmarkResult result("LoadHandler::loadDocument", "pages", pages);
+	for (int i = 0; i < iterations; i++)
+	{
+		Stopwatch watch;
+		LoadHandler handler;
+		if (handler.loadDocument(file) == NULL)
+		{
+			cerr << "Loading failed: " << handler.getLastError() << endl;
+			return;
+		}
+		result.addSample(watch.elapsed());
+	}
+	results.push_back(result);
+}
+
+static void benchmarkRender(Document* doc, double zoom, int iterations, vector<BenchmarkResult>& results)
+{
+	BenchmarkResult result("DocumentView::drawPage@" + std::to_string(zoom).substr(0, 4), "pages", doc->getPageCount());
+	DocumentView view;
+	for (int i = 0; i < iterations; i++)
+	{
+		Stopwatch watch;
+		for (size_t p = 0; p < doc->getPageCount(); p++)
+		{
+			PageRef page = doc->getPage(p);
+			cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+			                                                      (int) (page->getWidth() * zoom),
+			                                                      (int) (page->getHeight() * zoom));
+			cairo_t* cr = cairo_create(surface);
+			cairo_scale(cr, zoom, zoom);
+			view.drawPage(page, cr, true);
+			cairo_destroy(cr);
+			cairo_surface_destroy(surface);
+		}
+		result.addSample(watch.elapsed());
+	}
+	results.push_back(result);
+}
+
+/**
+ * Sweep the eraser over every page in horizontal lines, this modifies the document
+ */
+static void benchmarkErase(Document* doc, vector<BenchmarkResult>& results)
+{
+	UndoRedoHandler undo(NULL);
+	ToolHandler toolHandler(NULL, NULL, NULL);
+	toolHandler.selectTool(TOOL_ERASER, false);
+	BenchmarkRedrawable view;
+
+	int events = 0;
+	Stopwatch watch;
+	for (size_t p = 0; p < doc->getPageCount(); p++)
+	{
+		PageRef page = doc->getPage(p);
+		EraseHandler eraser(&undo, doc, page, &toolHandler, &view);
+
+		for (double y = 20; y < page->getHeight(); y += 40)
+		{
+			for (double x = 0; x < page->getWidth(); x += 4)
+			{
+				eraser.erase(x, y);
+				events++;
+			}
+
+			// Lift the eraser, it would sweep back over the page otherwise
+			eraser.finalize();
+		}
+	}
+	double elapsed = watch.elapsed();
+
+	BenchmarkResult result("EraseHandler::erase", "events", events);
+	result.addSample(elapsed);
+	results.push_back(result);
+}
+
+/**
+ * Read the strokes of an input recording of InputRecorder, one stroke from each press to release
+ */
+static vector<Stroke*> readRecordedStrokes(string file)
+{
+	vector<Stroke*> strokes;
+	std::ifstream in(file);
+	string line;
+	Stroke* stroke = NULL;
+
+	while (std::getline(in, line))
+	{
+		std::istringstream ls(line);
+		ls.imbue(std::locale::classic());
+
+		string type;
+		int page = 0;
+		double x = 0;
+		double y = 0;
+		double pressure = Point::NO_PRESSURE;
+		ls >> type >> page >> x >> y >> pressure;
+		if (ls.fail() || (type != "press" && type != "motion" && type != "release"))
+		{
+			continue;
+		}
+
+		if (type == "press")
+		{
+			delete stroke;
+			stroke = new Stroke();
+			stroke->setToolType(STROKE_TOOL_PEN);
+			stroke->setWidth(1.41);
+		}
+		if (stroke == NULL)
+		{
+			continue;
+		}
+
+		stroke->addPoint(Point(x, y, pressure > 0 ? pressure * stroke->getWidth() : Point::NO_PRESSURE));
+
+		if (type == "release")
+		{
+			strokes.push_back(stroke);
+			stroke = NULL;
+		}
+	}
+	delete stroke;
+
+	return strokes;
+}
+
+/**
+ * Draw a long stroke point by point, as StrokeHandler does while drawing.
+ * The first and the last points are measured separately, they should cost the same.
+ */
+static void benchmarkLiveStroke(Stroke* source, string name, int fill, bool dashed, vector<BenchmarkResult>& results)
+{
+	const double zoom = 2;
+	const double dashes[] = { 3, 3 };
+	int count = source->getPointCount();
+	int window = std::min(1000, count / 2);
+	if (window < 1)
+	{
+		return;
+	}
+
+	Stroke stroke;
+	stroke.setToolType(source->getToolType());
+	stroke.setWidth(source->getWidth());
+	stroke.setColor(source->getColor());
+	stroke.setFill(fill);
+	if (dashed)
+	{
+		LineStyle style;
+		style.setDashes(dashes, 2);
+		stroke.setLineStyle(style);
+	}
+	stroke.addPoint(source->getPoint(0));
+
+	LiveStrokeView view;
+	view.start(&stroke, (int) ((source->getX() + source->getElementWidth() + 20) * zoom),
+	           (int) ((source->getY() + source->getElementHeight() + 20) * zoom), zoom);
+
+	double first = 0;
+	double last = 0;
+	for (int i = 1; i < count; i++)
+	{
+		stroke.addPoint(source->getPoint(i));
+
+		Range damage(0, 0);
+		Stopwatch watch;
+		view.drawNewSegments(damage);
+		double elapsed = watch.elapsed();
+
+		if (i <= window)
+		{
+			first += elapsed;
+		}
+		else if (i >= count - window)
+		{
+			last += elapsed;
+		}
+	}
+
+	BenchmarkResult firstResult("LiveStrokeView::drawNewSegments[" + name + "] first points", "points", window);
+	firstResult.addSample(first);
+	results.push_back(firstResult);
+
+	BenchmarkResult lastResult("LiveStrokeView::drawNewSegments[" + name + "] last points", "points", window);
+	lastResult.addSample(last);
+	results.push_back(lastResult);
+}
+
+static void benchmarkLiveStrokes(vector<Stroke*>& strokes, vector<BenchmarkResult>& results)
+{
+	for (size_t i = 0; i < strokes.size(); i++)
+	{
+		string name = std::to_string(i) + ":" + std::to_string(strokes[i]->getPointCount());
+		benchmarkLiveStroke(strokes[i], name + " solid", -1, false, results);
+		benchmarkLiveStroke(strokes[i], name + " dashed", -1, true, results);
+		benchmarkLiveStroke(strokes[i], name + " filled", 128, false, results);
+	}
+}
+
+static void benchmarkExport(Document* doc, string pdfFile, string pngFile, int iterations, vector<BenchmarkResult>& results)
+{
+	BenchmarkResult pdfResult("XojPdfExport::createPdf", "pages", doc->getPageCount());
+	for (int i = 0; i < iterations; i++)
+	{
+		Stopwatch watch;
+		XojPdfExport* pdfe = XojPdfExportFactory::createExport(doc, NULL);
+		pdfe->createPdf(pdfFile);
+		delete pdfe;
+		pdfResult.addSample(watch.elapsed());
+	}
+	results.push_back(pdfResult);
+
+	BenchmarkResult pngResult("ImageExport::exportGraphics", "pages", doc->getPageCount());
+	for (int i = 0; i < iterations; i++)
+	{
+		PageRangeVector exportRange;
+		exportRange.push_back(new PageRangeEntry(0, doc->getPageCount() - 1));
+		DummyProgressListener progress;
+
+		Stopwatch watch;
+		ImageExport imgExport(doc, pngFile, EXPORT_GRAPHICS_PNG, false, exportRange);
+		imgExport.exportGraphics(&progress);
+		pngResult.addSample(watch.elapsed());
+
+		for (PageRangeEntry* e : exportRange)
+		{
+			delete e;
+		}
+	}
+	results.push_back(pngResult);
+
+	for (size_t p = 1; p <= doc->getPageCount(); p++)
+	{
+		string file = pngFile.substr(0, pngFile.size() - 4) + "-" + std::to_string(p) + ".png";
+		g_unlink(file.c_str());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	DocumentGeneratorSettings settings;
+	int iterations = 3;
+	int liveStrokePoints = 20000;
+	gchar* strokeRecording = NULL;
+	gchar* output = NULL;
+
+	GOptionEntry options[] = {
+		{ "pages",      0, 0, G_OPTION_ARG_INT,      &settings.pages,           "Generated page count", "N" },
+		{ "strokes",    0, 0, G_OPTION_ARG_INT,      &settings.strokesPerPage,  "Strokes per page", "N" },
+		{ "points",     0, 0, G_OPTION_ARG_INT,      &settings.pointsPerStroke, "Points per stroke", "N" },
+		{ "pressure",   0, 0, G_OPTION_ARG_DOUBLE,   &settings.pressureRatio,   "Ratio of strokes with pressure (0..1)", "R" },
+		{ "images",     0, 0, G_OPTION_ARG_INT,      &settings.imagesPerPage,   "Images per page", "N" },
+		{ "texts",      0, 0, G_OPTION_ARG_INT,      &settings.textsPerPage,    "Text elements per page", "N" },
+		{ "seed",       0, 0, G_OPTION_ARG_INT,      (gint*) &settings.seed,          "Random seed", "N" },
+		{ "iterations", 0, 0, G_OPTION_ARG_INT,      &iterations,               "Iterations per benchmark", "N" },
+		{ "live-points", 0, 0, G_OPTION_ARG_INT,     &liveStrokePoints,         "Points of the generated live stroke", "N" },
+		{ "live-recording", 0, 0, G_OPTION_ARG_FILENAME, &strokeRecording,      "Use the strokes of this input recording for the live stroke benchmark", "FILE" },
+		{ "output",   'o', 0, G_OPTION_ARG_FILENAME, &output,                   "JSON result file (default: stdout)", "FILE" },
+		{ NULL }
+	};
+
+	GError* error = NULL;
+	GOptionContext* context = g_option_context_new("- Xournal++ benchmarks");
+	g_option_context_add_main_entries(context, options, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		cerr << error->message << endl;
+		g_error_free(error);
+		g_option_context_free(context);
+		return 1;
+	}
+	g_option_context_free(context);
+
+	gchar* tmpDir = g_dir_make_tmp("xournalpp-benchmark-XXXXXX", NULL);
+	string xoppFile = string(tmpDir) + G_DIR_SEPARATOR_S "benchmark.xopp";
+	string pdfFile = string(tmpDir) + G_DIR_SEPARATOR_S "benchmark.pdf";
+	string pngFile = string(tmpDir) + G_DIR_SEPARATOR_S "benchmark.png";
+
+	DocumentHandler handler;
+	Document doc(&handler);
+
+	vector<BenchmarkResult> results;
+
+	Stopwatch generateWatch;
+	DocumentGenerator generator(settings);
+	generator.generate(&doc);
+	BenchmarkResult generateResult("DocumentGenerator::generate", "pages", settings.pages);
+	generateResult.addSample(generateWatch.elapsed());
+	results.push_back(generateResult);
+
+	gint64 points = (gint64) countPoints(&doc);
+
+	benchmarkSave(&doc, xoppFile, iterations, results);
+	benchmarkLoad(xoppFile, settings.pages, iterations, results);
+
+	for (double zoom : { 0.5, 1.0, 2.0, 4.0 })
+	{
+		benchmarkRender(&doc, zoom, iterations, results);
+	}
+
+	benchmarkExport(&doc, pdfFile, pngFile, iterations, results);
+
+	// Last, as it modifies the document
+	benchmarkErase(&doc, results);
+
+	vector<Stroke*> liveStrokes;
+	string liveRecording;
+	if (strokeRecording)
+	{
+		liveRecording = strokeRecording;
+		liveStrokes = readRecordedStrokes(liveRecording);
+		g_free(strokeRecording);
+	}
+	else
+	{
+		liveStrokes.push_back(generator.generateStroke(liveStrokePoints, 595.27559, 841.88976));
+	}
+	benchmarkLiveStrokes(liveStrokes, results);
+	for (Stroke* s : liveStrokes)
+	{
+		delete s;
+	}
+
+	g_unlink(xoppFile.c_str());
+	g_unlink(pdfFile.c_str());
+	g_rmdir(tmpDir);
+	g_free(tmpDir);
+
+	std::ostringstream json;
+	json << "{" << endl;
+	json << "  \"version\": \"" << StringUtils::escapeJson(PROJECT_VERSION) << "\"," << endl;
+	json << "  \"settings\": {\"pages\": " << settings.pages
+	     << ", \"strokes_per_page\": " << settings.strokesPerPage
+	     << ", \"points_per_stroke\": " << settings.pointsPerStroke
+	     << ", \"pressure_ratio\": " << settings.pressureRatio
+	     << ", \"images_per_page\": " << settings.imagesPerPage
+	     << ", \"texts_per_page\": " << settings.textsPerPage
+	     << ", \"seed\": " << settings.seed
+	     << ", \"points\": " << points
+	     << ", \"live_recording\": \"" << StringUtils::escapeJson(liveRecording) << "\"}," << endl;
+	json << "  \"results\": [" << endl;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		results[i].print();
+		results[i].writeJson(json);
+		json << (i + 1 < results.size() ? "," : "") << endl;
+	}
+	json << "  ]" << endl;
+	json << "}" << endl;
+
+	if (output)
+	{
+		std::ofstream out(output);
+		out << json.str();
+		g_free(output);
+	}
+	else
+	{
+		cout << json.str();
+	}
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+#include "DocumentGenerator.h"
+
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+#include <algorithm>
+#include <cmath>
+
+// A4 in points
+const double PAGE_WIDTH = 595.27559;
+const double PAGE_HEIGHT = 841.88976;
+
+DocumentGenerator::DocumentGenerator(DocumentGeneratorSettings& settings)
+ : settings(settings),
+   rng(settings.seed)
+{
+}
+
+DocumentGenerator::~DocumentGenerator()
+{
+}
+
+double DocumentGenerator::random(double min, double max)
+{
+	std::uniform_real_distribution<double> dist(min, max);
+	return dist(rng);
+}
+
+/**
+ * Fill the (empty) document with generated pages
+ */
+void DocumentGenerator::generate(Document* doc)
+{
+	for (int p = 0; p < settings.pages; p++)
+	{
+		PageRef page = new XojPage(PAGE_WIDTH, PAGE_HEIGHT);
+		page->setBackgroundType(PageType("lined"));
+
+		Layer* layer = new Layer();
+		page->addLayer(layer);
+		page->setSelectedLayerId(1);
+
+		for (int i = 0; i < settings.imagesPerPage; i++)
+		{
+			addImage(layer, PAGE_WIDTH, PAGE_HEIGHT);
+		}
+
+		for (int i = 0; i < settings.strokesPerPage; i++)
+		{
+			addStroke(layer, PAGE_WIDTH, PAGE_HEIGHT);
+		}
+
+		for (int i = 0; i < settings.textsPerPage; i++)
+		{
+			addText(layer, PAGE_WIDTH, PAGE_HEIGHT);
+		}
+
+		doc->addPage(page);
+	}
+}
+
+/**
+ * Handwriting like stroke: a random walk with smooth direction changes
+ */
+Stroke* DocumentGenerator::generateStroke(int points, double width, double height)
+{
+	Stroke* s = new Stroke();
+	s->setToolType(STROKE_TOOL_PEN);
+	s->setColor((int) random(0, 0xffffff));
+	s->setWidth(random(0.4, 3));
+
+	bool pressure = random(0, 1) < settings.pressureRatio;
+
+	double x = random(20, width - 20);
+	double y = random(20, height - 20);
+	double angle = random(0, 2 * M_PI);
+
+	for (int i = 0; i < points; i++)
+	{
+		angle += random(-0.4, 0.4);
+		x = std::min(std::max(x + std::cos(angle) * 1.5, 0.0), width);
+		y = std::min(std::max(y + std::sin(angle) * 1.5, 0.0), height);
+
+		if (pressure)
+		{
+			s->addPoint(Point(x, y, random(0.2, 1.0)));
+		}
+		else
+		{
+			s->addPoint(Point(x, y));
+		}
+	}
+
+	return s;
+}
+
+void DocumentGenerator::addStroke(Layer* layer, double width, double height)
+{
+	layer->addElement(generateStroke(settings.pointsPerStroke, width, height));
+}
+
+void DocumentGenerator::addImage(Layer* layer, double width, double height)
+{
+	int w = (int) random(64, 512);
+	int h = (int) random(64, 512);
+
+	cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+	cairo_t* cr = cairo_create(surface);
+	cairo_pattern_t* gradient = cairo_pattern_create_linear(0, 0, w, h);
+	cairo_pattern_add_color_stop_rgb(gradient, 0, random(0, 1), random(0, 1), random(0, 1));
+	cairo_pattern_add_color_stop_rgb(gradient, 1, random(0, 1), random(0, 1), random(0, 1));
+	cairo_set_source(cr, gradient);
+	cairo_paint(cr);
+	cairo_pattern_destroy(gradient);
+	cairo_destroy(cr);
+
+	Image* img = new Image();
+	img->setImage(surface);
+	img->setX(random(0, width - w / 2));
+	img->setY(random(0, height - h / 2));
+	img->setWidth(w / 2);
+	img->setHeight(h / 2);
+
+	layer->addElement(img);
+}
+
+void DocumentGenerator::addText(Layer* layer, double width, double height)
+{
+	Text* t = new Text();
+	t->setX(random(0, width - 100));
+	t->setY(random(0, height - 20));
+	t->setColor(0x000000);
+	t->setText("The quick brown fox jumps over the lazy dog");
+
+	layer->addElement(t);
+}
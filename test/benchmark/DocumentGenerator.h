@@ -0,0 +1,71 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal++ benchmarks
+ * Generates synthetic documents with a configurable content mix
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "model/Document.h"
+
+#include <random>
+
+class Layer;
+class Stroke;
+
+class DocumentGeneratorSettings
+{
+public:
+	int pages = 10;
+	int strokesPerPage = 200;
+	int pointsPerStroke = 100;
+
+	/**
+	 * Ratio of strokes with pressure information, 0..1
+	 */
+	double pressureRatio = 0.5;
+
+	int imagesPerPage = 1;
+	int textsPerPage = 5;
+
+	/**
+	 * Random seed, the same settings and seed always generate the same document
+	 */
+	unsigned int seed = 1;
+};
+
+class DocumentGenerator
+{
+public:
+	DocumentGenerator(DocumentGeneratorSettings& settings);
+	virtual ~DocumentGenerator();
+
+public:
+	/**
+	 * Fill the (empty) document with generated pages
+	 */
+	void generate(Document* doc);
+
+	/**
+	 * Handwriting like stroke within width x height
+	 */
+	Stroke* generateStroke(int points, double width, double height);
+
+private:
+	void addStroke(Layer* layer, double width, double height);
+	void addImage(Layer* layer, double width, double height);
+	void addText(Layer* layer, double width, double height);
+
+	double random(double min, double max);
+
+private:
+	DocumentGeneratorSettings settings;
+
+	std::mt19937 rng;
+};
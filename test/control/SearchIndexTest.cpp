@@ -0,0 +1,139 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "control/SearchIndex.h"
+#include <config-test.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SearchIndexTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(SearchIndexTest);
+
+	CPPUNIT_TEST(testLowerCase);
+	CPPUNIT_TEST(testWhitespace);
+	CPPUNIT_TEST(testOffsets);
+	CPPUNIT_TEST(testPdfWrappedLine);
+	CPPUNIT_TEST(testPdfNoMatch);
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp()
+	{
+	}
+
+	void tearDown()
+	{
+	}
+
+	/**
+	 * A page with one character per 10 x 10 box, each line starts at x = 0 and
+	 * is 20 below the previous, the line breaks have no size
+	 */
+	SearchIndexPdfPage* createPage(const string& text)
+	{
+		vector<XojPdfRectangle> characters;
+		double x = 0;
+		double y = 0;
+		for (const char* p = text.c_str(); *p; p = g_utf8_next_char(p))
+		{
+			if (*p == '\n')
+			{
+				characters.push_back(XojPdfRectangle(x, y, x, y));
+				x = 0;
+				y += 20;
+				continue;
+			}
+			characters.push_back(XojPdfRectangle(x, y, x + 10, y + 10));
+			x += 10;
+		}
+
+		return SearchIndex::createPdfPage(text, characters);
+	}
+
+	void testLowerCase()
+	{
+		vector<gunichar> chars = SearchIndex::toSearchChars("AbC");
+
+		CPPUNIT_ASSERT_EQUAL(3, (int) chars.size());
+		CPPUNIT_ASSERT_EQUAL((gunichar) 'a', chars[0]);
+		CPPUNIT_ASSERT_EQUAL((gunichar) 'b', chars[1]);
+		CPPUNIT_ASSERT_EQUAL((gunichar) 'c', chars[2]);
+	}
+
+	void testWhitespace()
+	{
+		CPPUNIT_ASSERT(SearchIndex::toSearchChars("hello world") == SearchIndex::toSearchChars("hello\nworld"));
+		CPPUNIT_ASSERT(SearchIndex::toSearchChars("hello world") == SearchIndex::toSearchChars("hello \n\t world"));
+		CPPUNIT_ASSERT(SearchIndex::toSearchChars("hello world") == SearchIndex::toSearchChars("Hello  World"));
+	}
+
+	void testOffsets()
+	{
+		vector<int> offsets;
+		vector<size_t> indices;
+		vector<gunichar> chars = SearchIndex::toSearchChars("a \n b", &offsets, &indices);
+
+		CPPUNIT_ASSERT_EQUAL(3, (int) chars.size());
+		CPPUNIT_ASSERT_EQUAL((gunichar) ' ', chars[1]);
+
+		// One more offset for the end of the text
+		CPPUNIT_ASSERT_EQUAL(4, (int) offsets.size());
+		CPPUNIT_ASSERT_EQUAL(0, offsets[0]);
+		CPPUNIT_ASSERT_EQUAL(1, offsets[1]);
+		CPPUNIT_ASSERT_EQUAL(4, offsets[2]);
+		CPPUNIT_ASSERT_EQUAL(5, offsets[3]);
+
+		CPPUNIT_ASSERT_EQUAL(3, (int) indices.size());
+		CPPUNIT_ASSERT_EQUAL((size_t) 0, indices[0]);
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, indices[1]);
+		CPPUNIT_ASSERT_EQUAL((size_t) 4, indices[2]);
+	}
+
+	void testPdfWrappedLine()
+	{
+		SearchIndexPdfPage* page = createPage("first hello\nworld last");
+
+		vector<XojPdfRectangle> results;
+		SearchIndex::findPdfText(page, SearchIndex::toSearchChars("Hello World"), results);
+
+		// One rectangle per line
+		CPPUNIT_ASSERT_EQUAL(2, (int) results.size());
+
+		CPPUNIT_ASSERT_EQUAL(60.0, results[0].x1);
+		CPPUNIT_ASSERT_EQUAL(0.0, results[0].y1);
+		CPPUNIT_ASSERT_EQUAL(110.0, results[0].x2);
+		CPPUNIT_ASSERT_EQUAL(10.0, results[0].y2);
+
+		CPPUNIT_ASSERT_EQUAL(0.0, results[1].x1);
+		CPPUNIT_ASSERT_EQUAL(20.0, results[1].y1);
+		CPPUNIT_ASSERT_EQUAL(50.0, results[1].x2);
+		CPPUNIT_ASSERT_EQUAL(30.0, results[1].y2);
+
+		delete page;
+	}
+
+	void testPdfNoMatch()
+	{
+		SearchIndexPdfPage* page = createPage("hello\nworld");
+
+		vector<XojPdfRectangle> results;
+		SearchIndex::findPdfText(page, SearchIndex::toSearchChars("helloworld"), results);
+
+		CPPUNIT_ASSERT_EQUAL(0, (int) results.size());
+
+		delete page;
+	}
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(SearchIndexTest);
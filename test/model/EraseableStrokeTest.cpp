@@ -0,0 +1,252 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "model/Stroke.h"
+#include "model/eraser/EraseableStroke.h"
+#include "model/eraser/EraserCapsule.h"
+#include <config-test.h>
+
+#include <Range.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class EraseableStrokeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(EraseableStrokeTest);
+
+	CPPUNIT_TEST(testCapsulePoint);
+	CPPUNIT_TEST(testCapsuleMoved);
+	CPPUNIT_TEST(testCapsuleMiss);
+	CPPUNIT_TEST(testSplitInterval);
+	CPPUNIT_TEST(testEraseWholeStroke);
+	CPPUNIT_TEST(testEraseStart);
+	CPPUNIT_TEST(testEraseEnd);
+	CPPUNIT_TEST(testRepeatedErase);
+	CPPUNIT_TEST(testJoinSegments);
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp()
+	{
+		this->stroke = new Stroke();
+		this->stroke->setWidth(2);
+	}
+
+	void tearDown()
+	{
+		delete this->stroke;
+		this->stroke = NULL;
+	}
+
+	/**
+	 * Erase with a capsule which does not move
+	 *
+	 * @return true if something was erased
+	 */
+	bool erase(EraseableStroke& e, double x, double y, double radius)
+	{
+		Range* range = e.erase(EraserCapsule(x, y, x, y, radius));
+		bool erased = range != NULL;
+		delete range;
+		return erased;
+	}
+
+	/**
+	 * The leftover strokes as list of their points
+	 */
+	vector<vector<Point>> getStrokes(EraseableStroke& e)
+	{
+		vector<vector<Point>> result;
+
+		GList* list = e.getStroke(this->stroke);
+		for (GList* l = list; l != NULL; l = l->next)
+		{
+			Stroke* s = (Stroke*) l->data;
+			vector<Point> points;
+			for (int i = 0; i < s->getPointCount(); i++)
+			{
+				points.push_back(s->getPoint(i));
+			}
+			result.push_back(points);
+			delete s;
+		}
+		g_list_free(list);
+
+		return result;
+	}
+
+	void assertPoint(double x, double y, const Point& p)
+	{
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(x, p.x, 1e-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(y, p.y, 1e-9);
+	}
+
+	void testCapsulePoint()
+	{
+		EraserCapsule capsule(50, 0, 50, 0, 10);
+
+		double t0 = 0;
+		double t1 = 0;
+		CPPUNIT_ASSERT(capsule.intersectSegment(Point(0, 0), Point(100, 0), t0, t1));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.4, t0, 1e-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.6, t1, 1e-9);
+	}
+
+	void testCapsuleMoved()
+	{
+		EraserCapsule capsule(20, 0, 80, 0, 5);
+
+		double t0 = 0;
+		double t1 = 0;
+		CPPUNIT_ASSERT(capsule.intersectSegment(Point(0, 0), Point(100, 0), t0, t1));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.15, t0, 1e-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.85, t1, 1e-9);
+
+		// Crossing the swept area between the end circles
+		CPPUNIT_ASSERT(capsule.intersectSegment(Point(50, -100), Point(50, 100), t0, t1));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.475, t0, 1e-9);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.525, t1, 1e-9);
+	}
+
+	void testCapsuleMiss()
+	{
+		EraserCapsule capsule(20, 0, 80, 0, 5);
+
+		CPPUNIT_ASSERT(!capsule.intersectsSegment(Point(0, 10), Point(100, 10)));
+		CPPUNIT_ASSERT(!capsule.intersectsSegment(Point(90, -50), Point(90, 50)));
+		CPPUNIT_ASSERT(capsule.intersectsSegment(Point(84, -50), Point(84, 50)));
+	}
+
+	void testSplitInterval()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(100, 0));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 50, 0, 10));
+
+		vector<vector<Point>> strokes = getStrokes(e);
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes.size());
+
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes[0].size());
+		assertPoint(0, 0, strokes[0][0]);
+		assertPoint(40, 0, strokes[0][1]);
+
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes[1].size());
+		assertPoint(60, 0, strokes[1][0]);
+		assertPoint(100, 0, strokes[1][1]);
+	}
+
+	void testEraseWholeStroke()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(10, 0));
+		this->stroke->addPoint(Point(20, 5));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 10, 0, 30));
+
+		CPPUNIT_ASSERT_EQUAL(0, (int) getStrokes(e).size());
+
+		// Nothing left to erase
+		CPPUNIT_ASSERT(!erase(e, 10, 0, 30));
+	}
+
+	void testEraseStart()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(100, 0));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 0, 0, 10));
+
+		vector<vector<Point>> strokes = getStrokes(e);
+		CPPUNIT_ASSERT_EQUAL(1, (int) strokes.size());
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes[0].size());
+		assertPoint(10, 0, strokes[0][0]);
+		assertPoint(100, 0, strokes[0][1]);
+	}
+
+	void testEraseEnd()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(50, 0));
+		this->stroke->addPoint(Point(100, 0));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 100, 0, 10));
+
+		vector<vector<Point>> strokes = getStrokes(e);
+		CPPUNIT_ASSERT_EQUAL(1, (int) strokes.size());
+		CPPUNIT_ASSERT_EQUAL(3, (int) strokes[0].size());
+		assertPoint(0, 0, strokes[0][0]);
+		assertPoint(50, 0, strokes[0][1]);
+		assertPoint(90, 0, strokes[0][2]);
+	}
+
+	void testRepeatedErase()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(100, 0));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 50, 0, 10));
+
+		// The same area again does not change anything
+		CPPUNIT_ASSERT(!erase(e, 50, 0, 10));
+		CPPUNIT_ASSERT(!erase(e, 50, 0, 5));
+
+		// Splits the first piece again, and shortens the second
+		CPPUNIT_ASSERT(erase(e, 30, 0, 5));
+		CPPUNIT_ASSERT(erase(e, 60, 0, 5));
+
+		vector<vector<Point>> strokes = getStrokes(e);
+		CPPUNIT_ASSERT_EQUAL(3, (int) strokes.size());
+		assertPoint(0, 0, strokes[0][0]);
+		assertPoint(25, 0, strokes[0][1]);
+		assertPoint(35, 0, strokes[1][0]);
+		assertPoint(40, 0, strokes[1][1]);
+		assertPoint(65, 0, strokes[2][0]);
+		assertPoint(100, 0, strokes[2][1]);
+	}
+
+	void testJoinSegments()
+	{
+		this->stroke->addPoint(Point(0, 0));
+		this->stroke->addPoint(Point(50, 0));
+		this->stroke->addPoint(Point(100, 0));
+		this->stroke->addPoint(Point(100, 50));
+		EraseableStroke e(this->stroke);
+
+		CPPUNIT_ASSERT(erase(e, 25, 0, 5));
+
+		// The pieces after the hole continue over the original points
+		vector<vector<Point>> strokes = getStrokes(e);
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes.size());
+
+		CPPUNIT_ASSERT_EQUAL(2, (int) strokes[0].size());
+		assertPoint(0, 0, strokes[0][0]);
+		assertPoint(20, 0, strokes[0][1]);
+
+		CPPUNIT_ASSERT_EQUAL(4, (int) strokes[1].size());
+		assertPoint(30, 0, strokes[1][0]);
+		assertPoint(50, 0, strokes[1][1]);
+		assertPoint(100, 0, strokes[1][2]);
+		assertPoint(100, 50, strokes[1][3]);
+	}
+
+private:
+	Stroke* stroke = NULL;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(EraseableStrokeTest);
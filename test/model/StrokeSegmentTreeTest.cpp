@@ -0,0 +1,267 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "model/Stroke.h"
+#include <config-test.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <glib.h>
+
+#include <cmath>
+
+class StrokeSegmentTreeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(StrokeSegmentTreeTest);
+
+	CPPUNIT_TEST(testOnePoint);
+	CPPUNIT_TEST(testTwoPoints);
+	CPPUNIT_TEST(testLongStroke);
+	CPPUNIT_TEST(testAddPoint);
+	CPPUNIT_TEST(testMove);
+	CPPUNIT_TEST(testScale);
+	CPPUNIT_TEST(testRotate);
+	CPPUNIT_TEST(testTransform);
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp()
+	{
+		this->rand = g_rand_new_with_seed(42);
+	}
+
+	void tearDown()
+	{
+		g_rand_free(this->rand);
+		this->rand = NULL;
+	}
+
+	/**
+	 * A random walk, so the segments are short compared to the stroke like a real stroke
+	 */
+	void addRandomPoints(Stroke& s, int count)
+	{
+		double x = 200;
+		double y = 200;
+		if (s.getPointCount() > 0)
+		{
+			Point last = s.getPoint(s.getPointCount() - 1);
+			x = last.x;
+			y = last.y;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			x += g_rand_double_range(this->rand, -5, 5);
+			y += g_rand_double_range(this->rand, -5, 5);
+			s.addPoint(Point(x, y));
+		}
+	}
+
+	static double segmentDistance(const Point& a, const Point& b, double x, double y)
+	{
+		double dx = b.x - a.x;
+		double dy = b.y - a.y;
+		double len2 = dx * dx + dy * dy;
+
+		double t = 0;
+		if (len2 > 0)
+		{
+			t = std::max(0.0, std::min(1.0, ((x - a.x) * dx + (y - a.y) * dy) / len2));
+		}
+
+		return hypot(a.x + t * dx - x, a.y + t * dy - y);
+	}
+
+	static bool inSquare(const Point& p, double x, double y, double half)
+	{
+		return p.x >= x - half && p.y >= y - half && p.x <= x + half && p.y <= y + half;
+	}
+
+	/**
+	 * The same hit test as Stroke::intersects(), testing every segment
+	 */
+	static bool bruteForceIntersects(Stroke& s, double x, double y, double half, double* gap)
+	{
+		int count = s.getPointCount();
+		if (count == 1)
+		{
+			Point p = s.getPoint(0);
+			*gap = hypot(p.x - x, p.y - y);
+			return inSquare(p, x, y, half);
+		}
+
+		bool found = false;
+		for (int i = 0; i + 1 < count; i++)
+		{
+			Point a = s.getPoint(i);
+			Point b = s.getPoint(i + 1);
+			double distance = segmentDistance(a, b, x, y);
+			if (distance <= half || inSquare(a, x, y, half) || inSquare(b, x, y, half))
+			{
+				if (!found || distance < *gap)
+				{
+					*gap = distance;
+				}
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	/**
+	 * Compare the hits around the stroke, including points far away from it
+	 */
+	void assertSameHits(Stroke& s, int queries)
+	{
+		double x1 = s.getX();
+		double y1 = s.getY();
+		double x2 = x1 + s.getElementWidth();
+		double y2 = y1 + s.getElementHeight();
+
+		int hits = 0;
+		for (int i = 0; i < queries; i++)
+		{
+			double x = g_rand_double_range(this->rand, x1 - 20, x2 + 20);
+			double y = g_rand_double_range(this->rand, y1 - 20, y2 + 20);
+			double half = g_rand_double_range(this->rand, 0.5, 10);
+
+			double expectedGap = 0;
+			bool expected = bruteForceIntersects(s, x, y, half, &expectedGap);
+
+			double gap = -1;
+			CPPUNIT_ASSERT_EQUAL(expected, s.intersects(x, y, half, &gap));
+			CPPUNIT_ASSERT_EQUAL(expected, s.intersects(x, y, half));
+
+			if (expected)
+			{
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedGap, gap, 1e-9);
+				hits++;
+			}
+		}
+
+		// Else the test would not test anything
+		CPPUNIT_ASSERT(hits > 0);
+	}
+
+	void testOnePoint()
+	{
+		Stroke s;
+		s.setWidth(1);
+		s.addPoint(Point(100, 100));
+
+		double gap = -1;
+		CPPUNIT_ASSERT(s.intersects(103, 104, 5, &gap));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, gap, 1e-9);
+
+		CPPUNIT_ASSERT(!s.intersects(106, 100, 5, &gap));
+		CPPUNIT_ASSERT(!s.intersects(100, 94, 5));
+	}
+
+	void testTwoPoints()
+	{
+		Stroke s;
+		s.setWidth(1);
+		s.addPoint(Point(100, 100));
+		s.addPoint(Point(200, 100));
+
+		double gap = -1;
+		CPPUNIT_ASSERT(s.intersects(150, 103, 5, &gap));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, gap, 1e-9);
+		CPPUNIT_ASSERT(!s.intersects(150, 106, 5));
+		CPPUNIT_ASSERT(!s.intersects(206, 100, 5));
+
+		assertSameHits(s, 500);
+	}
+
+	void testLongStroke()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 2000);
+
+		assertSameHits(s, 2000);
+	}
+
+	void testAddPoint()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 100);
+
+		// Builds the tree
+		assertSameHits(s, 200);
+
+		addRandomPoints(s, 100);
+		assertSameHits(s, 200);
+
+		// Adding a point far away must be found
+		Point last = s.getPoint(s.getPointCount() - 1);
+		s.addPoint(Point(last.x + 500, last.y + 500));
+		double gap = -1;
+		CPPUNIT_ASSERT(s.intersects(last.x + 500, last.y + 500, 1, &gap));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, gap, 1e-9);
+	}
+
+	void testMove()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 500);
+		assertSameHits(s, 200);
+
+		s.move(300, -50);
+		assertSameHits(s, 500);
+	}
+
+	void testScale()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 500);
+		assertSameHits(s, 200);
+
+		s.scale(200, 200, 2.5, 0.5);
+		assertSameHits(s, 500);
+	}
+
+	void testRotate()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 500);
+		assertSameHits(s, 200);
+
+		s.rotate(200, 200, 0, 0, M_PI / 3);
+		assertSameHits(s, 500);
+	}
+
+	void testTransform()
+	{
+		Stroke s;
+		s.setWidth(1);
+		addRandomPoints(s, 500);
+		assertSameHits(s, 200);
+
+		cairo_matrix_t matrix;
+		cairo_matrix_init_rotate(&matrix, 0.3);
+		cairo_matrix_translate(&matrix, 40, 10);
+		s.transform(matrix, 1);
+		assertSameHits(s, 500);
+	}
+
+private:
+	GRand* rand = NULL;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(StrokeSegmentTreeTest);
@@ -0,0 +1,193 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <config-test.h>
+#include "ThumbnailBatch.h"
+#include "ThumbnailGenerator.h"
+
+#include <glib/gstdio.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+using namespace std;
+
+class ThumbnailBatchTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(ThumbnailBatchTest);
+
+	CPPUNIT_TEST(testGenerateXoj);
+	CPPUNIT_TEST(testGenerateXopp);
+	CPPUNIT_TEST(testGenerateNoPreviewWithoutRender);
+	CPPUNIT_TEST(testGenerateWriteFailed);
+	CPPUNIT_TEST(testBatch);
+	CPPUNIT_TEST(testBatchReusesCache);
+	CPPUNIT_TEST(testBatchFailures);
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp()
+	{
+		gchar* dir = g_dir_make_tmp("xournalpp-thumbnail-test-XXXXXX", NULL);
+		tmpDir = dir;
+		g_free(dir);
+	}
+
+	void tearDown()
+	{
+		for (string& file : listFiles())
+		{
+			g_unlink(file.c_str());
+		}
+		g_rmdir(tmpDir.c_str());
+	}
+
+private:
+	string tmpDir;
+
+	vector<string> listFiles()
+	{
+		vector<string> files;
+		GDir* dir = g_dir_open(tmpDir.c_str(), 0, NULL);
+		if (dir == NULL)
+		{
+			return files;
+		}
+
+		const gchar* name;
+		while ((name = g_dir_read_name(dir)) != NULL)
+		{
+			files.push_back(tmpDir + G_DIR_SEPARATOR_S + name);
+		}
+		g_dir_close(dir);
+
+		return files;
+	}
+
+	string readFile(string file)
+	{
+		gchar* contents = NULL;
+		gsize length = 0;
+		if (!g_file_get_contents(file.c_str(), &contents, &length, NULL))
+		{
+			return "";
+		}
+
+		string result(contents, length);
+		g_free(contents);
+		return result;
+	}
+
+public:
+	void testGenerateXoj()
+	{
+		string output = tmpDir + G_DIR_SEPARATOR_S "preview.png";
+
+		ThumbnailGenerator generator;
+		CPPUNIT_ASSERT_EQUAL(THUMBNAIL_RESULT_OK, generator.generate(GET_TESTFILE("preview-test.xoj"), output));
+		CPPUNIT_ASSERT_EQUAL(PREVIEW_RESULT_IMAGE_READ, generator.getExtractResult());
+		CPPUNIT_ASSERT_EQUAL(string("CppUnitTestString"), readFile(output));
+
+		// No temporary file is left
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, listFiles().size());
+	}
+
+	void testGenerateXopp()
+	{
+		string output = tmpDir + G_DIR_SEPARATOR_S "preview.png";
+
+		ThumbnailGenerator generator;
+		CPPUNIT_ASSERT_EQUAL(THUMBNAIL_RESULT_OK, generator.generate(GET_TESTFILE("packaged_xopp/testPreview.xopp"), output));
+		CPPUNIT_ASSERT_EQUAL(string("CppUnitTestString \n"), readFile(output));
+	}
+
+	void testGenerateNoPreviewWithoutRender()
+	{
+		string output = tmpDir + G_DIR_SEPARATOR_S "preview.png";
+
+		ThumbnailGenerator generator;
+		generator.setRenderMissingPreview(false);
+		CPPUNIT_ASSERT_EQUAL(THUMBNAIL_RESULT_EXTRACT_FAILED,
+		                     generator.generate(GET_TESTFILE("packaged_xopp/testNoPreview.xopp"), output));
+		CPPUNIT_ASSERT_EQUAL(PREVIEW_RESULT_NO_PREVIEW, generator.getExtractResult());
+		CPPUNIT_ASSERT(listFiles().empty());
+	}
+
+	void testGenerateWriteFailed()
+	{
+		string output = tmpDir + G_DIR_SEPARATOR_S "missing" G_DIR_SEPARATOR_S "preview.png";
+
+		ThumbnailGenerator generator;
+		CPPUNIT_ASSERT_EQUAL(THUMBNAIL_RESULT_WRITE_FAILED, generator.generate(GET_TESTFILE("preview-test.xoj"), output));
+	}
+
+	void testBatch()
+	{
+		ThumbnailBatch batch(tmpDir, 2, false);
+		batch.add(GET_TESTFILE("preview-test.xoj"));
+		batch.add(GET_TESTFILE("preview-test2.xoj"));
+		batch.add(GET_TESTFILE("packaged_xopp/testPreview.xopp"));
+		CPPUNIT_ASSERT_EQUAL(0, batch.finish());
+
+		// One cache entry per file, named by the hash of path, mtime and size
+		vector<string> files = listFiles();
+		CPPUNIT_ASSERT_EQUAL((size_t) 3, files.size());
+
+		bool found = false;
+		for (string& file : files)
+		{
+			CPPUNIT_ASSERT(g_str_has_suffix(file.c_str(), ".png"));
+			found |= readFile(file) == "CppUnitTestString";
+		}
+		CPPUNIT_ASSERT(found);
+	}
+
+	void testBatchReusesCache()
+	{
+		{
+			ThumbnailBatch batch(tmpDir, 1, false);
+			batch.add(GET_TESTFILE("preview-test.xoj"));
+			CPPUNIT_ASSERT_EQUAL(0, batch.finish());
+		}
+
+		vector<string> files = listFiles();
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, files.size());
+
+		// An existing entry is used without opening the document again
+		CPPUNIT_ASSERT(g_file_set_contents(files[0].c_str(), "cached", -1, NULL));
+
+		{
+			ThumbnailBatch batch(tmpDir, 1, false);
+			batch.add(GET_TESTFILE("preview-test.xoj"));
+			CPPUNIT_ASSERT_EQUAL(0, batch.finish());
+		}
+
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, listFiles().size());
+		CPPUNIT_ASSERT_EQUAL(string("cached"), readFile(files[0]));
+	}
+
+	void testBatchFailures()
+	{
+		ThumbnailBatch batch(tmpDir, 2, false);
+		batch.add(GET_TESTFILE("THIS FILE DOES NOT EXIST.xoj"));
+		batch.add(GET_TESTFILE("preview-test-invalid.xoj"));
+		batch.add(GET_TESTFILE("packaged_xopp/testNoPreview.xopp"));
+		batch.add(GET_TESTFILE("preview-test.xoj"));
+		CPPUNIT_ASSERT_EQUAL(3, batch.finish());
+
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, listFiles().size());
+	}
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(ThumbnailBatchTest);
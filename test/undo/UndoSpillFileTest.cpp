@@ -0,0 +1,191 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "model/Stroke.h"
+#include "undo/UndoAction.h"
+#include "undo/UndoSpillFile.h"
+#include <config-test.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <glib/gstdio.h>
+
+#include <fstream>
+
+class TestUndoAction : public UndoAction
+{
+public:
+	TestUndoAction() : UndoAction("TestUndoAction") { }
+
+public:
+	virtual bool undo(Control* control) { return true; }
+	virtual bool redo(Control* control) { return true; }
+	virtual string getText() { return "Test"; }
+};
+
+class UndoSpillFileTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(UndoSpillFileTest);
+
+	CPPUNIT_TEST(testRoundTrip);
+	CPPUNIT_TEST(testRestoreNotSpilled);
+	CPPUNIT_TEST(testRestoreCorrupted);
+	CPPUNIT_TEST(testRestoreTruncated);
+	CPPUNIT_TEST(testReuseRemoved);
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp()
+	{
+	}
+
+	void tearDown()
+	{
+		for (Stroke* s : this->strokes)
+		{
+			delete s;
+		}
+		this->strokes.clear();
+	}
+
+	Stroke* createStroke(int points, double offset)
+	{
+		Stroke* s = new Stroke();
+		s->setWidth(1.5);
+		for (int i = 0; i < points; i++)
+		{
+			s->addPoint(Point(offset + i, offset + 2 * i, 0.5 + i));
+		}
+		this->strokes.push_back(s);
+		return s;
+	}
+
+	void assertStroke(Stroke* s, int points, double offset)
+	{
+		CPPUNIT_ASSERT_EQUAL(points, s->getPointCount());
+		CPPUNIT_ASSERT_EQUAL(1.5, s->getWidth());
+		for (int i = 0; i < points; i++)
+		{
+			Point p = s->getPoint(i);
+			CPPUNIT_ASSERT_EQUAL(offset + i, p.x);
+			CPPUNIT_ASSERT_EQUAL(offset + 2 * i, p.y);
+			CPPUNIT_ASSERT_EQUAL(0.5 + i, p.z);
+		}
+	}
+
+	goffset getFileSize(UndoSpillFile& file)
+	{
+		GStatBuf st;
+		CPPUNIT_ASSERT_EQUAL(0, g_stat(file.getFile().c_str(), &st));
+		return st.st_size;
+	}
+
+	void testRoundTrip()
+	{
+		UndoSpillFile file;
+		TestUndoAction action;
+
+		vector<Stroke*> spilled = { createStroke(100, 0), createStroke(3, 1000) };
+		CPPUNIT_ASSERT(file.spill(&action, spilled));
+
+		CPPUNIT_ASSERT(file.isSpilled(&action));
+		CPPUNIT_ASSERT_EQUAL(0, spilled[0]->getPointCount());
+		CPPUNIT_ASSERT_EQUAL(0, spilled[1]->getPointCount());
+
+		CPPUNIT_ASSERT(file.restore(&action));
+
+		CPPUNIT_ASSERT(!file.isSpilled(&action));
+		assertStroke(spilled[0], 100, 0);
+		assertStroke(spilled[1], 3, 1000);
+	}
+
+	void testRestoreNotSpilled()
+	{
+		UndoSpillFile file;
+		TestUndoAction action;
+
+		CPPUNIT_ASSERT(file.restore(&action));
+		CPPUNIT_ASSERT(!file.isSpilled(&action));
+	}
+
+	void testRestoreCorrupted()
+	{
+		UndoSpillFile file;
+		TestUndoAction action;
+
+		vector<Stroke*> spilled = { createStroke(100, 0) };
+		CPPUNIT_ASSERT(file.spill(&action, spilled));
+
+		// Same size, but no serialized stroke
+		goffset size = getFileSize(file);
+		{
+			std::ofstream out(file.getFile().c_str(), std::ofstream::binary | std::ofstream::in);
+			out << string(size, 'x');
+		}
+
+		CPPUNIT_ASSERT(!file.restore(&action));
+
+		// Kept spilled, and no partially read points
+		CPPUNIT_ASSERT(file.isSpilled(&action));
+		CPPUNIT_ASSERT_EQUAL(0, spilled[0]->getPointCount());
+	}
+
+	void testRestoreTruncated()
+	{
+		UndoSpillFile file;
+		TestUndoAction action;
+
+		vector<Stroke*> spilled = { createStroke(100, 0) };
+		CPPUNIT_ASSERT(file.spill(&action, spilled));
+
+		CPPUNIT_ASSERT_EQUAL(0, g_truncate(file.getFile().c_str(), 10));
+
+		CPPUNIT_ASSERT(!file.restore(&action));
+		CPPUNIT_ASSERT(file.isSpilled(&action));
+		CPPUNIT_ASSERT_EQUAL(0, spilled[0]->getPointCount());
+	}
+
+	void testReuseRemoved()
+	{
+		UndoSpillFile file;
+		TestUndoAction action1;
+		TestUndoAction action2;
+		TestUndoAction action3;
+
+		vector<Stroke*> spilled1 = { createStroke(100, 0) };
+		vector<Stroke*> spilled2 = { createStroke(100, 1000) };
+		vector<Stroke*> spilled3 = { createStroke(100, 2000) };
+
+		CPPUNIT_ASSERT(file.spill(&action1, spilled1));
+		CPPUNIT_ASSERT(file.spill(&action2, spilled2));
+		goffset size = getFileSize(file);
+
+		// The range of action1 is reused
+		file.remove(&action1);
+		CPPUNIT_ASSERT(file.spill(&action3, spilled3));
+		CPPUNIT_ASSERT_EQUAL(size, getFileSize(file));
+
+		CPPUNIT_ASSERT(file.restore(&action2));
+		assertStroke(spilled2[0], 100, 1000);
+		CPPUNIT_ASSERT(file.restore(&action3));
+		assertStroke(spilled3[0], 100, 2000);
+
+		// Truncated after the last entry is gone
+		CPPUNIT_ASSERT_EQUAL((goffset) 0, getFileSize(file));
+	}
+
+private:
+	vector<Stroke*> strokes;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(UndoSpillFileTest);
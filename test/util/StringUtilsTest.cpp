@@ -28,6 +28,7 @@ class StringUtilsTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(testSplitOne);
 	CPPUNIT_TEST(testEndsWith);
 	CPPUNIT_TEST(testCompare);
+	CPPUNIT_TEST(testEscapeJson);
 
 	CPPUNIT_TEST_SUITE_END();
 
@@ -90,6 +91,14 @@ public:
 		CPPUNIT_ASSERT_EQUAL(true, StringUtils::iequals("ööaa", "Ööaa"));
 		CPPUNIT_ASSERT_EQUAL(false, StringUtils::iequals("ööaa", "ööaaa"));
 	}
+
+	void testEscapeJson()
+	{
+		CPPUNIT_ASSERT_EQUAL(std::string(""), StringUtils::escapeJson(""));
+		CPPUNIT_ASSERT_EQUAL(std::string("/tmp/äö.str"), StringUtils::escapeJson("/tmp/äö.str"));
+		CPPUNIT_ASSERT_EQUAL(std::string("C:\\\\a \\\"b\\\""), StringUtils::escapeJson("C:\\a \"b\""));
+		CPPUNIT_ASSERT_EQUAL(std::string("a\\nb\\tc\\u0001"), StringUtils::escapeJson("a\nb\tc\x01"));
+	}
 };
 
 // Registers the fixture into the 'registry'
@@ -27,6 +27,9 @@ class XojPreviewExtractorTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(testLoadGzipped);
 	CPPUNIT_TEST(testLoadGzipped2);
 	CPPUNIT_TEST(testLoad1Unzipped);
+	CPPUNIT_TEST(testLoad1Zipped);
+	CPPUNIT_TEST(testLoad2Zipped);
+	CPPUNIT_TEST(testNoPreviewZipped);
 	CPPUNIT_TEST(testNoPreview);
 	CPPUNIT_TEST(testInvalidFile);
 
@@ -102,7 +105,7 @@ public:
 
 		gsize dataLen = 0;
 		unsigned char* imageData = extractor.getData(dataLen);
-		CPPUNIT_ASSERT_EQUAL(string("CppUnitTestString"), string((char*)imageData, (size_t)dataLen));
+		CPPUNIT_ASSERT_EQUAL(string("CppUnitTestString \n"), string((char*)imageData, (size_t)dataLen));
 	}
 
 	void testLoad2Zipped()
@@ -114,7 +117,19 @@ public:
 
 		gsize dataLen = 0;
 		extractor.getData(dataLen);
-		CPPUNIT_ASSERT_EQUAL((std::string::size_type) 2856, dataLen);
+		CPPUNIT_ASSERT_EQUAL((std::string::size_type) 804, dataLen);
+	}
+
+	void testNoPreviewZipped()
+	{
+		XojPreviewExtractor extractor;
+		PreviewExtractResult result = extractor.readFile(GET_TESTFILE("packaged_xopp/testNoPreview.xopp"));
+
+		CPPUNIT_ASSERT_EQUAL(PREVIEW_RESULT_NO_PREVIEW, result);
+
+		gsize dataLen = 0;
+		CPPUNIT_ASSERT(extractor.getData(dataLen) == NULL);
+		CPPUNIT_ASSERT_EQUAL((gsize) 0, dataLen);
 	}
 
 	void testNoPreview()